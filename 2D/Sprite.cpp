@@ -1,6 +1,14 @@
 #include "Sprite.h"
 #include "MatrixMath.h"
 #include "SpriteManager.h"
+#include "WinApp.h"
+
+namespace {
+// スプライトはカメラ無し（view = 単位行列）＋画面サイズ固定の正射影なので、VP はコンパイル時に確定する
+constexpr Matrix4x4 kSpriteViewProjection = MatrixMath::Multiply(
+    MatrixMath::MakeIdentity4x4(),
+    MatrixMath::MakeOrthographicMatrix(0.0f, 0.0f, float(WinApp::kClientWidth), float(WinApp::kClientHeight), 0.0f, 100.0f));
+}
 
 #pragma region 初期化処理
 // ================================
@@ -105,14 +113,13 @@ void Sprite::Update()
     // -------------------------------
     // 行列を作成（座標変換）
     // -------------------------------
-    Matrix4x4 worldMatrix = MatrixMath::MakeAffineMatrix(transform.scale, transform.rotate, transform.translate);
-    Matrix4x4 viewMatrix = MatrixMath::MakeIdentity4x4(); // カメラ無し
-    Matrix4x4 orthoSprite = MatrixMath::MakeOrthographicMatrix( 0.0f, 0.0f,float(WinApp::kClientWidth),float(WinApp::kClientHeight),0.0f, 100.0f); // スプライト用
+    // 描画にしか使わないので sin/cos は近似で良い
+    Matrix4x4 worldMatrix = MatrixMath::MakeAffineMatrix(transform.scale, transform.rotate, transform.translate, SinCosMode::Fast);
 
     // -------------------------------
     // GPUへ行列を転送
     // -------------------------------
-    transformationMatrixData->WVP = MatrixMath::Multiply(worldMatrix, MatrixMath::Multiply(viewMatrix, orthoSprite));
+    transformationMatrixData->WVP = MatrixMath::Multiply(worldMatrix, kSpriteViewProjection);
 
 }
 #pragma endregion
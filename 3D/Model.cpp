@@ -56,6 +56,11 @@ void Model::Initialize(ModelCommon* modelCommon, const std::string& directorypat
 // モデル描画処理
 // ===============================================
 void Model::Draw()
+{
+    DrawInstanced(1);
+}
+
+void Model::DrawInstanced(uint32_t instanceCount)
 {
     ID3D12GraphicsCommandList* commandList = modelCommon_->GetDxCommon()->GetCommandList();
 
@@ -80,5 +85,5 @@ void Model::Draw()
     // ===============================
     // 描画コマンド
     // ===============================
-    commandList->DrawInstanced(UINT(modelData_.vertices.size()), 1, 0, 0);
+    commandList->DrawInstanced(UINT(modelData_.vertices.size()), instanceCount, 0, 0);
 }
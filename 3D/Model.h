@@ -16,6 +16,8 @@ public:
     // ===============================
     void Initialize(ModelCommon* modelCommon, const std::string& directorypath, const std::string& filename); // 初期化（共通設定の受け取り）
     void Draw(); // 描画
+    // 同じモデルを instanceCount 個描く（ルートシグネチャ・インスタンスデータは呼び出し側で設定済み）
+    void DrawInstanced(uint32_t instanceCount);
 
     // ===============================
     // 構造体定義
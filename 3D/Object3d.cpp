@@ -1,5 +1,6 @@
 #include "Object3d.h"
 #include "MatrixMath.h"
+#include "AffineMatrix.h"
 #include "Model.h"
 #include "ModelManager.h"
 #include "Object3dManager.h"
@@ -55,9 +56,12 @@ void Object3d::Update()
     // ================================
 
     //  モデル自身のワールド行列（スケール・回転・移動）
-    Matrix4x4 worldMatrix = MatrixMath::Multiply(
-        model_->GetModelData().rootNode.localMatrix,
-        MatrixMath::MakeAffineMatrix(transform.scale, transform.rotate, transform.translate));
+    //  ノード行列もアフィンなので 3x4 のまま合成する
+    orientation_.Sync(transform.rotate);
+    const AffineMatrix worldAffine = AffineMath::Multiply(
+        AffineMath::FromMatrix4x4(model_->GetModelData().rootNode.localMatrix),
+        AffineMath::MakeAffineFromBasis(transform.scale, orientation_.axis, transform.translate));
+    Matrix4x4 worldMatrix = AffineMath::ToMatrix4x4(worldAffine);
 
     Matrix4x4 worldViewProjectionMatrix;
 
@@ -76,8 +80,8 @@ void Object3d::Update()
     // ワールド行列も送る（ライティングなどで使用）
     transformationMatrixData->World = worldMatrix;
 
-    Matrix4x4 inv = MatrixMath::Inverse(worldViewProjectionMatrix);
-    transformationMatrixData->WorldInverseTranspose = MatrixMath::Transpose(inv);
+    // 法線用：World の 3x3 逆転置（4x4 逆行列は不要）
+    transformationMatrixData->WorldInverseTranspose = AffineMath::NormalMatrix(worldAffine);
 }
 
 #pragma endregion
@@ -11,6 +11,7 @@
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
 #include "Object3DStruct.h"
+#include "Quaternion.h"
 class Object3dManager;
 class Model;
 class Object3d {
@@ -82,6 +83,8 @@ private:
     // Transform
     Transform transform;
     Transform cameraTransform;
+    // transform.rotate の軸キャッシュ（回転が変わらないフレームは sin/cos を省く）
+    CachedOrientation orientation_;
 
     // カメラ
     Camera* camera_ = nullptr;
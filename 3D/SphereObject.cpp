@@ -70,10 +70,12 @@ void SphereObject::Update(Camera* camera)
 {
     camera_ = camera;
 
+    // 描画にしか使わないので sin/cos は近似で良い
     Matrix4x4 world = MatrixMath::MakeAffineMatrix(
         transform_.scale,
         transform_.rotate,
-        transform_.translate);
+        transform_.translate,
+        SinCosMode::Fast);
 
     Matrix4x4 vp = camera->GetViewProjectionMatrix();
 
@@ -0,0 +1,214 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "SimdConfig.h"
+
+// ===============================
+// ベンチマーク共通（計測・結果の JSON 出力）
+// ===============================
+namespace bench {
+
+#if defined(__GNUC__) || defined(__clang__)
+// 値を「使った」ことにして、計算ごと消されるのを防ぐ
+template <class T>
+inline void DoNotOptimize(const T& value)
+{
+    asm volatile("" : : "g"(&value) : "memory");
+}
+#else
+inline void UseCharPointer(const volatile char*) { }
+template <class T>
+inline void DoNotOptimize(const T& value)
+{
+    UseCharPointer(&reinterpret_cast<const volatile char&>(value));
+    _ReadWriteBarrier();
+}
+#endif
+
+struct Options {
+    bool quick = false; // 計測時間を短くする（CI・動作確認用）
+    std::string jsonPath; // "-" なら標準出力
+    std::string filter; // 名前にこの文字列を含むものだけ実行
+};
+
+inline Options ParseOptions(int argc, char** argv)
+{
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--quick") {
+            options.quick = true;
+        } else if (arg == "--json" && i + 1 < argc) {
+            options.jsonPath = argv[++i];
+        } else if (arg == "--filter" && i + 1 < argc) {
+            options.filter = argv[++i];
+        } else {
+            std::fprintf(stderr, "usage: %s [--quick] [--json <path|->] [--filter <name>]\n", argv[0]);
+            std::exit(2);
+        }
+    }
+    return options;
+}
+
+struct Result {
+    std::string name;
+    double nsPerOp = 0.0;
+    uint64_t ops = 0; // 計測に使った総回数
+    // 精度（double 参照との差。測っていない項目は負の値）
+    double maxAbsError = -1.0;
+    double maxRelError = -1.0;
+    uint64_t mismatches = 0; // 判定系（当たった/外れた 等）の不一致数
+    double allocsPerFrame = -1.0; // 1 フレームあたりのヒープ確保回数（測っていなければ負の値）
+    std::string note;
+};
+
+// fn() 1 回で opsPerCall 回分の処理をする関数を計測し、ns/op の最小値を返す
+template <class Fn>
+inline double MeasureNsPerOp(Fn&& fn, size_t opsPerCall, const Options& options, uint64_t* outOps = nullptr)
+{
+    using Clock = std::chrono::steady_clock;
+    const double targetSec = options.quick ? 0.002 : 0.05;
+    const int repeats = options.quick ? 3 : 7;
+
+    // 1 回の計測が targetSec を超えるまで呼び出し回数を増やす
+    size_t calls = 1;
+    for (;;) {
+        const auto t0 = Clock::now();
+        for (size_t i = 0; i < calls; ++i) {
+            fn();
+        }
+        const double sec = std::chrono::duration<double>(Clock::now() - t0).count();
+        if (sec >= targetSec || calls >= (size_t(1) << 30)) {
+            break;
+        }
+        calls *= 2;
+    }
+
+    double best = 1e300;
+    uint64_t total = 0;
+    for (int r = 0; r < repeats; ++r) {
+        const auto t0 = Clock::now();
+        for (size_t i = 0; i < calls; ++i) {
+            fn();
+        }
+        const double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+        best = (std::min)(best, ns / double(calls * opsPerCall));
+        total += calls * opsPerCall;
+    }
+    if (outOps) {
+        *outOps = total;
+    }
+    return best;
+}
+
+inline const char* SimdName()
+{
+#if defined(MATH_USE_AVX)
+    return "avx";
+#elif defined(MATH_USE_SSE)
+    return "sse";
+#else
+    return "scalar";
+#endif
+}
+
+class Report {
+public:
+    explicit Report(std::string suite) : suite_(std::move(suite)) { }
+
+    void Add(const Result& result)
+    {
+        results_.push_back(result);
+        std::printf("%-40s %10.2f ns/op", result.name.c_str(), result.nsPerOp);
+        if (result.maxAbsError >= 0.0) {
+            std::printf("  abs %.3g", result.maxAbsError);
+        }
+        if (result.maxRelError >= 0.0) {
+            std::printf("  rel %.3g", result.maxRelError);
+        }
+        if (result.mismatches > 0) {
+            std::printf("  mismatch %llu", static_cast<unsigned long long>(result.mismatches));
+        }
+        if (result.allocsPerFrame >= 0.0) {
+            std::printf("  allocs/frame %.2f", result.allocsPerFrame);
+        }
+        if (!result.note.empty()) {
+            std::printf("  (%s)", result.note.c_str());
+        }
+        std::printf("\n");
+    }
+
+    nlohmann::json ToJson() const
+    {
+        nlohmann::json root;
+        root["suite"] = suite_;
+        root["schema"] = 1;
+        root["simd"] = SimdName();
+#if defined(__clang__)
+        root["compiler"] = std::string("clang ") + __clang_version__;
+#elif defined(__GNUC__)
+        root["compiler"] = std::string("gcc ") + __VERSION__;
+#elif defined(_MSC_VER)
+        root["compiler"] = "msvc " + std::to_string(_MSC_VER);
+#endif
+        nlohmann::json list = nlohmann::json::array();
+        for (const Result& r : results_) {
+            nlohmann::json j;
+            j["name"] = r.name;
+            j["ns_per_op"] = r.nsPerOp;
+            j["ops"] = r.ops;
+            if (r.maxAbsError >= 0.0) {
+                j["max_abs_error"] = r.maxAbsError;
+            }
+            if (r.maxRelError >= 0.0) {
+                j["max_rel_error"] = r.maxRelError;
+            }
+            j["mismatches"] = r.mismatches;
+            if (r.allocsPerFrame >= 0.0) {
+                j["allocs_per_frame"] = r.allocsPerFrame;
+            }
+            if (!r.note.empty()) {
+                j["note"] = r.note;
+            }
+            list.push_back(j);
+        }
+        root["results"] = list;
+        return root;
+    }
+
+    // 出力に失敗したら false
+    bool WriteJson(const std::string& path) const
+    {
+        if (path.empty()) {
+            return true;
+        }
+        const std::string text = ToJson().dump(2);
+        if (path == "-") {
+            std::printf("%s\n", text.c_str());
+            return true;
+        }
+        std::ofstream ofs(path);
+        if (!ofs) {
+            std::fprintf(stderr, "failed to open %s\n", path.c_str());
+            return false;
+        }
+        ofs << text << "\n";
+        return true;
+    }
+
+private:
+    std::string suite_;
+    std::vector<Result> results_;
+};
+
+} // namespace bench
@@ -0,0 +1,1114 @@
+// 数学レイヤーのマイクロベンチマーク + double 参照との精度比較
+// D3D12 に依存しないので Linux でもビルドできる（Benchmark/CMakeLists.txt）
+#include "BenchCommon.h"
+
+#include "AffineMatrix.h"
+#include "CompiledWalls.h"
+#include "CurlNoiseField.h"
+#include "Gate.h"
+#include "MatrixMath.h"
+#include "ParticleCollision.h"
+#include "ParticleSort.h"
+#include "ProjectionMath.h"
+#include "Random.h"
+#include "SinCos.h"
+#include "WallBvh.h"
+#include "WallCollision.h"
+
+#include <array>
+#include <cmath>
+#include <random>
+
+namespace {
+
+constexpr size_t kCount = 1024; // 1 回の呼び出しで処理する入力数
+
+#pragma region double 参照
+struct Mat4d {
+    double m[4][4] {};
+};
+
+Mat4d ToDouble(const Matrix4x4& a)
+{
+    Mat4d r;
+    for (int i = 0; i < 4; ++i)
+        for (int j = 0; j < 4; ++j)
+            r.m[i][j] = a.m[i][j];
+    return r;
+}
+
+Mat4d MulD(const Mat4d& a, const Mat4d& b)
+{
+    Mat4d r;
+    for (int i = 0; i < 4; ++i)
+        for (int j = 0; j < 4; ++j)
+            for (int k = 0; k < 4; ++k)
+                r.m[i][j] += a.m[i][k] * b.m[k][j];
+    return r;
+}
+
+// 部分ピボット付き Gauss-Jordan
+Mat4d InverseD(const Mat4d& a)
+{
+    double w[4][8] {};
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j)
+            w[i][j] = a.m[i][j];
+        w[i][4 + i] = 1.0;
+    }
+    for (int c = 0; c < 4; ++c) {
+        int pivot = c;
+        for (int r = c + 1; r < 4; ++r)
+            if (std::abs(w[r][c]) > std::abs(w[pivot][c]))
+                pivot = r;
+        for (int j = 0; j < 8; ++j)
+            std::swap(w[c][j], w[pivot][j]);
+        const double inv = 1.0 / w[c][c];
+        for (int j = 0; j < 8; ++j)
+            w[c][j] *= inv;
+        for (int r = 0; r < 4; ++r) {
+            if (r == c)
+                continue;
+            const double f = w[r][c];
+            for (int j = 0; j < 8; ++j)
+                w[r][j] -= f * w[c][j];
+        }
+    }
+    Mat4d r;
+    for (int i = 0; i < 4; ++i)
+        for (int j = 0; j < 4; ++j)
+            r.m[i][j] = w[i][4 + j];
+    return r;
+}
+
+// MatrixMath と同じ符号規約の回転（Rx は標準、Ry/Rz は逆回り）
+Mat4d RotateXYZD(double rx, double ry, double rz)
+{
+    Mat4d x, y, z;
+    x.m[0][0] = 1; x.m[1][1] = std::cos(rx); x.m[1][2] = std::sin(rx); x.m[2][1] = -std::sin(rx); x.m[2][2] = std::cos(rx); x.m[3][3] = 1;
+    y.m[0][0] = std::cos(ry); y.m[0][2] = std::sin(ry); y.m[1][1] = 1; y.m[2][0] = -std::sin(ry); y.m[2][2] = std::cos(ry); y.m[3][3] = 1;
+    z.m[0][0] = std::cos(rz); z.m[0][1] = -std::sin(rz); z.m[1][0] = std::sin(rz); z.m[1][1] = std::cos(rz); z.m[2][2] = 1; z.m[3][3] = 1;
+    return MulD(MulD(x, y), z);
+}
+
+Mat4d AffineD(const Vector3& s, const Vector3& r, const Vector3& t)
+{
+    Mat4d m = RotateXYZD(r.x, r.y, r.z);
+    const double sc[3] = { s.x, s.y, s.z };
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            m.m[i][j] *= sc[i];
+    m.m[3][0] = t.x;
+    m.m[3][1] = t.y;
+    m.m[3][2] = t.z;
+    return m;
+}
+
+Mat4d LookAtD(const Vector3& eye, const Vector3& target, const Vector3& up)
+{
+    auto norm = [](std::array<double, 3> v) {
+        const double l = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+        return std::array<double, 3> { v[0] / l, v[1] / l, v[2] / l };
+    };
+    auto cross = [](const std::array<double, 3>& a, const std::array<double, 3>& b) {
+        return std::array<double, 3> { a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] };
+    };
+    const std::array<double, 3> e { eye.x, eye.y, eye.z };
+    const auto z = norm({ target.x - e[0], target.y - e[1], target.z - e[2] });
+    const auto x = norm(cross({ up.x, up.y, up.z }, z));
+    const auto y = cross(z, x);
+    const std::array<double, 3>* axes[3] = { &x, &y, &z };
+
+    Mat4d m;
+    for (int c = 0; c < 3; ++c) {
+        const auto& a = *axes[c];
+        m.m[0][c] = a[0];
+        m.m[1][c] = a[1];
+        m.m[2][c] = a[2];
+        m.m[3][c] = -(a[0] * e[0] + a[1] * e[1] + a[2] * e[2]);
+    }
+    m.m[3][3] = 1;
+    return m;
+}
+
+Mat4d PerspectiveD(double fovY, double aspect, double n, double f)
+{
+    Mat4d m;
+    const double y = 1.0 / std::tan(fovY / 2.0);
+    m.m[0][0] = y / aspect;
+    m.m[1][1] = y;
+    m.m[2][2] = f / (f - n);
+    m.m[2][3] = 1.0;
+    m.m[3][2] = -(n * f) / (f - n);
+    return m;
+}
+
+// 行列の誤差（最大絶対誤差と、参照の最大要素で割った相対誤差）
+void AccumulateError(const Matrix4x4& got, const Mat4d& ref, double& maxAbs, double& maxRel)
+{
+    double diff = 0.0, scale = 0.0;
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            diff = (std::max)(diff, std::abs(got.m[i][j] - ref.m[i][j]));
+            scale = (std::max)(scale, std::abs(ref.m[i][j]));
+        }
+    }
+    maxAbs = (std::max)(maxAbs, diff);
+    maxRel = (std::max)(maxRel, scale > 0.0 ? diff / scale : diff);
+}
+
+// ResolveAABB_vs_OBB_MinPush と同じ 15 軸 SAT を double で行う（押し戻し量だけ返す）
+bool SatDepthD(const Vector3& aabbCenter, const Vector3& aabbHalf, const OBB& obb, double& outDepth)
+{
+    const Mat4d r = RotateXYZD(obb.rot.x, obb.rot.y, obb.rot.z);
+    std::array<double, 3> A[3], W[3] = { { { 1, 0, 0 } }, { { 0, 1, 0 } }, { { 0, 0, 1 } } };
+    for (int i = 0; i < 3; ++i)
+        A[i] = { r.m[i][0], r.m[i][1], r.m[i][2] };
+    auto dot = [](const std::array<double, 3>& a, const std::array<double, 3>& b) { return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]; };
+    const std::array<double, 3> d { double(aabbCenter.x) - obb.center.x, double(aabbCenter.y) - obb.center.y, double(aabbCenter.z) - obb.center.z };
+    const double ha[3] = { aabbHalf.x, aabbHalf.y, aabbHalf.z };
+    const double hb[3] = { obb.half.x, obb.half.y, obb.half.z };
+
+    std::vector<std::array<double, 3>> axes = { A[0], A[1], A[2], W[0], W[1], W[2] };
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            axes.push_back({ A[i][1] * W[j][2] - A[i][2] * W[j][1], A[i][2] * W[j][0] - A[i][0] * W[j][2], A[i][0] * W[j][1] - A[i][1] * W[j][0] });
+
+    double minOverlap = 1e300;
+    for (auto axis : axes) {
+        const double len = std::sqrt(dot(axis, axis));
+        if (len < 1e-6)
+            continue;
+        for (double& v : axis)
+            v /= len;
+        double ra = 0.0, rb = 0.0;
+        for (int i = 0; i < 3; ++i) {
+            ra += ha[i] * std::abs(dot(W[i], axis));
+            rb += hb[i] * std::abs(dot(A[i], axis));
+        }
+        const double overlap = (ra + rb) - std::abs(dot(d, axis));
+        if (overlap < 0.0)
+            return false;
+        minOverlap = (std::min)(minOverlap, overlap);
+    }
+    outDepth = minOverlap;
+    return true;
+}
+#pragma endregion
+
+#pragma region 入力データ
+struct Inputs {
+    std::vector<Matrix4x4> a, b; // 一般の行列（対角優位で条件数を抑える）
+    std::vector<Vector3> scale, rotate, translate;
+    std::vector<Vector3> eye, target;
+    std::vector<float> fov;
+    std::vector<float> angles;
+    std::vector<Vector3> points;
+    std::vector<OBB> obbs;
+    std::vector<Vector3> aabbCenter, aabbHalf;
+};
+
+Inputs MakeInputs()
+{
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
+    std::uniform_real_distribution<float> positive(0.2f, 3.0f);
+    std::uniform_real_distribution<float> world(-50.0f, 50.0f);
+
+    Inputs in;
+    for (size_t n = 0; n < kCount; ++n) {
+        Matrix4x4 a {}, b {};
+        for (int i = 0; i < 4; ++i) {
+            for (int j = 0; j < 4; ++j) {
+                a.m[i][j] = unit(rng) + (i == j ? 4.0f : 0.0f);
+                b.m[i][j] = unit(rng) * 10.0f;
+            }
+        }
+        in.a.push_back(a);
+        in.b.push_back(b);
+        in.scale.push_back({ positive(rng), positive(rng), positive(rng) });
+        in.rotate.push_back({ angle(rng), angle(rng), angle(rng) });
+        in.translate.push_back({ world(rng), world(rng), world(rng) });
+        in.eye.push_back({ world(rng), world(rng), world(rng) });
+        in.target.push_back({ world(rng), world(rng), world(rng) });
+        in.fov.push_back(0.3f + 0.002f * float(n % 512));
+        in.angles.push_back(angle(rng) * 2.0f);
+        in.points.push_back({ world(rng), world(rng), world(rng) });
+
+        // 半分くらいが当たるように中心を近づける
+        OBB obb;
+        obb.center = { unit(rng) * 2.0f, unit(rng) * 2.0f, unit(rng) * 2.0f };
+        obb.half = { positive(rng), positive(rng), positive(rng) };
+        obb.rot = { angle(rng), angle(rng), angle(rng) };
+        in.obbs.push_back(obb);
+        in.aabbCenter.push_back({ unit(rng) * 4.0f, unit(rng) * 4.0f, unit(rng) * 4.0f });
+        in.aabbHalf.push_back({ positive(rng) * 0.5f, positive(rng) * 0.5f, positive(rng) * 0.5f });
+    }
+    return in;
+}
+#pragma endregion
+
+bool Selected(const bench::Options& options, const char* name)
+{
+    return options.filter.empty() || std::string(name).find(options.filter) != std::string::npos;
+}
+
+#pragma region 行列
+void BenchMatrix(const Inputs& in, const bench::Options& options, bench::Report& report)
+{
+    std::vector<Matrix4x4> out(kCount);
+
+    if (Selected(options, "MatrixMath::Multiply")) {
+        bench::Result r;
+        r.name = "MatrixMath::Multiply";
+        r.nsPerOp = bench::MeasureNsPerOp([&] {
+            for (size_t i = 0; i < kCount; ++i)
+                out[i] = MatrixMath::Multiply(in.a[i], in.b[i]);
+            bench::DoNotOptimize(out);
+        }, kCount, options, &r.ops);
+        r.maxAbsError = r.maxRelError = 0.0;
+        for (size_t i = 0; i < kCount; ++i)
+            AccumulateError(MatrixMath::Multiply(in.a[i], in.b[i]), MulD(ToDouble(in.a[i]), ToDouble(in.b[i])), r.maxAbsError, r.maxRelError);
+        report.Add(r);
+    }
+
+    if (Selected(options, "MatrixMath::MultiplyBatch")) {
+        bench::Result r;
+        r.name = "MatrixMath::MultiplyBatch";
+        r.nsPerOp = bench::MeasureNsPerOp([&] {
+            MatrixMath::MultiplyBatch(in.a.data(), in.b[0], out.data(), kCount);
+            bench::DoNotOptimize(out);
+        }, kCount, options, &r.ops);
+        r.maxAbsError = r.maxRelError = 0.0;
+        MatrixMath::MultiplyBatch(in.a.data(), in.b[0], out.data(), kCount);
+        for (size_t i = 0; i < kCount; ++i)
+            AccumulateError(out[i], MulD(ToDouble(in.a[i]), ToDouble(in.b[0])), r.maxAbsError, r.maxRelError);
+        report.Add(r);
+    }
+
+    if (Selected(options, "MatrixMath::Inverse")) {
+        bench::Result r;
+        r.name = "MatrixMath::Inverse";
+        r.nsPerOp = bench::MeasureNsPerOp([&] {
+            for (size_t i = 0; i < kCount; ++i)
+                out[i] = MatrixMath::Inverse(in.a[i]);
+            bench::DoNotOptimize(out);
+        }, kCount, options, &r.ops);
+        r.maxAbsError = r.maxRelError = 0.0;
+        for (size_t i = 0; i < kCount; ++i)
+            AccumulateError(MatrixMath::Inverse(in.a[i]), InverseD(ToDouble(in.a[i])), r.maxAbsError, r.maxRelError);
+        report.Add(r);
+    }
+
+    const SinCosMode modes[2] = { SinCosMode::Exact, SinCosMode::Fast };
+    for (SinCosMode mode : modes) {
+        const std::string name = std::string("MatrixMath::MakeAffineMatrix/") + (mode == SinCosMode::Exact ? "exact" : "fast");
+        if (!Selected(options, name.c_str()))
+            continue;
+        bench::Result r;
+        r.name = name;
+        r.nsPerOp = bench::MeasureNsPerOp([&] {
+            for (size_t i = 0; i < kCount; ++i)
+                out[i] = MatrixMath::MakeAffineMatrix(in.scale[i], in.rotate[i], in.translate[i], mode);
+            bench::DoNotOptimize(out);
+        }, kCount, options, &r.ops);
+        r.maxAbsError = r.maxRelError = 0.0;
+        for (size_t i = 0; i < kCount; ++i)
+            AccumulateError(MatrixMath::MakeAffineMatrix(in.scale[i], in.rotate[i], in.translate[i], mode), AffineD(in.scale[i], in.rotate[i], in.translate[i]), r.maxAbsError, r.maxRelError);
+        report.Add(r);
+    }
+
+    if (Selected(options, "AffineMath::InverseScaleRotate")) {
+        std::vector<AffineMatrix> affine(kCount), inv(kCount);
+        for (size_t i = 0; i < kCount; ++i)
+            affine[i] = AffineMath::MakeAffine(in.scale[i], in.rotate[i], in.translate[i]);
+        bench::Result r;
+        r.name = "AffineMath::InverseScaleRotate";
+        r.nsPerOp = bench::MeasureNsPerOp([&] {
+            for (size_t i = 0; i < kCount; ++i)
+                inv[i] = AffineMath::InverseScaleRotate(affine[i]);
+            bench::DoNotOptimize(inv);
+        }, kCount, options, &r.ops);
+        r.maxAbsError = r.maxRelError = 0.0;
+        for (size_t i = 0; i < kCount; ++i)
+            AccumulateError(AffineMath::ToMatrix4x4(inv[i]), InverseD(AffineD(in.scale[i], in.rotate[i], in.translate[i])), r.maxAbsError, r.maxRelError);
+        report.Add(r);
+    }
+
+    if (Selected(options, "MatrixMath::MakeLookAtMatrix")) {
+        const Vector3 up { 0.0f, 1.0f, 0.0f };
+        bench::Result r;
+        r.name = "MatrixMath::MakeLookAtMatrix";
+        r.nsPerOp = bench::MeasureNsPerOp([&] {
+            for (size_t i = 0; i < kCount; ++i)
+                out[i] = MatrixMath::MakeLookAtMatrix(in.eye[i], in.target[i], up);
+            bench::DoNotOptimize(out);
+        }, kCount, options, &r.ops);
+        r.maxAbsError = r.maxRelError = 0.0;
+        for (size_t i = 0; i < kCount; ++i)
+            AccumulateError(MatrixMath::MakeLookAtMatrix(in.eye[i], in.target[i], up), LookAtD(in.eye[i], in.target[i], up), r.maxAbsError, r.maxRelError);
+        report.Add(r);
+    }
+
+    if (Selected(options, "MatrixMath::MakePerspectiveFovMatrix")) {
+        bench::Result r;
+        r.name = "MatrixMath::MakePerspectiveFovMatrix";
+        r.nsPerOp = bench::MeasureNsPerOp([&] {
+            for (size_t i = 0; i < kCount; ++i)
+                out[i] = MatrixMath::MakePerspectiveFovMatrix(in.fov[i], 16.0f / 9.0f, 0.1f, 1000.0f);
+            bench::DoNotOptimize(out);
+        }, kCount, options, &r.ops);
+        r.maxAbsError = r.maxRelError = 0.0;
+        for (size_t i = 0; i < kCount; ++i)
+            AccumulateError(MatrixMath::MakePerspectiveFovMatrix(in.fov[i], 16.0f / 9.0f, 0.1f, 1000.0f),
+                PerspectiveD(in.fov[i], double(16.0f / 9.0f), double(0.1f), 1000.0), r.maxAbsError, r.maxRelError);
+        report.Add(r);
+    }
+}
+#pragma endregion
+
+#pragma region sin/cos・投影
+void BenchSinCosAndProjection(const Inputs& in, const bench::Options& options, bench::Report& report)
+{
+    std::vector<float> s(kCount), c(kCount);
+    const SinCosMode modes[2] = { SinCosMode::Exact, SinCosMode::Fast };
+    for (SinCosMode mode : modes) {
+        const std::string name = std::string("SinCosMath::SinCosArray/") + (mode == SinCosMode::Exact ? "exact" : "fast");
+        if (!Selected(options, name.c_str()))
+            continue;
+        bench::Result r;
+        r.name = name;
+        r.nsPerOp = bench::MeasureNsPerOp([&] {
+            SinCosMath::SinCosArray(in.angles.data(), s.data(), c.data(), kCount, mode);
+            bench::DoNotOptimize(s);
+            bench::DoNotOptimize(c);
+        }, kCount, options, &r.ops);
+
+        // 相対誤差の代わりに ulp（参照値の float 間隔）で測る
+        double maxAbs = 0.0, maxUlp = 0.0;
+        for (size_t i = 0; i < kCount; ++i) {
+            const double refs[2] = { std::sin(double(in.angles[i])), std::cos(double(in.angles[i])) };
+            const float gots[2] = { s[i], c[i] };
+            for (int k = 0; k < 2; ++k) {
+                const double err = std::abs(gots[k] - refs[k]);
+                maxAbs = (std::max)(maxAbs, err);
+                const float refF = static_cast<float>(std::abs(refs[k]));
+                if (refF > 1e-3f) {
+                    maxUlp = (std::max)(maxUlp, err / double(std::nextafter(refF, 2.0f) - refF));
+                }
+            }
+        }
+        r.maxAbsError = maxAbs;
+        r.note = "max_ulp=" + std::to_string(maxUlp);
+        report.Add(r);
+    }
+
+    if (Selected(options, "ProjectionMath::ProjectToScreen")) {
+        const Matrix4x4 vp = MatrixMath::Multiply(
+            MatrixMath::MakeLookAtMatrix({ 0.0f, 10.0f, -80.0f }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }),
+            MatrixMath::MakePerspectiveFovMatrix(0.9f, 16.0f / 9.0f, 0.1f, 1000.0f));
+        const Mat4d vpD = MulD(LookAtD({ 0.0f, 10.0f, -80.0f }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }),
+            PerspectiveD(0.9f, double(16.0f / 9.0f), double(0.1f), 1000.0));
+        std::vector<ScreenPoint> out(kCount);
+        size_t visible = 0;
+
+        bench::Result r;
+        r.name = "ProjectionMath::ProjectToScreen";
+        r.nsPerOp = bench::MeasureNsPerOp([&] {
+            visible = ProjectionMath::ProjectToScreen(in.points.data(), out.data(), kCount, vp, 1280.0f, 720.0f);
+            bench::DoNotOptimize(out);
+        }, kCount, options, &r.ops);
+
+        // 画面内の点のピクセル誤差と、フラグの不一致
+        r.maxAbsError = 0.0;
+        for (size_t i = 0; i < kCount; ++i) {
+            const Vector3& p = in.points[i];
+            double clip[4];
+            for (int j = 0; j < 4; ++j)
+                clip[j] = p.x * vpD.m[0][j] + p.y * vpD.m[1][j] + p.z * vpD.m[2][j] + vpD.m[3][j];
+            const bool behindD = clip[3] <= 1e-6;
+            if (behindD != ((out[i].flags & ProjectionMath::kBehind) != 0)) {
+                ++r.mismatches;
+                continue;
+            }
+            if (behindD || out[i].flags != 0)
+                continue;
+            const double sx = (clip[0] / clip[3] * 0.5 + 0.5) * 1280.0;
+            const double sy = (-clip[1] / clip[3] * 0.5 + 0.5) * 720.0;
+            r.maxAbsError = (std::max)(r.maxAbsError, (std::max)(std::abs(sx - out[i].position.x), std::abs(sy - out[i].position.y)));
+        }
+        r.note = "visible=" + std::to_string(visible) + ", error in pixels";
+        report.Add(r);
+    }
+}
+#pragma endregion
+
+#pragma region 乱数
+void BenchRandom(const bench::Options& options, bench::Report& report)
+{
+    std::vector<float> f(kCount);
+    std::vector<Vector3> v(kCount);
+
+    if (Selected(options, "Random::NextFloat")) {
+        Random rng(1);
+        bench::Result r;
+        r.name = "Random::NextFloat";
+        r.nsPerOp = bench::MeasureNsPerOp([&] {
+            for (size_t i = 0; i < kCount; ++i)
+                f[i] = rng.NextFloat(-1.0f, 1.0f);
+            bench::DoNotOptimize(f);
+        }, kCount, options, &r.ops);
+        report.Add(r);
+    }
+
+    // 一括版は 1 個ずつ呼んだ場合と同じ列になることも確認する
+    if (Selected(options, "Random::FillUniform")) {
+        Random rng(1);
+        bench::Result r;
+        r.name = "Random::FillUniform";
+        r.nsPerOp = bench::MeasureNsPerOp([&] {
+            rng.FillUniform(f.data(), kCount, -1.0f, 1.0f);
+            bench::DoNotOptimize(f);
+        }, kCount, options, &r.ops);
+
+        Random a(7), b(7);
+        a.FillUniform(f.data(), kCount, -1.0f, 1.0f);
+        for (size_t i = 0; i < kCount; ++i)
+            if (f[i] != b.NextFloat(-1.0f, 1.0f))
+                ++r.mismatches;
+        report.Add(r);
+    }
+
+    if (Selected(options, "Random::FillUnitVectors")) {
+        Random rng(1);
+        bench::Result r;
+        r.name = "Random::FillUnitVectors";
+        r.nsPerOp = bench::MeasureNsPerOp([&] {
+            rng.FillUnitVectors(v.data(), kCount);
+            bench::DoNotOptimize(v);
+        }, kCount, options, &r.ops);
+
+        Random a(7), b(7);
+        a.FillUnitVectors(v.data(), kCount);
+        r.maxAbsError = 0.0;
+        for (size_t i = 0; i < kCount; ++i) {
+            const Vector3 w = b.NextUnitVector();
+            if (w.x != v[i].x || w.y != v[i].y || w.z != v[i].z)
+                ++r.mismatches;
+            const double len = std::sqrt(double(v[i].x) * v[i].x + double(v[i].y) * v[i].y + double(v[i].z) * v[i].z);
+            r.maxAbsError = (std::max)(r.maxAbsError, std::abs(len - 1.0));
+        }
+        r.note = "error = |length - 1|";
+        report.Add(r);
+    }
+}
+#pragma endregion
+
+#pragma region パーティクルソート
+// 奥→手前になっていない隣接ペアの数
+uint64_t CountSortViolations(const std::vector<float>& depth, const std::vector<uint32_t>& order)
+{
+    uint64_t violations = 0;
+    for (size_t i = 1; i < order.size(); ++i)
+        if (depth[order[i - 1]] < depth[order[i]])
+            ++violations;
+    return violations;
+}
+
+void BenchParticleSort(const bench::Options& options, bench::Report& report)
+{
+    // 5 万粒子・奥行き 1～50。b は a を少しだけ動かしたもの（フレーム間の変化を模す）
+    constexpr uint32_t kParticles = 50000;
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<float> depthDist(1.0f, 50.0f);
+    std::uniform_real_distribution<float> jitterDist(-0.002f, 0.002f);
+    std::vector<float> a(kParticles), b(kParticles);
+    for (uint32_t i = 0; i < kParticles; ++i) {
+        a[i] = depthDist(gen);
+        b[i] = a[i] + jitterDist(gen);
+    }
+    // 64 粒子に 1 組、a では後ろの添字が奥・b では同じ深度になる組を混ぜる
+    // （前フレームの並びが添字の逆順のまま同じ深度になるので、同じ深度を添字順に直せているか分かる）
+    for (uint32_t i = 0; i + 1 < kParticles; i += 64) {
+        a[i + 1] = a[i] + 0.001f;
+        b[i + 1] = b[i];
+    }
+
+    std::vector<uint32_t> order;
+    ParticleSort::Scratch scratch;
+
+    if (Selected(options, "ParticleSort::Radix")) {
+        bench::Result r;
+        r.name = "ParticleSort::Radix";
+        r.nsPerOp = bench::MeasureNsPerOp([&] {
+            ParticleSort::SortBackToFront(a.data(), kParticles, order, scratch);
+            bench::DoNotOptimize(order);
+        }, kParticles, options, &r.ops);
+        r.mismatches = CountSortViolations(a, order);
+        r.note = "50k, ns per particle";
+        report.Add(r);
+    }
+
+    // a と b を交互に並べ直す（毎回前回の結果から始まる）
+    if (Selected(options, "ParticleSort::Incremental")) {
+        bench::Result r;
+        r.name = "ParticleSort::Incremental";
+        uint64_t fallbacks = 0;
+        bool flip = false;
+        ParticleSort::SortBackToFront(a.data(), kParticles, order, scratch);
+        r.nsPerOp = bench::MeasureNsPerOp([&] {
+            flip = !flip;
+            fallbacks += ParticleSort::SortBackToFrontIncremental(flip ? b.data() : a.data(), kParticles, order, scratch);
+            bench::DoNotOptimize(order);
+        }, kParticles, options, &r.ops);
+        // a の並びから b を並べ直して、奥→手前になっているかに加えて Radix と同じ並び（同じ深度は添字順）か
+        ParticleSort::SortBackToFront(a.data(), kParticles, order, scratch);
+        fallbacks += ParticleSort::SortBackToFrontIncremental(b.data(), kParticles, order, scratch);
+        std::vector<uint32_t> expected;
+        ParticleSort::SortBackToFront(b.data(), kParticles, expected, scratch);
+        r.mismatches = CountSortViolations(b, order);
+        for (uint32_t i = 0; i < kParticles; ++i)
+            r.mismatches += (order[i] != expected[i]) ? 1 : 0;
+        r.note = "50k coherent, fallbacks " + std::to_string(fallbacks);
+        report.Add(r);
+    }
+}
+#pragma endregion
+
+#pragma region パーティクルの当たり判定
+// グリッドの結果（当たった数・押し出し後の位置）が総当たりと食い違ったら false（ctest の particle_collision で使う）
+bool BenchParticleCollision(const bench::Options& options, bench::Report& report)
+{
+    bool ok = true;
+    // 200m 四方に壁 400 枚（半分は OBB）、その上空から 1 万粒子
+    constexpr uint32_t kWalls = 400;
+    constexpr uint32_t kParticles = 10000;
+    std::mt19937 gen(23);
+    std::uniform_real_distribution<float> posDist(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> heightDist(-5.0f, 5.0f);
+    std::uniform_real_distribution<float> halfDist(0.5f, 4.0f);
+    std::uniform_real_distribution<float> angleDist(-3.14159f, 3.14159f);
+
+    ParticleCollisionWorld world;
+    world.SetGround(-5.0f);
+    for (uint32_t i = 0; i < kWalls; ++i) {
+        const Vector3 center { posDist(gen), heightDist(gen), posDist(gen) };
+        const Vector3 half { halfDist(gen), halfDist(gen), halfDist(gen) };
+        if (i % 2 == 0) {
+            world.AddAABB(center, half);
+        } else {
+            CachedOrientation orientation;
+            orientation.Sync({ 0.0f, angleDist(gen), 0.0f });
+            world.AddBox(center, half, orientation.axis);
+        }
+    }
+    world.Build();
+
+    std::vector<Vector3> position0(kParticles), velocity0(kParticles);
+    std::vector<float> lifeTime(kParticles, 1.0f);
+    for (uint32_t i = 0; i < kParticles; ++i) {
+        position0[i] = { posDist(gen), heightDist(gen) - 1.0f, posDist(gen) };
+        velocity0[i] = { 0.0f, -1.0f, 0.0f };
+    }
+
+    ParticleCollisionResponse response;
+    response.mode = ParticleCollisionMode::Bounce;
+    response.radius = 0.05f;
+
+    // 毎回同じ入力から始める（押し出すと次の呼び出しで当たらなくなるため）
+    auto runWith = [&](const ParticleCollisionWorld& target, const ParticleCollisionResponse& targetResponse, bool grid,
+                       std::vector<Vector3>& position, std::vector<Vector3>& velocity, std::vector<float>& currentTime) {
+        position = position0;
+        velocity = velocity0;
+        currentTime.assign(kParticles, 0.0f);
+        ParticleCollisionWorld::Batch batch { position.data(), velocity.data(), currentTime.data(), lifeTime.data(), kParticles };
+        return grid ? target.Resolve(batch, targetResponse) : target.ResolveBruteForce(batch, targetResponse);
+    };
+    auto run = [&](bool grid, std::vector<Vector3>& position, std::vector<Vector3>& velocity, std::vector<float>& currentTime) {
+        return runWith(world, response, grid, position, velocity, currentTime);
+    };
+    // 位置がずれた粒子の数と、ずれの最大
+    auto countMoved = [&](const std::vector<Vector3>& a, const std::vector<Vector3>& b, double& maxAbsError) {
+        uint32_t moved = 0;
+        for (uint32_t i = 0; i < kParticles; ++i) {
+            const Vector3 d = a[i] - b[i];
+            const float error = (std::max)({ std::abs(d.x), std::abs(d.y), std::abs(d.z) });
+            maxAbsError = (std::max)(maxAbsError, double(error));
+            moved += (error > 1e-4f) ? 1 : 0;
+        }
+        return moved;
+    };
+
+    std::vector<Vector3> gridPos, gridVel, brutePos, bruteVel;
+    std::vector<float> gridTime, bruteTime;
+    const uint32_t gridHits = run(true, gridPos, gridVel, gridTime);
+    const uint32_t bruteHits = run(false, brutePos, bruteVel, bruteTime);
+
+    if (Selected(options, "ParticleCollision::Grid")) {
+        bench::Result r;
+        r.name = "ParticleCollision::Grid";
+        r.nsPerOp = bench::MeasureNsPerOp([&] {
+            bench::DoNotOptimize(run(true, gridPos, gridVel, gridTime));
+        }, kParticles, options, &r.ops);
+
+        // 総当たりと結果（押し出し後の位置）が一致するか
+        // 押し出されてセルをまたいだ粒子も、番号順に続きの壁から当てるので同じ位置になる
+        r.maxAbsError = 0.0;
+        const uint32_t moved = countMoved(gridPos, brutePos, r.maxAbsError);
+        r.mismatches = ((gridHits > bruteHits) ? gridHits - bruteHits : bruteHits - gridHits) + moved;
+        ok = ok && r.mismatches == 0;
+        r.note = "400 walls, cells=" + std::to_string(world.GetCellCount()) + ", hits=" + std::to_string(gridHits);
+        report.Add(r);
+    }
+
+    if (Selected(options, "ParticleCollision::BruteForce")) {
+        bench::Result r;
+        r.name = "ParticleCollision::BruteForce";
+        r.nsPerOp = bench::MeasureNsPerOp([&] {
+            bench::DoNotOptimize(run(false, brutePos, bruteVel, bruteTime));
+        }, kParticles, options, &r.ops);
+        r.note = "400 walls, linear scan";
+        report.Add(r);
+    }
+
+    // 余白（kRegisterMargin）より大きい半径でも総当たりと同じになるか
+    // 余白を広げて組み直したグリッドと、組み直していない（総当たりに回る）グリッドの両方を比べる
+    if (Selected(options, "ParticleCollision::WideRadius")) {
+        ParticleCollisionResponse wideResponse = response;
+        wideResponse.radius = 1.5f;
+        ParticleCollisionWorld wideWorld = world;
+        wideWorld.SetMaxRadius(wideResponse.radius);
+        wideWorld.Build();
+
+        std::vector<Vector3> widePos, wideVel, fallbackPos, fallbackVel;
+        std::vector<float> wideTime, fallbackTime;
+        const uint32_t wideBruteHits = runWith(world, wideResponse, false, brutePos, bruteVel, bruteTime);
+        const uint32_t fallbackHits = runWith(world, wideResponse, true, fallbackPos, fallbackVel, fallbackTime);
+
+        bench::Result r;
+        r.name = "ParticleCollision::WideRadius";
+        uint32_t wideHits = 0;
+        r.nsPerOp = bench::MeasureNsPerOp([&] {
+            wideHits = runWith(wideWorld, wideResponse, true, widePos, wideVel, wideTime);
+            bench::DoNotOptimize(wideHits);
+        }, kParticles, options, &r.ops);
+
+        r.maxAbsError = 0.0;
+        r.mismatches = countMoved(widePos, brutePos, r.maxAbsError) + countMoved(fallbackPos, brutePos, r.maxAbsError)
+            + ((wideHits != wideBruteHits) ? 1 : 0) + ((fallbackHits != wideBruteHits) ? 1 : 0);
+        ok = ok && r.mismatches == 0;
+        r.note = "radius 1.5, margin " + std::to_string(wideWorld.GetRegisterMargin()).substr(0, 4)
+            + ", hits=" + std::to_string(wideHits);
+        report.Add(r);
+    }
+    return ok;
+}
+#pragma endregion
+
+#pragma region curl ノイズ
+void BenchCurlNoise(const bench::Options& options, bench::Report& report)
+{
+    // 起動時に焼くのと同じ 32^3 の場を、火の粉が飛ぶくらいの範囲の 1 万粒子で引く
+    constexpr uint32_t kParticles = 10000;
+    constexpr float kFrequency = 2.0f;
+
+    const auto t0 = std::chrono::steady_clock::now();
+    CurlNoiseField field;
+    field.Bake();
+    const double bakeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    std::mt19937 gen(29);
+    std::uniform_real_distribution<float> posDist(-20.0f, 20.0f);
+    std::vector<Vector3> positions(kParticles);
+    for (Vector3& p : positions) {
+        p = { posDist(gen), posDist(gen), posDist(gen) };
+    }
+    std::vector<Vector3> batched(kParticles), single(kParticles);
+
+    auto sampleSingle = [&] {
+        for (uint32_t i = 0; i < kParticles; ++i) {
+            single[i] = field.Sample(positions[i], kFrequency);
+        }
+    };
+    sampleSingle();
+    field.SampleArray(positions.data(), kParticles, kFrequency, batched.data());
+
+    if (Selected(options, "CurlNoise::SampleArray")) {
+        bench::Result r;
+        r.name = "CurlNoise::SampleArray";
+        r.nsPerOp = bench::MeasureNsPerOp([&] {
+            field.SampleArray(positions.data(), kParticles, kFrequency, batched.data());
+            bench::DoNotOptimize(batched[0]);
+        }, kParticles, options, &r.ops);
+
+        // 1 点ずつ引いた値と一致するか（補間の順番は同じにしてある）
+        r.maxAbsError = 0.0;
+        for (uint32_t i = 0; i < kParticles; ++i) {
+            const Vector3 d = batched[i] - single[i];
+            r.maxAbsError = (std::max)(r.maxAbsError, double((std::max)({ std::abs(d.x), std::abs(d.y), std::abs(d.z) })));
+        }
+        char note[96];
+        std::snprintf(note, sizeof(note), "%u^3, %zu KB, bake %.1f ms", field.GetResolution(), field.GetMemorySize() / 1024, bakeMs);
+        r.note = note;
+        report.Add(r);
+    }
+
+    if (Selected(options, "CurlNoise::Sample")) {
+        bench::Result r;
+        r.name = "CurlNoise::Sample";
+        r.nsPerOp = bench::MeasureNsPerOp([&] {
+            sampleSingle();
+            bench::DoNotOptimize(single[0]);
+        }, kParticles, options, &r.ops);
+        r.note = "scalar, one point at a time";
+        report.Add(r);
+    }
+}
+#pragma endregion
+
+#pragma region 壁（SAT）
+void BenchWalls(const Inputs& in, const bench::Options& options, bench::Report& report)
+{
+    std::vector<Vector3> push(kCount);
+    std::vector<uint8_t> hit(kCount);
+
+    if (Selected(options, "Walls::ResolveAABB_vs_OBB_MinPush")) {
+        bench::Result r;
+        r.name = "Walls::ResolveAABB_vs_OBB_MinPush";
+        r.nsPerOp = bench::MeasureNsPerOp([&] {
+            for (size_t i = 0; i < kCount; ++i)
+                hit[i] = ResolveAABB_vs_OBB_MinPush(in.aabbCenter[i], in.aabbHalf[i], in.obbs[i], push[i]);
+            bench::DoNotOptimize(push);
+            bench::DoNotOptimize(hit);
+        }, kCount, options, &r.ops);
+
+        // 押し戻し量（最小重なり）を double 版と比べる。当たり判定の食い違いは mismatches
+        r.maxAbsError = 0.0;
+        size_t hits = 0;
+        for (size_t i = 0; i < kCount; ++i) {
+            double depth = 0.0;
+            const bool hitD = SatDepthD(in.aabbCenter[i], in.aabbHalf[i], in.obbs[i], depth);
+            if (hitD != (hit[i] != 0)) {
+                ++r.mismatches;
+                continue;
+            }
+            if (!hitD)
+                continue;
+            ++hits;
+            const double len = std::sqrt(double(push[i].x) * push[i].x + double(push[i].y) * push[i].y + double(push[i].z) * push[i].z);
+            r.maxAbsError = (std::max)(r.maxAbsError, std::abs(len - depth));
+        }
+        r.note = "hits=" + std::to_string(hits) + ", error = push depth";
+        report.Add(r);
+    }
+
+    if (Selected(options, "Walls::ResolveAABB_vs_OBB_MinPush/cachedBasis")) {
+        std::vector<CachedOrientation> orientation(kCount);
+        for (size_t i = 0; i < kCount; ++i)
+            orientation[i].Sync(in.obbs[i].rot);
+        bench::Result r;
+        r.name = "Walls::ResolveAABB_vs_OBB_MinPush/cachedBasis";
+        r.nsPerOp = bench::MeasureNsPerOp([&] {
+            for (size_t i = 0; i < kCount; ++i)
+                hit[i] = ResolveAABB_vs_OBB_MinPush(in.aabbCenter[i], in.aabbHalf[i], in.obbs[i], orientation[i].axis, push[i]);
+            bench::DoNotOptimize(push);
+            bench::DoNotOptimize(hit);
+        }, kCount, options, &r.ops);
+        report.Add(r);
+    }
+
+    // 壁ごとに SAT 軸を焼いておく（WallSystem が実際に使う形）。軸をその場で作る版と結果が一致するか
+    if (Selected(options, "Walls::ResolveAABB_vs_OBB_MinPush/compiled")) {
+        CompiledWalls compiled;
+        compiled.Resize(static_cast<uint32_t>(kCount));
+        for (size_t i = 0; i < kCount; ++i)
+            compiled.Compile(static_cast<uint32_t>(i), true, in.obbs[i].center, in.obbs[i].half, in.obbs[i].rot);
+        bench::Result r;
+        r.name = "Walls::ResolveAABB_vs_OBB_MinPush/compiled";
+        r.nsPerOp = bench::MeasureNsPerOp([&] {
+            for (size_t i = 0; i < kCount; ++i)
+                hit[i] = compiled.ResolveOBB(static_cast<uint32_t>(i), in.aabbCenter[i], in.aabbHalf[i], push[i]);
+            bench::DoNotOptimize(push);
+            bench::DoNotOptimize(hit);
+        }, kCount, options, &r.ops);
+
+        r.maxAbsError = 0.0;
+        for (size_t i = 0; i < kCount; ++i) {
+            Vector3 expected { 0, 0, 0 };
+            const bool hitRef = ResolveAABB_vs_OBB_MinPush(in.aabbCenter[i], in.aabbHalf[i], in.obbs[i], expected);
+            if (hitRef != (hit[i] != 0)) {
+                ++r.mismatches;
+                continue;
+            }
+            if (hitRef)
+                r.maxAbsError = (std::max)(r.maxAbsError, double(V3Len(V3Sub(push[i], expected))));
+        }
+        r.note = "error = push vs per-call axes";
+        report.Add(r);
+    }
+
+    if (Selected(options, "Walls::ResolveAABB_vs_AABB_MinPush")) {
+        std::vector<AABB3> moving(kCount), solid(kCount);
+        for (size_t i = 0; i < kCount; ++i) {
+            moving[i] = MakeAABB_CenterHalf(in.aabbCenter[i], in.aabbHalf[i]);
+            solid[i] = MakeAABB_CenterHalf(in.obbs[i].center, in.obbs[i].half);
+        }
+        bench::Result r;
+        r.name = "Walls::ResolveAABB_vs_AABB_MinPush";
+        r.nsPerOp = bench::MeasureNsPerOp([&] {
+            for (size_t i = 0; i < kCount; ++i)
+                hit[i] = ResolveAABB_vs_AABB_MinPush(moving[i], solid[i], push[i]);
+            bench::DoNotOptimize(push);
+            bench::DoNotOptimize(hit);
+        }, kCount, options, &r.ops);
+        report.Add(r);
+    }
+}
+
+// 壁のブロードフェーズ（WallBvh）。数千枚の壁に対して「ドローンの箱と重なる壁を拾って narrow phase」を
+// 全部の壁を順に見る場合と比べる。当たった壁の集合が食い違ったら mismatches
+// 食い違いがあるか、編集を続けた後の木が偏っていたら false（ctest の wall_broadphase で使う）
+bool BenchWallBroadphase(const bench::Options& options, bench::Report& report)
+{
+    bool ok = true;
+    // 200m 四方に 4096 枚（半分は Y 回転の OBB）
+    constexpr uint32_t kWalls = 4096;
+    std::mt19937 rng(777);
+    std::uniform_real_distribution<float> world(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> size(0.3f, 4.0f);
+    std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
+
+    CompiledWalls compiled;
+    compiled.Resize(kWalls);
+    for (uint32_t i = 0; i < kWalls; ++i) {
+        const Vector3 center { world(rng), size(rng), world(rng) };
+        const Vector3 half { size(rng), size(rng), size(rng) * 0.25f };
+        const Vector3 rot { 0.0f, angle(rng), 0.0f };
+        compiled.Compile(i, i % 2 != 0, center, half, rot);
+    }
+    const std::vector<AABB3>& bounds = compiled.Bounds();
+
+    // ドローン（1 フレームで動く分だけ広げた箱）
+    const Vector3 droneHalf { 0.5f, 0.3f, 0.5f };
+    std::vector<Vector3> drone(kCount);
+    for (auto& p : drone) {
+        p = { world(rng), size(rng), world(rng) };
+    }
+    auto sweptBox = [&](const Vector3& p) {
+        return MakeAABB_CenterHalf(p, V3Add(droneHalf, { 0.5f, 0.5f, 0.5f }));
+    };
+    auto narrow = [&](uint32_t i, const Vector3& p) {
+        Vector3 push { 0, 0, 0 };
+        if (!compiled.IsOBB(i)) {
+            return compiled.ResolveAABB(i, MakeAABB_CenterHalf(p, droneHalf), push);
+        }
+        return compiled.ResolveOBB(i, p, droneHalf, push);
+    };
+
+    WallBvh bvh;
+    bvh.Build(bounds);
+    std::vector<uint32_t> candidates;
+    candidates.reserve(kWalls);
+
+    // 各ドローン位置で当たった壁の番号を足し合わせたもの（集合の比較の代わり）
+    std::vector<uint64_t> bruteSum(kCount), bvhSum(kCount);
+
+    if (Selected(options, "Walls::Broadphase/bruteForce")) {
+        bench::Result r;
+        r.name = "Walls::Broadphase/bruteForce";
+        r.nsPerOp = bench::MeasureNsPerOp([&] {
+            for (size_t d = 0; d < kCount; ++d) {
+                uint64_t sum = 0;
+                for (uint32_t i = 0; i < kWalls; ++i) {
+                    if (narrow(i, drone[d])) {
+                        sum += i + 1;
+                    }
+                }
+                bruteSum[d] = sum;
+            }
+            bench::DoNotOptimize(bruteSum);
+        }, kCount, options, &r.ops);
+        r.note = std::to_string(kWalls) + " walls, per drone query";
+        report.Add(r);
+    }
+
+    if (Selected(options, "Walls::Broadphase/bvh")) {
+        size_t totalCandidates = 0;
+        bench::Result r;
+        r.name = "Walls::Broadphase/bvh";
+        r.nsPerOp = bench::MeasureNsPerOp([&] {
+            totalCandidates = 0;
+            for (size_t d = 0; d < kCount; ++d) {
+                candidates.clear();
+                bvh.Query(sweptBox(drone[d]), candidates);
+                totalCandidates += candidates.size();
+                uint64_t sum = 0;
+                for (uint32_t i : candidates) {
+                    if (narrow(i, drone[d])) {
+                        sum += i + 1;
+                    }
+                }
+                bvhSum[d] = sum;
+            }
+            bench::DoNotOptimize(bvhSum);
+        }, kCount, options, &r.ops);
+
+        // 全部を見た場合と同じ壁に当たっているか
+        for (size_t d = 0; d < kCount; ++d) {
+            uint64_t sum = 0;
+            for (uint32_t i = 0; i < kWalls; ++i) {
+                if (narrow(i, drone[d])) {
+                    sum += i + 1;
+                }
+            }
+            if (sum != bvhSum[d]) {
+                ++r.mismatches;
+            }
+        }
+        ok = ok && r.mismatches == 0;
+        char note[96];
+        std::snprintf(note, sizeof(note), "%u walls, height %d, %.2f candidates/query", kWalls, bvh.GetHeight(),
+            static_cast<double>(totalCandidates) / kCount);
+        r.note = note;
+        report.Add(r);
+    }
+
+    // エディタで壁を動かす想定（1 枚ずつ箱を直す）
+    // 少しずらすだけの壁と、遠くへ動かして入れ直しになる壁を混ぜる
+    if (Selected(options, "Walls::Broadphase/update")) {
+        std::vector<AABB3> moved(bounds);
+        const int32_t builtHeight = bvh.GetHeight();
+        uint32_t cursor = 0;
+        float offset = 0.0f;
+        bench::Result r;
+        r.name = "Walls::Broadphase/update";
+        r.nsPerOp = bench::MeasureNsPerOp([&] {
+            offset = (offset > 1.0f) ? -1.0f : offset + 0.05f;
+            for (size_t n = 0; n < kCount; ++n) {
+                const uint32_t i = cursor;
+                cursor = (cursor + 97) % kWalls;
+                const Vector3 shift = (n % 4 == 0) ? Vector3 { world(rng), 0.0f, world(rng) } : Vector3 { offset, 0.0f, 0.0f };
+                moved[i] = { V3Add(bounds[i].min, shift), V3Add(bounds[i].max, shift) };
+                bvh.Update(i, moved[i]);
+            }
+        }, kCount, options, &r.ops);
+
+        // 動かした後の木でも、全部を見た場合と同じ壁が重なって見えるか
+        for (size_t d = 0; d < kCount; ++d) {
+            const AABB3 box = sweptBox(drone[d]);
+            candidates.clear();
+            bvh.Query(box, candidates);
+            size_t expected = 0;
+            for (uint32_t i = 0; i < kWalls; ++i) {
+                expected += IntersectAABB(moved[i], box) ? 1 : 0;
+            }
+            if (candidates.size() != expected) {
+                ++r.mismatches;
+            }
+        }
+        // 回転で高さをそろえているので、組み直さなくても一括で組んだ木の 1.5 倍程度（AVL 木の上限は約 1.44 log2 n）に収まるはず
+        const bool bounded = bvh.GetHeight() <= builtHeight * 3 / 2 + 2;
+        if (!bounded) {
+            ++r.mismatches;
+        }
+        ok = ok && r.mismatches == 0;
+        r.note = "height " + std::to_string(builtHeight) + " -> " + std::to_string(bvh.GetHeight()) + (bounded ? "" : " (unbalanced)");
+        report.Add(r);
+    }
+    return ok;
+}
+#pragma endregion
+
+#pragma region ゲート
+void BenchGate(const Inputs& in, const bench::Options& options, bench::Report& report)
+{
+    if (!Selected(options, "Gate::TryPass")) {
+        return;
+    }
+
+    // 各ゲートの手前(+z)と奥(-z)の点を交互に渡して、毎回「通過イベント」を起こす
+    constexpr size_t kGates = 256;
+    std::vector<Gate> gates(kGates);
+    std::vector<Vector3> front(kGates), back(kGates);
+    std::vector<std::array<double, 3>> localFront(kGates), localBack(kGates);
+    std::mt19937 rng(777);
+    std::uniform_real_distribution<float> radius(0.0f, 3.0f);
+    std::uniform_real_distribution<float> phase(0.0f, 6.2831853f);
+    std::uniform_real_distribution<float> depth(0.05f, 0.6f);
+
+    for (size_t i = 0; i < kGates; ++i) {
+        Gate& g = gates[i];
+        g.pos = in.translate[i];
+        g.rot = in.rotate[i];
+        g.UpdateMatrices();
+
+        const float rr = radius(rng), ph = phase(rng), dz = depth(rng);
+        localFront[i] = { rr * std::cos(ph), rr * std::sin(ph), dz };
+        localBack[i] = { rr * std::cos(ph), rr * std::sin(ph), -dz };
+        const AffineMatrix world = AffineMath::MakeAffine({ 1, 1, 1 }, g.rot, g.pos);
+        front[i] = AffineMath::TransformPoint({ float(localFront[i][0]), float(localFront[i][1]), float(localFront[i][2]) }, world);
+        back[i] = AffineMath::TransformPoint({ float(localBack[i][0]), float(localBack[i][1]), float(localBack[i][2]) }, world);
+    }
+
+    bench::Result r;
+    r.name = "Gate::TryPass";
+    uint64_t events = 0;
+    r.nsPerOp = bench::MeasureNsPerOp([&] {
+        GateResult res;
+        for (size_t i = 0; i < kGates; ++i) {
+            events += gates[i].TryPass(front[i], res);
+            events += gates[i].TryPass(back[i], res);
+        }
+        bench::DoNotOptimize(events);
+    }, kGates * 2, options, &r.ops);
+
+    // ゲートローカル座標の誤差（double で R^T (p - pos)）と判定結果の不一致
+    r.maxAbsError = 0.0;
+    for (size_t i = 0; i < kGates; ++i) {
+        Gate& g = gates[i];
+        const Mat4d rot = RotateXYZD(g.rot.x, g.rot.y, g.rot.z);
+        GateResult res;
+        g.TryPass(front[i], res);
+        const Vector3 p = front[i];
+        const double d[3] = { double(p.x) - g.pos.x, double(p.y) - g.pos.y, double(p.z) - g.pos.z };
+        double local[3];
+        for (int j = 0; j < 3; ++j)
+            local[j] = d[0] * rot.m[j][0] + d[1] * rot.m[j][1] + d[2] * rot.m[j][2];
+        const float got[3] = { g.dbgLocalPos.x, g.dbgLocalPos.y, g.dbgLocalPos.z };
+        for (int j = 0; j < 3; ++j)
+            r.maxAbsError = (std::max)(r.maxAbsError, std::abs(got[j] - local[j]));
+
+        const double rr = std::sqrt(local[0] * local[0] + local[1] * local[1]);
+        GateResult expected = GateResult::Miss;
+        if (std::abs(local[2]) <= g.thickness * 0.5) {
+            expected = rr <= g.perfectRadius ? GateResult::Perfect : (rr <= g.gateRadius ? GateResult::Good : GateResult::Miss);
+        }
+        if (res != expected)
+            ++r.mismatches;
+    }
+    r.note = "error = gate-local position";
+    report.Add(r);
+}
+#pragma endregion
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const bench::Options options = bench::ParseOptions(argc, argv);
+    const Inputs inputs = MakeInputs();
+
+    bench::Report report("math");
+    BenchMatrix(inputs, options, report);
+    BenchSinCosAndProjection(inputs, options, report);
+    BenchRandom(options, report);
+    BenchParticleSort(options, report);
+    const bool collisionOk = BenchParticleCollision(options, report);
+    BenchCurlNoise(options, report);
+    BenchWalls(inputs, options, report);
+    const bool broadphaseOk = BenchWallBroadphase(options, report);
+    BenchGate(inputs, options, report);
+
+    return (report.WriteJson(options.jsonPath) && broadphaseOk && collisionOk) ? 0 : 1;
+}
@@ -0,0 +1,158 @@
+// パーティクルのシミュレーション本体（ParticleSimulation）をヘッドレスで回すベンチマーク
+// N グループ × M 粒子を K フレーム更新し、粒子 1 個あたりの時間と 1 フレームあたりのヒープ確保回数を出す
+//
+//   ./particle_benchmark                         既定の組み合わせを全部
+//   ./particle_benchmark --groups 8 --particles 4096 --frames 240 --workers 4
+#include "BenchCommon.h"
+#include "ParticleScenario.h"
+
+#include <atomic>
+#include <new>
+
+#pragma region 確保回数の計測
+namespace {
+
+// グローバルの operator new を差し替えて数える（ワーカースレッドからの確保も数える）
+std::atomic<uint64_t> gAllocationCount { 0 };
+
+} // namespace
+
+// 差し替えた new と free の組み合わせを GCC が取り違えて警告するので黙らせる
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size)
+{
+    gAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+#pragma endregion
+
+namespace {
+
+struct Options {
+    bench::Options common;
+    // 0 なら既定の組み合わせ
+    uint32_t groups = 0;
+    uint32_t particles = 0;
+    uint32_t frames = 0;
+    // ~0u なら 0 本と既定本数の両方
+    uint32_t workers = ~0u;
+    bool fixedStep = false;
+};
+
+Options Parse(int argc, char** argv)
+{
+    Options options;
+    auto readUint = [&](int& i) { return static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10)); };
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--quick") {
+            options.common.quick = true;
+        } else if (arg == "--json" && hasValue) {
+            options.common.jsonPath = argv[++i];
+        } else if (arg == "--groups" && hasValue) {
+            options.groups = readUint(i);
+        } else if (arg == "--particles" && hasValue) {
+            options.particles = readUint(i);
+        } else if (arg == "--frames" && hasValue) {
+            options.frames = readUint(i);
+        } else if (arg == "--workers" && hasValue) {
+            options.workers = readUint(i);
+        } else if (arg == "--fixed-step") {
+            options.fixedStep = true;
+        } else {
+            std::fprintf(stderr,
+                "usage: %s [--quick] [--json <path|->] [--groups N] [--particles M] [--frames K] [--workers T] [--fixed-step]\n",
+                argv[0]);
+            std::exit(2);
+        }
+    }
+    return options;
+}
+
+// 1 つの組み合わせを回して結果を返す
+// 最初の 1/4 は確保が落ち着くまでの準備として計測から外す
+bench::Result Run(const bench::ParticleScenarioConfig& config)
+{
+    using Clock = std::chrono::steady_clock;
+
+    bench::ParticleScenario scenario(config);
+    const uint32_t warmup = (std::max)(config.frames / 4, 1u);
+
+    double totalNs = 0.0;
+    uint64_t totalParticles = 0;
+    uint64_t allocations = 0;
+    uint32_t measured = 0;
+    for (uint32_t f = 0; f < config.frames; ++f) {
+        const uint64_t allocBefore = gAllocationCount.load(std::memory_order_relaxed);
+        const auto t0 = Clock::now();
+        scenario.Step();
+        const double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+        const uint64_t allocAfter = gAllocationCount.load(std::memory_order_relaxed);
+        if (f < warmup) {
+            continue;
+        }
+        totalNs += ns;
+        totalParticles += scenario.GetSimulation().GetLiveParticleCount();
+        allocations += allocAfter - allocBefore;
+        ++measured;
+    }
+    bench::DoNotOptimize(scenario.HashInstances());
+
+    bench::Result result;
+    result.name = "particles/" + std::to_string(config.groups) + "x" + std::to_string(config.particlesPerGroup)
+        + "/w" + std::to_string(config.workers) + (config.fixedStep ? "/fixed" : "");
+    result.nsPerOp = (totalParticles > 0) ? totalNs / static_cast<double>(totalParticles) : 0.0;
+    result.ops = totalParticles;
+    result.allocsPerFrame = (measured > 0) ? static_cast<double>(allocations) / measured : 0.0;
+    char note[96];
+    std::snprintf(note, sizeof(note), "%.3f ms/frame, %llu live", measured > 0 ? totalNs / measured * 1e-6 : 0.0,
+        static_cast<unsigned long long>(measured > 0 ? totalParticles / measured : 0));
+    result.note = note;
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const Options options = Parse(argc, argv);
+
+    // N グループ × M 粒子の組み合わせ（指定があればそれだけ）
+    std::vector<std::pair<uint32_t, uint32_t>> sizes = { { 1, 16384 }, { 8, 4096 }, { 32, 2048 } };
+    if (options.groups > 0 || options.particles > 0) {
+        sizes = { { options.groups > 0 ? options.groups : 8, options.particles > 0 ? options.particles : 4096 } };
+    }
+    std::vector<uint32_t> workerCounts = { 0, ParticleWorkerPool::DefaultWorkerCount() };
+    if (options.workers != ~0u) {
+        workerCounts = { options.workers };
+    } else if (workerCounts[1] == 0) {
+        workerCounts.pop_back();
+    }
+    const uint32_t frames = options.frames > 0 ? options.frames : (options.common.quick ? 60 : 600);
+
+    bench::Report report("particles");
+    for (const auto& [groups, particles] : sizes) {
+        for (uint32_t workers : workerCounts) {
+            bench::ParticleScenarioConfig config;
+            config.groups = groups;
+            config.particlesPerGroup = particles;
+            config.frames = frames;
+            config.workers = workers;
+            config.fixedStep = options.fixedStep;
+            report.Add(Run(config));
+        }
+    }
+    return report.WriteJson(options.common.jsonPath) ? 0 : 1;
+}
@@ -0,0 +1,205 @@
+// ParticleSimulation の決定性テスト
+// 固定シードで同じ場面を回し、毎フレームのインスタンスのハッシュを期待値（golden）と比べる
+// あわせて「同じシードを 2 回」「単一スレッドと並列」で結果がビット単位で一致することも調べる
+//
+//   ./particle_determinism_test <golden.json>                    比べる
+//   ./particle_determinism_test <golden.json> --update           今の結果で golden を書き直す
+//   ./particle_determinism_test <golden.json> --require-golden   この環境の期待値が無ければ 77 で終わる（ctest では SKIP）
+//
+// 浮動小数の丸めはコンパイラ・命令セットで変わりうるので、golden は環境ごとに確かめる
+//   "default"   : 共通の期待値
+//   "platforms" : 確かめた環境の一覧。中身は default と違うケースだけ（同じなら空）
+// 一覧に無い環境では一致チェックだけ行う。新しい環境では --update で追加してコミットする
+#include "BenchCommon.h"
+#include "ParticleScenario.h"
+
+#include <cinttypes>
+#include <fstream>
+
+namespace {
+
+struct Case {
+    const char* name;
+    bench::ParticleScenarioConfig config;
+};
+
+// 期待値が無い環境の終了コード（CMake の SKIP_RETURN_CODE と合わせる）
+constexpr int kSkipExitCode = 77;
+
+// 並列で回るように全体の粒子数は kParallelThreshold（4096）より多くしておく
+std::vector<Case> MakeCases()
+{
+    std::vector<Case> cases;
+    bench::ParticleScenarioConfig config;
+    config.groups = 4;
+    config.particlesPerGroup = 3000;
+    config.frames = 120;
+
+    config.seed = 1;
+    cases.push_back({ "variable_seed1", config });
+    config.seed = 0xC0FFEE;
+    cases.push_back({ "variable_seedC0FFEE", config });
+
+    config.seed = 1;
+    config.fixedStep = true;
+    cases.push_back({ "fixed_seed1", config });
+    return cases;
+}
+
+// 全フレームのハッシュをつないだもの（途中の 1 フレームだけずれても検出できる）
+uint64_t Run(const bench::ParticleScenarioConfig& config)
+{
+    bench::ParticleScenario scenario(config);
+    uint64_t chain = 0;
+    for (uint32_t f = 0; f < config.frames; ++f) {
+        scenario.Step();
+        chain = (chain ^ scenario.HashInstances()) * 0x100000001B3ull;
+    }
+    return chain;
+}
+
+std::string ToHex(uint64_t value)
+{
+    char text[32];
+    std::snprintf(text, sizeof(text), "%016" PRIx64, value);
+    return text;
+}
+
+// golden のキー（コンパイラ・CPU・数学レイヤーの SIMD）
+std::string PlatformKey()
+{
+#if defined(__clang__)
+    std::string key = "clang";
+#elif defined(__GNUC__)
+    std::string key = "gcc";
+#elif defined(_MSC_VER)
+    std::string key = "msvc";
+#else
+    std::string key = "unknown";
+#endif
+#if defined(__x86_64__) || defined(_M_X64)
+    key += "-x64";
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    key += "-arm64";
+#endif
+    return key + "-" + bench::SimdName();
+}
+
+// この環境での期待値（上書きが無ければ共通の値）
+std::string ExpectedHash(const nlohmann::json& golden, const std::string& platform, const char* name)
+{
+    const nlohmann::json& overrides = golden["platforms"][platform];
+    if (overrides.contains(name)) {
+        return overrides[name].get<std::string>();
+    }
+    const nlohmann::json& shared = golden.value("default", nlohmann::json::object());
+    return shared.value(name, std::string());
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <golden.json> [--update] [--require-golden]\n", argv[0]);
+        return 2;
+    }
+    const std::string goldenPath = argv[1];
+    bool update = false;
+    bool requireGolden = false;
+    for (int i = 2; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--update") {
+            update = true;
+        } else if (arg == "--require-golden") {
+            requireGolden = true;
+        } else {
+            std::fprintf(stderr, "usage: %s <golden.json> [--update] [--require-golden]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    nlohmann::json golden = nlohmann::json::object();
+    if (std::ifstream ifs(goldenPath); ifs) {
+        golden = nlohmann::json::parse(ifs, nullptr, false);
+        if (golden.is_discarded()) {
+            std::fprintf(stderr, "failed to parse %s\n", goldenPath.c_str());
+            return 1;
+        }
+    }
+    const std::string platform = PlatformKey();
+    const bool hasGolden = golden.contains("platforms") && golden["platforms"].contains(platform);
+    int failures = 0;
+    if (!hasGolden && !update) {
+        std::printf("no golden for %s (run with --update on this build and commit %s); checking self-consistency only\n",
+            platform.c_str(), goldenPath.c_str());
+    }
+
+    std::vector<uint64_t> hashes;
+    nlohmann::json results = nlohmann::json::object();
+    for (const Case& c : MakeCases()) {
+        // 単一スレッド 2 回と並列 1 回
+        bench::ParticleScenarioConfig serial = c.config;
+        serial.workers = 0;
+        bench::ParticleScenarioConfig parallel = c.config;
+        parallel.workers = 3;
+
+        const uint64_t first = Run(serial);
+        const uint64_t second = Run(serial);
+        const uint64_t threaded = Run(parallel);
+        hashes.push_back(first);
+
+        bool ok = true;
+        if (first != second) {
+            std::printf("[FAIL] %s: repeat run differs (%s vs %s)\n", c.name, ToHex(first).c_str(), ToHex(second).c_str());
+            ok = false;
+        }
+        if (first != threaded) {
+            std::printf("[FAIL] %s: parallel run differs (%s vs %s)\n", c.name, ToHex(first).c_str(), ToHex(threaded).c_str());
+            ok = false;
+        }
+        if (hasGolden && !update) {
+            const std::string expected = ExpectedHash(golden, platform, c.name);
+            if (expected != ToHex(first)) {
+                std::printf("[FAIL] %s: golden %s, got %s\n", c.name, expected.c_str(), ToHex(first).c_str());
+                ok = false;
+            }
+        }
+        results[c.name] = ToHex(first);
+        std::printf("[%s] %s %s\n", ok ? " OK " : "FAIL", c.name, ToHex(first).c_str());
+        failures += ok ? 0 : 1;
+    }
+
+    // シードを変えたら結果も変わること（乱数がつながっていない事故を拾う）
+    if (hashes.size() >= 2 && hashes[0] == hashes[1]) {
+        std::printf("[FAIL] different seeds produced the same output\n");
+        ++failures;
+    }
+
+    if (update) {
+        // 共通の値と違うケースだけをこの環境の上書きとして残す
+        nlohmann::json& shared = golden["default"];
+        nlohmann::json overrides = nlohmann::json::object();
+        for (const auto& [name, hash] : results.items()) {
+            if (!shared.contains(name)) {
+                shared[name] = hash;
+            } else if (shared[name] != hash) {
+                overrides[name] = hash;
+            }
+        }
+        golden["platforms"][platform] = overrides;
+
+        std::ofstream ofs(goldenPath);
+        if (!ofs) {
+            std::fprintf(stderr, "failed to open %s\n", goldenPath.c_str());
+            return 1;
+        }
+        ofs << golden.dump(2) << "\n";
+        std::printf("updated %s (%s)\n", goldenPath.c_str(), platform.c_str());
+    }
+    if (failures != 0) {
+        return 1;
+    }
+    // 期待値が無い環境で黙って通ると、ビルド間で結果が変わっても気づけないので SKIP として見えるようにする
+    return (!hasGolden && !update && requireGolden) ? kSkipExitCode : 0;
+}
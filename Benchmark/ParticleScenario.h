@@ -0,0 +1,208 @@
+#pragma once
+#include "MatrixMath.h"
+#include "ParticleSimulation.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// ===============================
+// ヘッドレスのパーティクル計測・テスト用の場面
+// ===============================
+// N グループ × M 粒子を K フレーム回す。エフェクトは resources/particles を真似た定義をここに埋め込む
+// （ゲーム側の JSON を調整しても、決定性テストの期待値が変わらないように）
+namespace bench {
+
+struct ParticleScenarioConfig {
+    uint32_t groups = 8;
+    // 1 グループあたりの生存数の目安（最初に一度に出し、以降は寿命で減る分を毎フレーム足す）
+    uint32_t particlesPerGroup = 4096;
+    uint32_t frames = 240;
+    uint64_t seed = 1;
+    // 0 ならメインスレッドだけ
+    uint32_t workers = 0;
+    // 60Hz の固定ステップ + 補間で回す（false なら毎フレーム deltaTime で 1 回）
+    bool fixedStep = false;
+    // 天候（雨）を予算の 5% ぶん回す
+    bool weather = true;
+};
+
+class ParticleScenario {
+public:
+    static constexpr float kDeltaTime = 1.0f / 60.0f;
+
+    explicit ParticleScenario(const ParticleScenarioConfig& config)
+        : config_(config)
+    {
+        // 予算で絞られないよう、天候を入れても余裕のある値にする
+        const uint32_t total = config.groups * config.particlesPerGroup;
+        simulation_.SetParticleBudget(total * 2 + 1024);
+        simulation_.SetMaxInstancesPerGroup(config.particlesPerGroup * 2);
+        simulation_.SetRandomSeed(config.seed);
+        simulation_.SetParallelUpdate(config.workers > 0);
+        simulation_.SetFixedTimeStep(config.fixedStep ? kDeltaTime : 0.0f);
+        simulation_.Initialize(config.workers);
+        simulation_.SetEffects(MakeEffects());
+        // ファイルは読まずに固定シードで焼く（どの環境でも同じ場）
+        simulation_.LoadTurbulenceField(std::string(), 0x7D3C0F1E);
+
+        // 地面と壁をいくつか
+        collision_.SetGround(0.0f);
+        for (int i = 0; i < 8; ++i) {
+            collision_.AddAABB({ -14.0f + 4.0f * static_cast<float>(i), 1.0f, 6.0f }, { 1.0f, 1.0f, 0.5f });
+        }
+        collision_.Build();
+        simulation_.SetCollisionWorld(&collision_);
+
+        static const char* const kEffects[] = { "spark", "smoke", "fire" };
+        for (uint32_t g = 0; g < config.groups; ++g) {
+            Group group;
+            group.name = "group" + std::to_string(g);
+            group.effect = kEffects[g % 3];
+            // 並べて置く（LOD・当たり判定の掛かり方がグループごとに違うように）
+            group.position = { -12.0f + 3.0f * static_cast<float>(g % 9), 0.5f + 0.25f * static_cast<float>(g % 4),
+                2.0f * static_cast<float>(g / 9) };
+            simulation_.CreateParticleGroup(group.name);
+            // 3 つに 1 つは奥→手前ソート（煙の想定）
+            if (g % 3 == 1) {
+                simulation_.SetSortMode(group.name, (g % 2 == 0) ? ParticleSortMode::Radix : ParticleSortMode::Incremental);
+            }
+            // 火花は跳ねる
+            if (g % 3 == 0) {
+                ParticleCollisionResponse response;
+                response.mode = ParticleCollisionMode::Bounce;
+                simulation_.SetCollision(group.name, response);
+            }
+            // 平均寿命（シミュレーション単位）から 1 フレームに足す数を決める
+            const ParticleEffect& effect = simulation_.GetEffect(group.effect);
+            const float lifeFrames = (effect.lifeTimeMin + effect.lifeTimeMax) * 0.5f
+                / (kDeltaTime * simulation_.GetTimeScale());
+            group.emitPerFrame = (std::max)(1u, static_cast<uint32_t>(static_cast<float>(config.particlesPerGroup) / lifeFrames));
+            groups_.push_back(group);
+        }
+        if (config.weather) {
+            simulation_.CreateParticleGroup("weather");
+            simulation_.SetWeather("weather", "rain", 0.05f);
+        }
+
+        // 場面の少し後ろ・上から見下ろす
+        view_.position = { 0.0f, 6.0f, -20.0f };
+        const Matrix4x4 viewMatrix = MatrixMath::MakeLookAtMatrix(view_.position, { 0.0f, 1.0f, 0.0f }, { 0.0f, 1.0f, 0.0f });
+        const Matrix4x4 projection = MatrixMath::MakePerspectiveFovMatrix(0.45f, 16.0f / 9.0f, 0.1f, 1000.0f);
+        view_.viewProjection = MatrixMath::Multiply(viewMatrix, projection);
+        view_.pixelsPerUnit = projection.m[1][1] * 720.0f * 0.5f;
+    }
+
+    // 1 フレーム（発生 → 更新）
+    void Step()
+    {
+        for (const Group& group : groups_) {
+            const uint32_t count = (frame_ == 0) ? config_.particlesPerGroup : group.emitPerFrame;
+            simulation_.Emit(group.name, group.effect, group.position, count);
+        }
+        simulation_.Update(kDeltaTime, view_);
+        ++frame_;
+    }
+
+    ParticleSimulation& GetSimulation() { return simulation_; }
+    uint32_t GetFrame() const { return frame_; }
+
+    // 今描く分のインスタンス数（全グループ）
+    uint32_t CountInstances() const
+    {
+        uint32_t count = 0;
+        for (const auto& [name, group] : simulation_.GetParticleGroups()) {
+            count += group.numInstance;
+        }
+        return count;
+    }
+
+    // インスタンスの中身のハッシュ（FNV-1a 64）。グループは名前順に並べて、map の走査順に依存しない
+    uint64_t HashInstances() const
+    {
+        std::vector<const std::string*> names;
+        for (const auto& [name, group] : simulation_.GetParticleGroups()) {
+            names.push_back(&name);
+        }
+        std::sort(names.begin(), names.end(), [](const std::string* a, const std::string* b) { return *a < *b; });
+
+        uint64_t hash = 0xCBF29CE484222325ull;
+        auto mix = [&hash](const void* data, size_t size) {
+            const uint8_t* bytes = static_cast<const uint8_t*>(data);
+            for (size_t i = 0; i < size; ++i) {
+                hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+            }
+        };
+        for (const std::string* name : names) {
+            const ParticleSimulation::ParticleGroup& group = simulation_.GetParticleGroup(*name);
+            mix(name->data(), name->size());
+            mix(&group.numInstance, sizeof(group.numInstance));
+            mix(group.instanceData, sizeof(ParticleSimulation::ParticleForGPU) * group.numInstance);
+        }
+        return hash;
+    }
+
+private:
+    struct Group {
+        std::string name;
+        std::string effect;
+        Vector3 position;
+        uint32_t emitPerFrame = 1;
+    };
+
+    static std::vector<ParticleEffect> MakeEffects()
+    {
+        static const char* const kJson[] = {
+            R"({ "name": "spark", "spawn": { "shape": "point" },
+                 "velocity": { "speed": { "min": 1.5, "max": 3.0 }, "min": { "x": 0, "y": 0.5, "z": 0 }, "max": { "x": 0, "y": 1.0, "z": 0 } },
+                 "lifeTime": { "min": 0.4, "max": 0.8 }, "scale": { "x": 0.08, "y": 0.08, "z": 0.08 },
+                 "gravity": { "x": 0, "y": -2.0, "z": 0 }, "drag": 1.0,
+                 "flipbook": { "columns": 4, "rows": 2, "frames": 8, "cycles": 2 },
+                 "colorOverLife": [ { "t": 0.0, "color": { "r": 1, "g": 1, "b": 0.8, "a": 1 } },
+                                    { "t": 1.0, "color": { "r": 1, "g": 0.3, "b": 0, "a": 0 } } ] })",
+            R"({ "name": "smoke", "spawn": { "shape": "sphere", "radius": 0.2 },
+                 "velocity": { "min": { "x": -0.05, "y": 0.2, "z": -0.05 }, "max": { "x": 0.05, "y": 0.4, "z": 0.05 } },
+                 "lifeTime": { "min": 1.5, "max": 2.5 }, "scale": { "x": 0.4, "y": 0.4, "z": 0.4 },
+                 "drag": 0.3, "turbulence": { "strength": 0.08, "frequency": 0.75 },
+                 "scaleOverLife": [ { "t": 0.0, "value": 0.5 }, { "t": 1.0, "value": 2.0 } ] })",
+            R"({ "name": "fire", "spawn": { "shape": "box", "extents": { "x": 0.1, "y": 0.0, "z": 0.1 } },
+                 "velocity": { "min": { "x": -0.01, "y": 0.3, "z": -0.01 }, "max": { "x": 0.01, "y": 0.6, "z": 0.01 } },
+                 "lifeTime": { "min": 0.5, "max": 1.0 }, "scale": { "x": 0.05, "y": 0.2, "z": 0.05 },
+                 "turbulence": { "strength": 0.15, "frequency": 2.0 } })",
+            R"({ "name": "rain", "spawn": { "shape": "box", "extents": { "x": 15, "y": 10, "z": 15 } },
+                 "velocity": { "min": { "x": -0.05, "y": -1.9, "z": -0.05 }, "max": { "x": 0.05, "y": -1.5, "z": 0.05 } },
+                 "lifeTime": { "min": 6.0, "max": 9.0 }, "scale": { "x": 0.02, "y": 0.35, "z": 1.0 } })",
+        };
+
+        std::vector<ParticleEffect> effects;
+        for (const char* text : kJson) {
+            ParticleEffect effect;
+            std::string error;
+            if (!ParticleEffectLoader::Parse(text, effect, &error)) {
+                std::fprintf(stderr, "ParticleScenario: %s\n", error.c_str());
+                std::exit(2);
+            }
+            effects.push_back(std::move(effect));
+        }
+
+        // フレーム表の先頭はゲームでは ParticleManager が埋める。ここでは定義順に並べる
+        uint32_t frameBase = 0;
+        for (ParticleEffect& effect : effects) {
+            effect.frameBase = frameBase;
+            frameBase += effect.frameCount;
+        }
+        return effects;
+    }
+
+private:
+    ParticleScenarioConfig config_;
+    ParticleSimulation simulation_;
+    ParticleCollisionWorld collision_;
+    ParticleSimulation::View view_ {};
+    std::vector<Group> groups_;
+    uint32_t frame_ = 0;
+};
+
+} // namespace bench
@@ -1,5 +1,6 @@
 #include "Camera.h"
 #include "DirectXCommon.h"
+#include "AffineMatrix.h"
 #include "../Game/Drone/Drone.h"
 
 Camera::Camera()
@@ -25,13 +26,14 @@ void Camera::Update() {
     assert(cameraData_ && "Camera::Initialize() is not called");
     cameraData_->worldPosition = transform_.translate;
 
-    worldMatrix_ = MatrixMath::MakeAffineMatrix(transform_.scale, transform_.rotate, transform_.translate);
+    const AffineMatrix worldAffine = AffineMath::MakeAffine(transform_.scale, transform_.rotate, transform_.translate);
+    worldMatrix_ = AffineMath::ToMatrix4x4(worldAffine);
 
     if (useCustomView_) {
         viewMatrix_ = customView_;                 // ★LookAtの結果を使う
     }
     else {
-        viewMatrix_ = MatrixMath::Inverse(worldMatrix_);
+        viewMatrix_ = AffineMath::ToMatrix4x4(AffineMath::InverseScaleRotate(worldAffine));
     }
 
     projectionMatrix_ = MatrixMath::MakePerspectiveFovMatrix(
@@ -0,0 +1,58 @@
+﻿#include "CompiledWalls.h"
+
+void CompiledWalls::Clear()
+{
+    center_.clear();
+    half_.clear();
+    bounds_.clear();
+    basis_.clear();
+    satIndex_.clear();
+    sat_.clear();
+    freeSat_.clear();
+}
+
+void CompiledWalls::Resize(uint32_t count)
+{
+    // 減らすときは消える壁の SAT 枠を空きに戻す
+    for (uint32_t i = count; i < Size(); ++i) {
+        if (satIndex_[i] >= 0) {
+            freeSat_.push_back(satIndex_[i]);
+        }
+    }
+    center_.resize(count);
+    half_.resize(count, { 1.0f, 1.0f, 1.0f });
+    bounds_.resize(count);
+    basis_.resize(count);
+    satIndex_.resize(count, -1);
+}
+
+void CompiledWalls::Compile(uint32_t index, bool isOBB, const Vector3& center, const Vector3& half, const Vector3& rot)
+{
+    center_[index] = center;
+    half_[index] = half;
+
+    if (!isOBB) {
+        bounds_[index] = MakeAABB_CenterHalf(center, half);
+        basis_[index] = Basis {};
+        if (satIndex_[index] >= 0) {
+            freeSat_.push_back(satIndex_[index]);
+            satIndex_[index] = -1;
+        }
+        return;
+    }
+
+    Basis& basis = basis_[index];
+    MakeBasisFromEuler_LikeObject3d(rot, basis.axis[0], basis.axis[1], basis.axis[2]);
+    bounds_[index] = MakeAABB_OBB(center, half, basis.axis);
+
+    if (satIndex_[index] < 0) {
+        if (!freeSat_.empty()) {
+            satIndex_[index] = freeSat_.back();
+            freeSat_.pop_back();
+        } else {
+            satIndex_[index] = static_cast<int32_t>(sat_.size());
+            sat_.emplace_back();
+        }
+    }
+    BuildOBBSatAxes(half, basis.axis, sat_[satIndex_[index]]);
+}
@@ -0,0 +1,58 @@
+﻿#pragma once
+#include <cstdint>
+#include <vector>
+#include "WallCollision.h"
+
+// ===============================
+// 当たり判定用に焼いた壁（SoA）
+// ===============================
+// エディタが触る WallSystem::Wall（中心・半径・Euler 角）とは別に、問い合わせでそのまま使える形を持つ
+//   bounds : ワールド AABB（BVH の葉と AABB 壁の判定にそのまま使う）
+//   basis  : OBB のローカル軸（パーティクルの当たり判定やデバッグ用）
+//   sat    : 正規化済みの SAT 軸と投影半径（OBB 壁だけ。satIndex で引く）
+// 壁が変わったときに Compile で 1 枚ずつ作り直し、1 回の判定では Euler → 軸も交差軸の正規化もしない
+// D3D に依存しないのでベンチマークからも使える
+class CompiledWalls {
+public:
+    struct Basis {
+        Vector3 axis[3] = { { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } };
+    };
+
+    void Clear();
+
+    // 枚数を合わせる（中身は Compile で埋める）
+    void Resize(uint32_t count);
+
+    // 壁 index を作り直す。isOBB が false なら rot は見ない
+    void Compile(uint32_t index, bool isOBB, const Vector3& center, const Vector3& half, const Vector3& rot);
+
+    uint32_t Size() const { return static_cast<uint32_t>(bounds_.size()); }
+    bool IsOBB(uint32_t index) const { return satIndex_[index] >= 0; }
+    const std::vector<AABB3>& Bounds() const { return bounds_; }
+    const Vector3& Center(uint32_t index) const { return center_[index]; }
+    const Vector3& Half(uint32_t index) const { return half_[index]; }
+    const Basis& GetBasis(uint32_t index) const { return basis_[index]; }
+
+    // AABB 壁: ドローンの箱と最小押し戻し
+    bool ResolveAABB(uint32_t index, const AABB3& droneBox, Vector3& outPush) const
+    {
+        return ResolveAABB_vs_AABB_MinPush(droneBox, bounds_[index], outPush);
+    }
+
+    // OBB 壁: 焼いておいた SAT 軸で最小押し戻し
+    bool ResolveOBB(uint32_t index, const Vector3& aabbCenter, const Vector3& aabbHalf, Vector3& outPush) const
+    {
+        return ResolveAABB_vs_OBB_MinPush(aabbCenter, aabbHalf, center_[index], sat_[satIndex_[index]], outPush);
+    }
+
+private:
+    std::vector<Vector3> center_;
+    std::vector<Vector3> half_;
+    std::vector<AABB3> bounds_;
+    std::vector<Basis> basis_;
+    // OBB 壁なら sat_ の番号、AABB 壁なら -1
+    std::vector<int32_t> satIndex_;
+    std::vector<OBBSatAxes> sat_;
+    // OBB から AABB に変わった壁が残した sat_ の空き
+    std::vector<int32_t> freeSat_;
+};
@@ -44,6 +44,8 @@ public:
 	void SetPos(const Vector3& p) { pos_ = p; }
 	void SetVel(const Vector3& v) { vel_ = v; }
 	const Vector3& GetVel() const { return vel_; }
+	// 地面の高さ（機体の中心がこれより下に行かない）
+	float GetMinY() const { return minY_; }
 	void SetYaw(float y) { yaw_ = y; }
 
 	bool HasJustLanded() const;
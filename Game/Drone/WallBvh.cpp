@@ -0,0 +1,307 @@
+﻿#include "WallBvh.h"
+
+#include <algorithm>
+
+namespace {
+
+// 表面積の半分（SAH の比較にしか使わないので 2 倍は省く）
+float HalfArea(const AABB3& a)
+{
+    const float x = a.max.x - a.min.x;
+    const float y = a.max.y - a.min.y;
+    const float z = a.max.z - a.min.z;
+    return x * y + y * z + z * x;
+}
+
+} // namespace
+
+#pragma region 組み立て
+void WallBvh::Clear()
+{
+    nodes_.clear();
+    leafOfItem_.clear();
+    root_ = -1;
+    freeList_ = -1;
+}
+
+void WallBvh::Build(const std::vector<AABB3>& bounds)
+{
+    Clear();
+    const uint32_t count = static_cast<uint32_t>(bounds.size());
+    leafOfItem_.assign(count, -1);
+    if (count == 0) {
+        return;
+    }
+
+    // 葉 n 個の二分木は節点 2n-1 個
+    nodes_.reserve(static_cast<size_t>(count) * 2);
+    std::vector<uint32_t> items(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        items[i] = i;
+    }
+    root_ = BuildRange(items.data(), count, bounds, -1);
+}
+
+int32_t WallBvh::BuildRange(uint32_t* items, uint32_t count, const std::vector<AABB3>& bounds, int32_t parent)
+{
+    const int32_t node = AllocateNode();
+    nodes_[node].parent = parent;
+
+    if (count == 1) {
+        nodes_[node].box = bounds[items[0]];
+        nodes_[node].item = static_cast<int32_t>(items[0]);
+        leafOfItem_[items[0]] = node;
+        return node;
+    }
+
+    // 重心の広がりが一番大きい軸で、重心の中央値を境に半分ずつ
+    AABB3 centroids { CenterOf(bounds[items[0]]), CenterOf(bounds[items[0]]) };
+    for (uint32_t i = 1; i < count; ++i) {
+        const Vector3 c = CenterOf(bounds[items[i]]);
+        centroids = UnionAABB(centroids, { c, c });
+    }
+    const Vector3 extent = V3Sub(centroids.max, centroids.min);
+    int axis = 0;
+    if (extent.y > extent.x) {
+        axis = 1;
+    }
+    if (extent.z > (axis == 0 ? extent.x : extent.y)) {
+        axis = 2;
+    }
+    auto key = [&bounds, axis](uint32_t item) {
+        const Vector3 c = CenterOf(bounds[item]);
+        return (axis == 0) ? c.x : (axis == 1) ? c.y : c.z;
+    };
+    const uint32_t half = count / 2;
+    std::nth_element(items, items + half, items + count, [&key](uint32_t a, uint32_t b) {
+        // 重心が同じ壁も並びが決まるように番号で比べる
+        const float ka = key(a);
+        const float kb = key(b);
+        return (ka != kb) ? ka < kb : a < b;
+    });
+
+    // 子を作る途中で nodes_ が伸びるので、参照は持たずに番号で書く
+    const int32_t left = BuildRange(items, half, bounds, node);
+    const int32_t right = BuildRange(items + half, count - half, bounds, node);
+    nodes_[node].child[0] = left;
+    nodes_[node].child[1] = right;
+    nodes_[node].box = UnionAABB(nodes_[left].box, nodes_[right].box);
+    nodes_[node].height = 1 + (std::max)(nodes_[left].height, nodes_[right].height);
+    return node;
+}
+
+int32_t WallBvh::AllocateNode()
+{
+    if (freeList_ >= 0) {
+        const int32_t node = freeList_;
+        freeList_ = nodes_[node].child[0];
+        nodes_[node] = Node {};
+        return node;
+    }
+    nodes_.push_back(Node {});
+    return static_cast<int32_t>(nodes_.size()) - 1;
+}
+
+void WallBvh::FreeNode(int32_t node)
+{
+    nodes_[node] = Node {};
+    nodes_[node].child[0] = freeList_;
+    nodes_[node].height = -1;
+    freeList_ = node;
+}
+#pragma endregion
+
+#pragma region 差分の更新
+void WallBvh::Insert(uint32_t item, const AABB3& bounds)
+{
+    if (item >= leafOfItem_.size()) {
+        leafOfItem_.resize(item + 1, -1);
+    }
+    const int32_t leaf = AllocateNode();
+    nodes_[leaf].box = bounds;
+    nodes_[leaf].item = static_cast<int32_t>(item);
+    leafOfItem_[item] = leaf;
+    InsertLeaf(leaf);
+}
+
+void WallBvh::Update(uint32_t item, const AABB3& bounds)
+{
+    if (item >= leafOfItem_.size() || leafOfItem_[item] < 0) {
+        Insert(item, bounds);
+        return;
+    }
+    const int32_t leaf = leafOfItem_[item];
+    nodes_[leaf].box = bounds;
+
+    // 親の箱に収まっていれば木の形はそのままで良い（祖先の箱を詰め直すだけ）
+    const int32_t parent = nodes_[leaf].parent;
+    if (parent < 0 || ContainsAABB(nodes_[parent].box, bounds)) {
+        RefitUpward(parent);
+        return;
+    }
+    RemoveLeaf(leaf);
+    InsertLeaf(leaf);
+}
+
+void WallBvh::InsertLeaf(int32_t leaf)
+{
+    if (root_ < 0) {
+        root_ = leaf;
+        nodes_[leaf].parent = -1;
+        return;
+    }
+
+    // 箱の広がり（表面積の増え方）が少ない方へ降りて、兄弟になる節点を探す
+    const AABB3 box = nodes_[leaf].box;
+    int32_t sibling = root_;
+    while (!nodes_[sibling].IsLeaf()) {
+        const Node& node = nodes_[sibling];
+        const float area = HalfArea(node.box);
+        const float combined = HalfArea(UnionAABB(node.box, box));
+        // ここで兄弟にする場合と、下に降りる場合の増え方を比べる
+        const float costHere = 2.0f * combined;
+        const float inherited = 2.0f * (combined - area);
+        float costChild[2];
+        for (int c = 0; c < 2; ++c) {
+            const Node& child = nodes_[node.child[c]];
+            const float grown = HalfArea(UnionAABB(child.box, box));
+            costChild[c] = child.IsLeaf() ? grown + inherited : (grown - HalfArea(child.box)) + inherited;
+        }
+        if (costHere < costChild[0] && costHere < costChild[1]) {
+            break;
+        }
+        sibling = (costChild[0] <= costChild[1]) ? node.child[0] : node.child[1];
+    }
+
+    // 兄弟と新しい葉をまとめる節点を作って差し込む
+    const int32_t oldParent = nodes_[sibling].parent;
+    const int32_t newParent = AllocateNode();
+    nodes_[newParent].parent = oldParent;
+    nodes_[newParent].child[0] = sibling;
+    nodes_[newParent].child[1] = leaf;
+    nodes_[sibling].parent = newParent;
+    nodes_[leaf].parent = newParent;
+    if (oldParent < 0) {
+        root_ = newParent;
+    } else {
+        Node& parent = nodes_[oldParent];
+        parent.child[(parent.child[0] == sibling) ? 0 : 1] = newParent;
+    }
+    RefitUpward(newParent);
+}
+
+void WallBvh::RemoveLeaf(int32_t leaf)
+{
+    const int32_t parent = nodes_[leaf].parent;
+    if (parent < 0) {
+        root_ = -1;
+        return;
+    }
+
+    // 親を消して、残った兄弟を祖父につなぎ替える
+    const int32_t grandParent = nodes_[parent].parent;
+    const int32_t sibling = (nodes_[parent].child[0] == leaf) ? nodes_[parent].child[1] : nodes_[parent].child[0];
+    nodes_[sibling].parent = grandParent;
+    if (grandParent < 0) {
+        root_ = sibling;
+    } else {
+        Node& node = nodes_[grandParent];
+        node.child[(node.child[0] == parent) ? 0 : 1] = sibling;
+    }
+    FreeNode(parent);
+    nodes_[leaf].parent = -1;
+    RefitUpward(grandParent);
+}
+
+void WallBvh::RefitUpward(int32_t node)
+{
+    while (node >= 0) {
+        node = Balance(node);
+        Node& n = nodes_[node];
+        const Node& a = nodes_[n.child[0]];
+        const Node& b = nodes_[n.child[1]];
+        n.box = UnionAABB(a.box, b.box);
+        n.height = 1 + (std::max)(a.height, b.height);
+        node = n.parent;
+    }
+}
+
+int32_t WallBvh::Balance(int32_t a)
+{
+    if (nodes_[a].IsLeaf() || nodes_[a].height < 2) {
+        return a;
+    }
+    const int32_t b = nodes_[a].child[0];
+    const int32_t c = nodes_[a].child[1];
+    const int32_t balance = nodes_[c].height - nodes_[b].height;
+    if (balance >= -1 && balance <= 1) {
+        return a;
+    }
+
+    // 高い方の子 up を a の位置に上げる
+    // a は「低い方の子 other」と「up の子のうち低い方 low」をまとめる節点になって up の下に入り、
+    // up のもう片方の子 tall はそのまま up の子に残る
+    const int upSide = (balance > 1) ? 1 : 0;
+    const int32_t up = nodes_[a].child[upSide];
+    const int32_t other = nodes_[a].child[1 - upSide];
+    const int32_t f = nodes_[up].child[0];
+    const int32_t g = nodes_[up].child[1];
+    const int32_t tall = (nodes_[f].height > nodes_[g].height) ? f : g;
+    const int32_t low = (tall == f) ? g : f;
+
+    const int32_t parent = nodes_[a].parent;
+    nodes_[up].parent = parent;
+    if (parent < 0) {
+        root_ = up;
+    } else {
+        Node& p = nodes_[parent];
+        p.child[(p.child[0] == a) ? 0 : 1] = up;
+    }
+
+    nodes_[a].child[upSide] = low;
+    nodes_[low].parent = a;
+    nodes_[a].parent = up;
+    nodes_[a].box = UnionAABB(nodes_[other].box, nodes_[low].box);
+    nodes_[a].height = 1 + (std::max)(nodes_[other].height, nodes_[low].height);
+
+    nodes_[up].child[0] = a;
+    nodes_[up].child[1] = tall;
+    nodes_[up].box = UnionAABB(nodes_[a].box, nodes_[tall].box);
+    nodes_[up].height = 1 + (std::max)(nodes_[a].height, nodes_[tall].height);
+    return up;
+}
+
+bool WallBvh::NeedsRebuild() const
+{
+    // 中央値分割なら高さはほぼ log2(n)。その倍 + 余裕を超えたら崩れたとみなす
+    uint32_t log2 = 0;
+    while ((1u << log2) < GetItemCount() && log2 < 31) {
+        ++log2;
+    }
+    return GetHeight() > static_cast<int32_t>(2 * log2 + 8);
+}
+#pragma endregion
+
+#pragma region 問い合わせ
+void WallBvh::Query(const AABB3& box, std::vector<uint32_t>& out) const
+{
+    if (root_ < 0) {
+        return;
+    }
+    stack_.clear();
+    stack_.push_back(root_);
+    while (!stack_.empty()) {
+        const Node& node = nodes_[stack_.back()];
+        stack_.pop_back();
+        if (!IntersectAABB(node.box, box)) {
+            continue;
+        }
+        if (node.IsLeaf()) {
+            out.push_back(static_cast<uint32_t>(node.item));
+        } else {
+            stack_.push_back(node.child[0]);
+            stack_.push_back(node.child[1]);
+        }
+    }
+}
+#pragma endregion
@@ -0,0 +1,70 @@
+﻿#pragma once
+#include <cstdint>
+#include <vector>
+#include "WallCollision.h"
+
+// ===============================
+// 壁のブロードフェーズ（AABB の BVH）
+// ===============================
+// 壁 1 枚を葉 1 つにした二分木。ステージを読んだら Build で一括で組み（重心の中央値で分割）、
+// 後から壁が増えた・動いたときは Insert / Update で葉からルートまでの箱だけ直す
+// 問い合わせは箱と重なる枝だけ辿るので、壁が数千枚でも narrow phase に回るのは近くの数枚
+// D3D に依存しないのでベンチマークからも使える
+class WallBvh {
+public:
+    void Clear();
+
+    // bounds[i] を壁 i の箱として一から組み直す
+    void Build(const std::vector<AABB3>& bounds);
+
+    // 壁 item を足す（item は今の壁数と同じ番号 = 末尾への追加）
+    void Insert(uint32_t item, const AABB3& bounds);
+
+    // 壁 item の箱が変わった
+    // 親の箱に収まる程度の移動なら箱を直すだけ、大きく動いたら葉を外して入れ直す
+    // 足し直しのたびに回転で高さをそろえるので、編集を続けても木は偏らない
+    void Update(uint32_t item, const AABB3& bounds);
+
+    // box と重なる壁の番号を out に足す（順番は木を辿った順。並びが要るなら呼ぶ側で並べる）
+    void Query(const AABB3& box, std::vector<uint32_t>& out) const;
+
+    uint32_t GetItemCount() const { return static_cast<uint32_t>(leafOfItem_.size()); }
+    int32_t GetHeight() const { return (root_ < 0) ? 0 : nodes_[root_].height; }
+
+    // 足し直しが続いて、一括で組んだ場合よりかなり深くなった（作り直した方が速い）
+    bool NeedsRebuild() const;
+
+private:
+    struct Node {
+        AABB3 box {};
+        int32_t parent = -1;
+        int32_t child[2] = { -1, -1 };
+        // 葉なら壁の番号、内部節点なら -1
+        int32_t item = -1;
+        // 葉が 0
+        int32_t height = 0;
+
+        bool IsLeaf() const { return item >= 0; }
+    };
+
+    int32_t AllocateNode();
+    void FreeNode(int32_t node);
+    int32_t BuildRange(uint32_t* items, uint32_t count, const std::vector<AABB3>& bounds, int32_t parent);
+    void InsertLeaf(int32_t leaf);
+    void RemoveLeaf(int32_t leaf);
+    // node から上へ箱と高さを直す（途中で左右の高さが 2 以上ずれていたら回転で戻す）
+    void RefitUpward(int32_t node);
+    // 左右の高さをそろえる（AVL の回転）。node の位置に来た節点を返す
+    int32_t Balance(int32_t node);
+
+private:
+    std::vector<Node> nodes_;
+    // 壁の番号 → 葉の節点
+    std::vector<int32_t> leafOfItem_;
+    int32_t root_ = -1;
+    // 空き節点の連結リスト（child[0] でつなぐ）
+    int32_t freeList_ = -1;
+
+    // Query の作業用（毎回確保しないように持っておく）
+    mutable std::vector<int32_t> stack_;
+};
@@ -0,0 +1,225 @@
+﻿#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+#include "MathStruct.h" // Vector3
+#include "Quaternion.h"
+
+// 壁の当たり判定（SAT）まわり
+// D3D に依存しないので、Walls.h 以外（ベンチマーク等）からも単体で使える
+
+// ========================
+// Minimal math helpers
+// ========================
+static inline Vector3 V3Add(const Vector3& a, const Vector3& b) { return { a.x + b.x, a.y + b.y, a.z + b.z }; }
+static inline Vector3 V3Sub(const Vector3& a, const Vector3& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+static inline Vector3 V3Mul(const Vector3& a, float s) { return { a.x * s, a.y * s, a.z * s }; }
+static inline float   V3Dot(const Vector3& a, const Vector3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+static inline float   V3Len(const Vector3& v) { return std::sqrt(V3Dot(v, v)); }
+static inline Vector3 V3Norm(const Vector3& v) {
+    float l = V3Len(v);
+    if (l < 1e-6f) return { 0,0,0 };
+    return { v.x / l, v.y / l, v.z / l };
+}
+static inline Vector3 V3Abs(const Vector3& v) { return { std::abs(v.x), std::abs(v.y), std::abs(v.z) }; }
+static inline float   Clamp(float v, float a, float b) { return std::clamp(v, a, b); }
+
+// ========================
+// Shapes
+// ========================
+struct AABB3 {
+    Vector3 min;
+    Vector3 max;
+};
+
+static inline AABB3 MakeAABB_CenterHalf(const Vector3& c, const Vector3& half) {
+    return { {c.x - half.x, c.y - half.y, c.z - half.z},
+             {c.x + half.x, c.y + half.y, c.z + half.z} };
+}
+
+static inline bool IntersectAABB(const AABB3& a, const AABB3& b) {
+    return (a.min.x <= b.max.x && a.max.x >= b.min.x) &&
+        (a.min.y <= b.max.y && a.max.y >= b.min.y) &&
+        (a.min.z <= b.max.z && a.max.z >= b.min.z);
+}
+
+static inline Vector3 CenterOf(const AABB3& a) {
+    return { (a.min.x + a.max.x) * 0.5f, (a.min.y + a.max.y) * 0.5f, (a.min.z + a.max.z) * 0.5f };
+}
+
+static inline AABB3 UnionAABB(const AABB3& a, const AABB3& b) {
+    return { { (std::min)(a.min.x, b.min.x), (std::min)(a.min.y, b.min.y), (std::min)(a.min.z, b.min.z) },
+             { (std::max)(a.max.x, b.max.x), (std::max)(a.max.y, b.max.y), (std::max)(a.max.z, b.max.z) } };
+}
+
+// inner が outer に丸ごと入っているか
+static inline bool ContainsAABB(const AABB3& outer, const AABB3& inner) {
+    return (outer.min.x <= inner.min.x && outer.max.x >= inner.max.x) &&
+        (outer.min.y <= inner.min.y && outer.max.y >= inner.max.y) &&
+        (outer.min.z <= inner.min.z && outer.max.z >= inner.max.z);
+}
+
+// ========================
+// OBB (oriented box)
+// rot: Euler(rad) (pitch, yaw, roll) として扱う
+// basis: ローカル軸 (x,y,z) をワールドに向けた単位ベクトル
+// ========================
+struct OBB {
+    Vector3 center{ 0,0,0 };
+    Vector3 half{ 1,1,1 };
+    Vector3 rot{ 0,0,0 }; // rad
+};
+
+// Euler -> basis (XYZ回転順で1つに固定)
+// Object3d と同じ向き（MakeAffineMatrix の Rx*Ry*Rz）をクォータニオン経由で作る
+// 行列を組まないので sin/cos は 3 組だけ、結果は最初から正規直交
+static inline void MakeBasisFromEuler_LikeObject3d(
+    const Vector3& rot,
+    Vector3& outX, Vector3& outY, Vector3& outZ) {
+    QuaternionMath::ToBasis(QuaternionMath::FromEulerXYZ(rot), outX, outY, outZ);
+}
+
+// OBB を包むワールド AABB（各軸の |軸| * half を足した広がり）
+static inline AABB3 MakeAABB_OBB(const Vector3& center, const Vector3& half, const Vector3 (&basis)[3]) {
+    const Vector3 ax = V3Abs(basis[0]);
+    const Vector3 ay = V3Abs(basis[1]);
+    const Vector3 az = V3Abs(basis[2]);
+    const Vector3 extent{
+        ax.x * half.x + ay.x * half.y + az.x * half.z,
+        ax.y * half.x + ay.y * half.y + az.y * half.z,
+        ax.z * half.x + ay.z * half.y + az.z * half.z };
+    return MakeAABB_CenterHalf(center, extent);
+}
+
+// OBB の SAT 軸を前もって作っておいたもの（壁が変わったときだけ作り直す）
+// 15軸: 3(OBB) + 3(World) + 9(cross)。長さがほぼ 0 の交差軸（ワールド軸と平行な OBB 軸との交差）は除いてある
+// n: 正規化済みの軸、radius: その軸への OBB の投影半径 sum(half_i * |dot(basis_i, n)|)
+struct OBBSatAxes {
+    Vector3 n[15];
+    float radius[15];
+    int count = 0;
+};
+
+static inline void BuildOBBSatAxes(const Vector3& half, const Vector3 (&basis)[3], OBBSatAxes& out) {
+    const Vector3& Ax = basis[0];
+    const Vector3& Ay = basis[1];
+    const Vector3& Az = basis[2];
+
+    // ワールド軸
+    const Vector3 Wx{ 1,0,0 };
+    const Vector3 Wy{ 0,1,0 };
+    const Vector3 Wz{ 0,0,1 };
+
+    Vector3 axes[15] = {
+        Ax, Ay, Az,
+        Wx, Wy, Wz,
+        // cross
+        {0,0,0},{0,0,0},{0,0,0},
+        {0,0,0},{0,0,0},{0,0,0},
+        {0,0,0},{0,0,0},{0,0,0},
+    };
+    int idx = 6;
+    auto Cross = [](const Vector3& a, const Vector3& b)->Vector3 {
+        return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+        };
+    const Vector3 A[3] = { Ax, Ay, Az };
+    const Vector3 W[3] = { Wx, Wy, Wz };
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            axes[idx++] = Cross(A[i], W[j]);
+        }
+    }
+
+    out.count = 0;
+    for (int i = 0; i < 15; ++i) {
+        const float len = V3Len(axes[i]);
+        if (len < 1e-6f) continue; // 軸が無効ならスキップ
+        const Vector3 n = V3Mul(axes[i], 1.0f / len);
+        out.n[out.count] = n;
+        out.radius[out.count] = half.x * std::abs(V3Dot(Ax, n)) +
+            half.y * std::abs(V3Dot(Ay, n)) +
+            half.z * std::abs(V3Dot(Az, n));
+        ++out.count;
+    }
+}
+
+// AABB(ドローン) vs OBB(壁) を SAT で解決（最小押し戻しMTV）
+// 返り値: ぶつかってたら true, outPush に押し戻しベクトル
+// sat: BuildOBBSatAxes で作っておいた軸。1 回の判定でやるのは内積と比較だけ
+static inline bool ResolveAABB_vs_OBB_MinPush(
+    const Vector3& aabbCenter, const Vector3& aabbHalf,
+    const Vector3& obbCenter, const OBBSatAxes& sat,
+    Vector3& outPush
+) {
+    // AABB中心 -> OBB中心
+    const Vector3 D = V3Sub(aabbCenter, obbCenter);
+
+    float minOverlap = FLT_MAX;
+    Vector3 minAxis{ 0,0,0 };
+
+    for (int i = 0; i < sat.count; ++i) {
+        const Vector3& n = sat.n[i];
+        const float dist = std::abs(V3Dot(D, n));
+        // AABB half をワールド軸で持つので: r = sum(half_i * |n_i|)
+        const float ra = aabbHalf.x * std::abs(n.x) + aabbHalf.y * std::abs(n.y) + aabbHalf.z * std::abs(n.z);
+        const float overlap = (ra + sat.radius[i]) - dist;
+
+        if (overlap < 0.0f) return false; // 分離
+
+        if (overlap < minOverlap) {
+            minOverlap = overlap;
+            minAxis = n;
+        }
+    }
+
+    // 押す向きを決める（Dと逆なら反転）
+    if (V3Dot(D, minAxis) < 0.0f) {
+        minAxis = V3Mul(minAxis, -1.0f);
+    }
+
+    outPush = V3Mul(minAxis, minOverlap);
+    return true;
+}
+
+// basis: 事前に計算済みの OBB ローカル軸（CachedOrientation::axis など）
+// 軸はその場で作る。何度も同じ壁を調べるなら OBBSatAxes を持っておく方が速い
+static inline bool ResolveAABB_vs_OBB_MinPush(
+    const Vector3& aabbCenter, const Vector3& aabbHalf,
+    const OBB& obb, const Vector3 (&basis)[3],
+    Vector3& outPush
+) {
+    OBBSatAxes sat;
+    BuildOBBSatAxes(obb.half, basis, sat);
+    return ResolveAABB_vs_OBB_MinPush(aabbCenter, aabbHalf, obb.center, sat, outPush);
+}
+
+// obb.rot から毎回軸を作る版
+static inline bool ResolveAABB_vs_OBB_MinPush(
+    const Vector3& aabbCenter, const Vector3& aabbHalf,
+    const OBB& obb,
+    Vector3& outPush
+) {
+    Vector3 basis[3];
+    MakeBasisFromEuler_LikeObject3d(obb.rot, basis[0], basis[1], basis[2]);
+    return ResolveAABB_vs_OBB_MinPush(aabbCenter, aabbHalf, obb, basis, outPush);
+}
+
+// AABB vs AABB の最小押し戻し
+static inline bool ResolveAABB_vs_AABB_MinPush(const AABB3& moving, const AABB3& solid, Vector3& outPush)
+{
+    if (!IntersectAABB(moving, solid)) return false;
+
+    const Vector3 ca = CenterOf(moving);
+    const Vector3 cb = CenterOf(solid);
+
+    const float ox = std::min<float>(moving.max.x, solid.max.x) - std::max<float>(moving.min.x, solid.min.x);
+    const float oy = std::min<float>(moving.max.y, solid.max.y) - std::max<float>(moving.min.y, solid.min.y);
+    const float oz = std::min<float>(moving.max.z, solid.max.z) - std::max<float>(moving.min.z, solid.min.z);
+
+    outPush = { 0,0,0 };
+    if (ox <= oy && ox <= oz) outPush.x = (ca.x < cb.x) ? -ox : +ox;
+    else if (oy <= ox && oy <= oz) outPush.y = (ca.y < cb.y) ? -oy : +oy;
+    else outPush.z = (ca.z < cb.z) ? -oz : +oz;
+
+    return true;
+}
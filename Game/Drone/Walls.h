@@ -4,189 +4,13 @@
 #include <cmath>
 #include <cfloat>
 #include <memory>
-#include "MathStruct.h" // Vector3
+#include "WallCollision.h"
+#include "WallBvh.h"
+#include "CompiledWalls.h"
+#include "ParticleCollision.h"
 #include "Object3d.h"
 #include "Object3dManager.h"
 
-// ========================
-// Minimal math helpers
-// ========================
-static inline Vector3 V3Add(const Vector3& a, const Vector3& b) { return { a.x + b.x, a.y + b.y, a.z + b.z }; }
-static inline Vector3 V3Sub(const Vector3& a, const Vector3& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
-static inline Vector3 V3Mul(const Vector3& a, float s) { return { a.x * s, a.y * s, a.z * s }; }
-static inline float   V3Dot(const Vector3& a, const Vector3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
-static inline float   V3Len(const Vector3& v) { return std::sqrt(V3Dot(v, v)); }
-static inline Vector3 V3Norm(const Vector3& v) {
-    float l = V3Len(v);
-    if (l < 1e-6f) return { 0,0,0 };
-    return { v.x / l, v.y / l, v.z / l };
-}
-static inline Vector3 V3Abs(const Vector3& v) { return { std::abs(v.x), std::abs(v.y), std::abs(v.z) }; }
-static inline float   Clamp(float v, float a, float b) { return std::clamp(v, a, b); }
-
-// ========================
-// Shapes
-// ========================
-struct AABB3 {
-    Vector3 min;
-    Vector3 max;
-};
-
-static inline AABB3 MakeAABB_CenterHalf(const Vector3& c, const Vector3& half) {
-    return { {c.x - half.x, c.y - half.y, c.z - half.z},
-             {c.x + half.x, c.y + half.y, c.z + half.z} };
-}
-
-static inline bool IntersectAABB(const AABB3& a, const AABB3& b) {
-    return (a.min.x <= b.max.x && a.max.x >= b.min.x) &&
-        (a.min.y <= b.max.y && a.max.y >= b.min.y) &&
-        (a.min.z <= b.max.z && a.max.z >= b.min.z);
-}
-
-static inline Vector3 CenterOf(const AABB3& a) {
-    return { (a.min.x + a.max.x) * 0.5f, (a.min.y + a.max.y) * 0.5f, (a.min.z + a.max.z) * 0.5f };
-}
-
-// ========================
-// OBB (oriented box)
-// rot: Euler(rad) (pitch, yaw, roll) として扱う
-// basis: ローカル軸 (x,y,z) をワールドに向けた単位ベクトル
-// ========================
-struct OBB {
-    Vector3 center{ 0,0,0 };
-    Vector3 half{ 1,1,1 };
-    Vector3 rot{ 0,0,0 }; // rad
-};
-
-// Euler -> basis (XYZ回転順で1つに固定)
-// ※あなたのエンジン側で行列があるならそれに置き換えてOK
-static inline void MakeBasisFromEuler_LikeObject3d(
-    const Vector3& rot,
-    Vector3& outX, Vector3& outY, Vector3& outZ) {
-    // Object3d と同じ回転生成に合わせる（scale=1, translate=0）
-    Matrix4x4 m = MatrixMath::MakeAffineMatrix({ 1,1,1 }, rot, { 0,0,0 });
-
-    // ★row-vector運用なら「行(row)がローカル軸」になってることが多い
-    outX = V3Norm({ m.m[0][0], m.m[0][1], m.m[0][2] }); // local X (Right)
-    outY = V3Norm({ m.m[1][0], m.m[1][1], m.m[1][2] }); // local Y (Up)
-    outZ = V3Norm({ m.m[2][0], m.m[2][1], m.m[2][2] }); // local Z (Forward)
-}
-
-
-// AABB(ドローン) vs OBB(壁) を SAT で解決（最小押し戻しMTV）
-// 返り値: ぶつかってたら true, outPush に押し戻しベクトル
-static inline bool ResolveAABB_vs_OBB_MinPush(
-    const Vector3& aabbCenter, const Vector3& aabbHalf,
-    const OBB& obb,
-    Vector3& outPush
-) {
-    // AABB を「OBB座標系」に持っていって、OBB(軸平行) vs AABB(軸平行) に近い形で解く
-    // SAT：テスト軸は obbの3軸 + worldの3軸（+ crossは厳密には必要）
-    // ここでは “壁”用途として安定を優先して「15軸SAT(交差軸も含む)」を入れます。
-
-    Vector3 Ax, Ay, Az;
-    MakeBasisFromEuler_LikeObject3d(obb.rot, Ax, Ay, Az);
-
-    // ワールド軸
-    const Vector3 Wx{ 1,0,0 };
-    const Vector3 Wy{ 0,1,0 };
-    const Vector3 Wz{ 0,0,1 };
-
-    // AABB中心 -> OBB中心
-    const Vector3 D = V3Sub(aabbCenter, obb.center);
-
-    auto ProjectRadiusAABB_OnAxis = [&](const Vector3& axis)->float {
-        // AABB half をワールド軸で持つので: r = sum(half_i * |dot(worldAxis_i, axis)|)
-        return aabbHalf.x * std::abs(V3Dot(Wx, axis)) +
-            aabbHalf.y * std::abs(V3Dot(Wy, axis)) +
-            aabbHalf.z * std::abs(V3Dot(Wz, axis));
-        };
-
-    auto ProjectRadiusOBB_OnAxis = [&](const Vector3& axis)->float {
-        // OBB half と basis から: r = sum(half_i * |dot(basis_i, axis)|)
-        return obb.half.x * std::abs(V3Dot(Ax, axis)) +
-            obb.half.y * std::abs(V3Dot(Ay, axis)) +
-            obb.half.z * std::abs(V3Dot(Az, axis));
-        };
-
-    auto TestAxis = [&](const Vector3& axis, float& outMinOverlap, Vector3& outMinAxis)->bool {
-        const float len = V3Len(axis);
-        if (len < 1e-6f) return true; // 軸が無効ならスキップ
-        const Vector3 n = V3Mul(axis, 1.0f / len);
-
-        const float dist = std::abs(V3Dot(D, n));
-        const float ra = ProjectRadiusAABB_OnAxis(n);
-        const float rb = ProjectRadiusOBB_OnAxis(n);
-        const float overlap = (ra + rb) - dist;
-
-        if (overlap < 0.0f) return false; // 分離
-
-        if (overlap < outMinOverlap) {
-            outMinOverlap = overlap;
-            outMinAxis = n;
-        }
-        return true;
-        };
-
-    float minOverlap = FLT_MAX;
-    Vector3 minAxis{ 0,0,0 };
-
-    // 15軸: 3(OBB) + 3(World) + 9(cross)
-    Vector3 axes[15] = {
-        Ax, Ay, Az,
-        Wx, Wy, Wz,
-        // cross
-        {0,0,0},{0,0,0},{0,0,0},
-        {0,0,0},{0,0,0},{0,0,0},
-        {0,0,0},{0,0,0},{0,0,0},
-    };
-    int idx = 6;
-    auto Cross = [](const Vector3& a, const Vector3& b)->Vector3 {
-        return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
-        };
-    const Vector3 A[3] = { Ax, Ay, Az };
-    const Vector3 W[3] = { Wx, Wy, Wz };
-    for (int i = 0; i < 3; ++i) {
-        for (int j = 0; j < 3; ++j) {
-            axes[idx++] = Cross(A[i], W[j]);
-        }
-    }
-
-    for (int i = 0; i < 15; ++i) {
-        if (!TestAxis(axes[i], minOverlap, minAxis)) {
-            return false;
-        }
-    }
-
-    // 押す向きを決める（Dと逆なら反転）
-    if (V3Dot(D, minAxis) < 0.0f) {
-        minAxis = V3Mul(minAxis, -1.0f);
-    }
-
-    outPush = V3Mul(minAxis, minOverlap);
-    return true;
-}
-
-// AABB vs AABB の最小押し戻し
-static inline bool ResolveAABB_vs_AABB_MinPush(const AABB3& moving, const AABB3& solid, Vector3& outPush)
-{
-    if (!IntersectAABB(moving, solid)) return false;
-
-    const Vector3 ca = CenterOf(moving);
-    const Vector3 cb = CenterOf(solid);
-
-    const float ox = std::min<float>(moving.max.x, solid.max.x) - std::max<float>(moving.min.x, solid.min.x);
-    const float oy = std::min<float>(moving.max.y, solid.max.y) - std::max<float>(moving.min.y, solid.min.y);
-    const float oz = std::min<float>(moving.max.z, solid.max.z) - std::max<float>(moving.min.z, solid.min.z);
-
-    outPush = { 0,0,0 };
-    if (ox <= oy && ox <= oz) outPush.x = (ca.x < cb.x) ? -ox : +ox;
-    else if (oy <= ox && oy <= oz) outPush.y = (ca.y < cb.y) ? -oy : +oy;
-    else outPush.z = (ca.z < cb.z) ? -oz : +oz;
-
-    return true;
-}
-
 // ========================
 // Wall System (class)
 // ========================
@@ -194,6 +18,7 @@ class WallSystem {
 public:
     enum class Type { AABB, OBB };
 
+    // エディタ・ステージファイルが扱う形。当たり判定はこれを compiled_ に焼いたものを使う
     struct Wall {
         Type type = Type::AABB;
         Vector3 center{ 0,0,0 };
@@ -204,6 +29,10 @@ public:
     void Clear() {
         walls_.clear();
         ClearDebug();
+        compiled_.Clear();
+        compiledFrom_.clear();
+        bvh_.Clear();
+        compiledValid_ = false;
     }
 
     int AddAABB(const Vector3& center, const Vector3& half) {
@@ -213,6 +42,7 @@ public:
         w.half = half;
         walls_.push_back(w);
         dirtyDebug_ = true;
+        CompileAdded_();
         return (int)walls_.size() - 1;
     }
 
@@ -224,36 +54,74 @@ public:
         w.rot = rotRad;
         walls_.push_back(w);
         dirtyDebug_ = true;
+        CompileAdded_();
         return (int)walls_.size() - 1;
     }
 
-    std::vector<Wall>& Walls() { return walls_; }
+    // 書き換えられるかもしれないので、次の当たり判定の前に焼いたものと突き合わせる
+    std::vector<Wall>& Walls() { wallsDirty_ = true; return walls_; }
     const std::vector<Wall>& Walls() const { return walls_; }
 
+    // パーティクル用の当たり判定に今の壁を登録してグリッドを作り直す（地面の設定はそのまま）
+    void BuildParticleCollision(ParticleCollisionWorld& world)
+    {
+        SyncCompiled_();
+        world.Clear();
+        for (uint32_t i = 0; i < compiled_.Size(); ++i) {
+            if (!compiled_.IsOBB(i)) {
+                world.AddAABB(compiled_.Center(i), compiled_.Half(i));
+            } else {
+                world.AddBox(compiled_.Center(i), compiled_.Half(i), compiled_.GetBasis(i).axis);
+            }
+        }
+        world.Build();
+    }
+
+    // 今の壁を当たり判定用の形（compiled_）とブロードフェーズ（BVH）に一から焼く。ステージを読み込んだ後に呼ぶ
+    // 以降の AddAABB / AddOBB は差分で足し、Walls() 経由の編集は次の当たり判定の前に変わった壁だけ焼き直す
+    void CompileWalls()
+    {
+        compiled_.Resize((uint32_t)walls_.size());
+        compiledFrom_.resize(walls_.size());
+        for (size_t i = 0; i < walls_.size(); ++i) {
+            CompileWall_((uint32_t)i);
+        }
+        bvh_.Build(compiled_.Bounds());
+        compiledValid_ = true;
+        wallsDirty_ = false;
+    }
+
     // ドローン(AABB)を壁と衝突解決
     // pos/vel を参照更新する
-    void ResolveDroneAABB(Vector3& pos, Vector3& vel, const Vector3& droneHalf, float /*dt*/, int iterations = 4)
+    // 今フレームの移動（pos - vel*dt → pos）を包む箱と重なる壁だけを BVH で拾って調べる
+    void ResolveDroneAABB(Vector3& pos, Vector3& vel, const Vector3& droneHalf, float dt, int iterations = 4)
     {
+        SyncCompiled_();
+
+        const AABB3 prevBox = MakeAABB_CenterHalf(V3Sub(pos, V3Mul(vel, dt)), droneHalf);
+        AABB3 queryBox = GatherCandidates_(UnionAABB(prevBox, MakeAABB_CenterHalf(pos, droneHalf)), droneHalf);
+
         for (int iter = 0; iter < iterations; ++iter) {
             bool hitAny = false;
 
             const Vector3 aabbCenter = pos;
-            AABB3 droneBox = MakeAABB_CenterHalf(pos, droneHalf);
+            const AABB3 startBox = MakeAABB_CenterHalf(pos, droneHalf);
+            AABB3 droneBox = startBox;
+            if (!ContainsAABB(queryBox, droneBox)) {
+                queryBox = GatherCandidates_(droneBox, droneHalf);
+            }
 
-            for (const auto& w : walls_) {
+            // 候補は番号順。全部の壁を順に見ていた頃と同じ順で押し戻す
+            for (size_t c = 0; c < candidates_.size(); ++c) {
+                const uint32_t index = candidates_[c];
                 Vector3 push{ 0,0,0 };
 
-                if (w.type == Type::AABB) {
-                    const AABB3 wallBox = MakeAABB_CenterHalf(w.center, w.half);
-                    if (ResolveAABB_vs_AABB_MinPush(droneBox, wallBox, push)) {
+                if (!compiled_.IsOBB(index)) {
+                    if (compiled_.ResolveAABB(index, droneBox, push)) {
                         hitAny = true;
                     }
                 } else {
-                    OBB obb;
-                    obb.center = w.center;
-                    obb.half = w.half;
-                    obb.rot = w.rot;
-                    if (ResolveAABB_vs_OBB_MinPush(aabbCenter, droneHalf, obb, push)) {
+                    if (compiled_.ResolveOBB(index, aabbCenter, droneHalf, push)) {
                         hitAny = true;
                     }
                 }
@@ -282,6 +150,13 @@ public:
 
                     // 更新
                     droneBox = MakeAABB_CenterHalf(pos, droneHalf);
+
+                    // 押し戻しで問い合わせた箱からはみ出したら引き直し、残りの番号から続ける
+                    // （OBB はこの反復の頭の位置で判定するので、その箱も含めておく）
+                    if (!ContainsAABB(queryBox, droneBox)) {
+                        queryBox = GatherCandidates_(UnionAABB(startBox, droneBox), droneHalf);
+                        c = std::upper_bound(candidates_.begin(), candidates_.end(), index) - candidates_.begin() - 1;
+                    }
                 }
             }
 
@@ -345,6 +220,84 @@ public:
     int  GetSelectedIndex() const { return selected_; }
 
 private:
+    // compiled_ を焼いたときの壁の形（Walls() 経由で書き換えられたかを比べる）
+    struct CompiledSource {
+        Type type = Type::AABB;
+        Vector3 center{ 0,0,0 };
+        Vector3 half{ 1,1,1 };
+        Vector3 rot{ 0,0,0 };
+
+        bool Matches(const Wall& w) const {
+            return type == w.type &&
+                center.x == w.center.x && center.y == w.center.y && center.z == w.center.z &&
+                half.x == w.half.x && half.y == w.half.y && half.z == w.half.z &&
+                rot.x == w.rot.x && rot.y == w.rot.y && rot.z == w.rot.z;
+        }
+    };
+
+    // 壁 index を compiled_ に焼き直す（木は呼ぶ側で直す）
+    void CompileWall_(uint32_t index) {
+        const Wall& w = walls_[index];
+        compiled_.Compile(index, w.type == Type::OBB, w.center, w.half, w.rot);
+        compiledFrom_[index] = { w.type, w.center, w.half, w.rot };
+    }
+
+    // 末尾に足した壁を焼いて木にも足す（まだ焼いていない＝ステージ読み込み中なら CompileWalls に任せる）
+    void CompileAdded_() {
+        if (!compiledValid_ || compiledFrom_.size() + 1 != walls_.size()) {
+            return;
+        }
+        const uint32_t index = (uint32_t)walls_.size() - 1;
+        compiled_.Resize(index + 1);
+        compiledFrom_.resize(index + 1);
+        CompileWall_(index);
+        bvh_.Insert(index, compiled_.Bounds()[index]);
+        if (bvh_.NeedsRebuild()) {
+            CompileWalls();
+        }
+    }
+
+    // Walls() 経由の編集を compiled_ と木に反映する
+    // 枚数が変わった（挿入・削除で番号がずれた）ら焼き直し、同じなら変わった壁だけ直す
+    void SyncCompiled_() {
+        if (!compiledValid_ || compiledFrom_.size() != walls_.size()) {
+            CompileWalls();
+            return;
+        }
+        if (!wallsDirty_) {
+            return;
+        }
+        wallsDirty_ = false;
+
+        size_t changed = 0;
+        for (size_t i = 0; i < walls_.size(); ++i) {
+            if (compiledFrom_[i].Matches(walls_[i])) {
+                continue;
+            }
+            // 大半が変わったなら 1 枚ずつ直すより組み直した方が速い
+            if (++changed > walls_.size() / 4 + 8) {
+                CompileWalls();
+                return;
+            }
+            CompileWall_((uint32_t)i);
+            bvh_.Update((uint32_t)i, compiled_.Bounds()[i]);
+        }
+        if (changed > 0 && bvh_.NeedsRebuild()) {
+            CompileWalls();
+        }
+    }
+
+    // box を少し太らせた箱と重なる壁を番号順に candidates_ へ集め、問い合わせた箱を返す
+    // （押し戻しで少し動くたびに引き直さなくて済むように、ドローンの半分だけ余裕を持たせる）
+    AABB3 GatherCandidates_(const AABB3& box, const Vector3& droneHalf) {
+        const Vector3 margin = V3Mul(droneHalf, 0.5f);
+        const AABB3 queryBox{ V3Sub(box.min, margin), V3Add(box.max, margin) };
+        candidates_.clear();
+        bvh_.Query(queryBox, candidates_);
+        std::sort(candidates_.begin(), candidates_.end());
+        return queryBox;
+    }
+
     void RebuildDebugIfNeeded_()
     {
         if (!mgr_) return;
@@ -370,6 +323,14 @@ private:
 private:
     std::vector<Wall> walls_;
 
+    // 当たり判定用に焼いたもの（walls_ とは別に持ち、壁が変わったときだけ焼き直す）
+    CompiledWalls compiled_;
+    std::vector<CompiledSource> compiledFrom_;
+    WallBvh bvh_;
+    bool compiledValid_ = false;
+    bool wallsDirty_ = false;
+    std::vector<uint32_t> candidates_;
+
     // debug draw
     Object3dManager* mgr_ = nullptr;
     std::string modelName_ = "cube.obj";
@@ -1,24 +1,14 @@
 ﻿#include "Gate.h"
+#include "ProjectionMath.h"
 
-// row-vector 座標変換（あなたの行列配置に合わせる）
-static Vector3 TransformCoord_RowVector(const Vector3& v, const Matrix4x4& m)
-{
-    Vector3 out;
-    out.x = v.x * m.m[0][0] + v.y * m.m[1][0] + v.z * m.m[2][0] + 1.0f * m.m[3][0];
-    out.y = v.x * m.m[0][1] + v.y * m.m[1][1] + v.z * m.m[2][1] + 1.0f * m.m[3][1];
-    out.z = v.x * m.m[0][2] + v.y * m.m[1][2] + v.z * m.m[2][2] + 1.0f * m.m[3][2];
-
-    const float w = v.x * m.m[0][3] + v.y * m.m[1][3] + v.z * m.m[2][3] + 1.0f * m.m[3][3];
-    if (std::abs(w) > 1e-6f) {
-        out.x /= w; out.y /= w; out.z /= w;
-    }
-    return out;
-}
 
 void Gate::UpdateMatrices()
 {
-    world = MatrixMath::MakeAffineMatrix({ 1,1,1 }, rot, pos);
-    invWorld = MatrixMath::Inverse(world);
+    // 回転+平行移動だけなので、逆行列は転置ベースで求まる
+    orientation.Sync(rot);
+    const AffineMatrix affine = AffineMath::MakeAffineFromBasis({ 1,1,1 }, orientation.axis, pos);
+    world = AffineMath::ToMatrix4x4(affine);
+    invWorld = AffineMath::ToMatrix4x4(AffineMath::InverseScaleRotate(affine));
 }
 
 void Gate::Tick(float dt)
@@ -55,7 +45,7 @@ bool Gate::TryPass(const Vector3& droneWorldPos, GateResult& outResult)
     outResult = GateResult::None;
 
     // ゲートローカルへ（回転対応のキモ）
-    const Vector3 pLocal = TransformCoord_RowVector(droneWorldPos, invWorld);
+    const Vector3 pLocal = ProjectionMath::TransformCoord(droneWorldPos, invWorld);
 
     // ---- デバッグ用（常に最新値を保持）----
     dbgLocalPos = pLocal;
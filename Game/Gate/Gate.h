@@ -5,7 +5,8 @@
 
 #include "MathStruct.h"
 #include "MatrixMath.h"
-#include"../Particle/ParticleGate.h"
+#include "AffineMatrix.h"
+#include "Quaternion.h"
 enum class GateResult : uint8_t {
 	None,
 	Perfect,
@@ -30,6 +31,7 @@ struct Gate {
 	// --- 行列 ---
 	Matrix4x4 world{};
 	Matrix4x4 invWorld{};
+	CachedOrientation orientation; // rot が変わったときだけ軸を作り直す
 
 	// --- 通過イベント用（前フレ値） ---
 	float prevLocalZ = 0.0f;
@@ -61,8 +63,7 @@ struct Gate {
 
 	Color4 GetDrawColor() const;
 
-	ParticleGate particleGate_;
-	bool isHitGate_;
+	bool isHitGate_ = false;
 	bool GetIsHitGate() const;
 	bool playedEffect = false;
 };
@@ -1,36 +1,13 @@
 #pragma once
 #include "MathStruct.h"
-#include <vector>
-
-class Object3d;
-class Object3dManager;
-class Camera;
 
+// 着地したときに足元から破片を輪っか状に飛ばす
+// 粒子そのものは MeshParticleManager が持つので、ここは発生のパラメータだけ
 class LandingEffect {
 public:
-    LandingEffect();
-    ~LandingEffect();
-
-    void Initialize(Object3dManager* objManager, Camera* camera);
+    void Initialize();
     void Play(const Vector3& pos);
 
-    void Update(float dt);
-    void Draw();
-
 private:
-    struct Piece {
-        Object3d* obj = nullptr;
-        Vector3 velocity{};
-        Vector3 scale = { 0.05f,0.05f,0.05f };
-        float life = 0.0f;
-    };
-
-    std::vector<Piece> pieces_;
-
-    Object3dManager* objManager_ = nullptr;
-    Camera* camera_ = nullptr;
-
-    bool isPlaying_ = false;
-
     float yOffset_ = 0.08f;
 };
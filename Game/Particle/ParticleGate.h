@@ -1,60 +1,26 @@
 #pragma once
 #include "MathStruct.h"
 #include <vector>
-class Object3d;
-class Object3dManager;
-class Camera;
 
+// ゲート通過時に星を飛び散らせる
+// 粒子そのものは MeshParticleManager が持つので、ここは発生のパラメータだけ
 class ParticleGate
 {
 public:
-	ParticleGate();
-	~ParticleGate();
-
-	void Initialize(Object3dManager* objManager, Camera* camera);
+	void Initialize();
 	void Play(const Vector3& centerPos);
 
-	void Update(float dt);
-	void Draw();
-
 private:
-	enum class Phase {
-		None,
-		Burst
-	};
-
-	struct Piece {
-		Object3d* obj = nullptr;
-		Vector3 velocity{};
-		Vector3 scale;
-		float life;
-		Phase phase;
-		Vector3 startScale;
-		Vector4 baseColor;
-	};
-
-
-	void StartRing(const Vector3& centerPos);
-	void StartBurst(Piece& piece);
 	float RandomFloat(float min, float max);
-private:
-	std::vector<Piece> pieces_;
 
-	Object3dManager* objManager_ = nullptr;
-	Camera* camera_ = nullptr;
-
-	bool isPlaying_ = false;
-	Vector3 centerPos_{};
+private:
+	// 破片ごとの基本色（Initialize で決めて毎回使い回す）
+	std::vector<Vector4> baseColors_;
 
 	float yOffset_ = 0.08f;
 
-	float ringLife_ = 0.94f;
 	float burstLife_ = 1.2f;
-
-	float ringSpeed_ = 4.0f;
-	float burstSpeed_ = 10.0f; 
-
-
-	float ringShrink_ = 0.0018f;
-	float burstShrink_ = 0.0040f;
+	float burstSpeed_ = 10.0f;
+	float burstGravity_ = 9.8f;
+	float burstScale_ = 0.08f;
 };
@@ -0,0 +1,332 @@
+#include "CurlNoiseField.h"
+#include "Random.h"
+#include "SimdConfig.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+#pragma region 内部関数
+namespace {
+
+// ファイルの先頭（'CURL'）と版
+constexpr uint32_t kFileMagic = 0x4C525543u;
+constexpr uint32_t kFileVersion = 1;
+constexpr uint32_t kMaxResolution = 128;
+
+// 格子点 lattice^3 個の値を持つ周期的な値ノイズ
+struct PeriodicValueNoise {
+    uint32_t lattice = 0;
+    std::vector<float> values;
+
+    void Initialize(uint32_t latticeSize, Random& random)
+    {
+        lattice = latticeSize;
+        values.resize(static_cast<size_t>(lattice) * lattice * lattice);
+        random.FillUniform(values.data(), values.size(), -1.0f, 1.0f);
+    }
+
+    float At(uint32_t x, uint32_t y, uint32_t z) const
+    {
+        return values[(static_cast<size_t>(z % lattice) * lattice + y % lattice) * lattice + x % lattice];
+    }
+
+    // u, v, w は格子単位の座標（[0, lattice)）
+    float Evaluate(float u, float v, float w) const
+    {
+        const uint32_t x0 = static_cast<uint32_t>(u);
+        const uint32_t y0 = static_cast<uint32_t>(v);
+        const uint32_t z0 = static_cast<uint32_t>(w);
+        // smoothstep で格子点の継ぎ目をなめらかにする
+        auto smooth = [](float t) { return t * t * (3.0f - 2.0f * t); };
+        const float tx = smooth(u - static_cast<float>(x0));
+        const float ty = smooth(v - static_cast<float>(y0));
+        const float tz = smooth(w - static_cast<float>(z0));
+
+        auto lerp = [](float a, float b, float t) { return a + (b - a) * t; };
+        const float c00 = lerp(At(x0, y0, z0), At(x0 + 1, y0, z0), tx);
+        const float c10 = lerp(At(x0, y0 + 1, z0), At(x0 + 1, y0 + 1, z0), tx);
+        const float c01 = lerp(At(x0, y0, z0 + 1), At(x0 + 1, y0, z0 + 1), tx);
+        const float c11 = lerp(At(x0, y0 + 1, z0 + 1), At(x0 + 1, y0 + 1, z0 + 1), tx);
+        return lerp(lerp(c00, c10, ty), lerp(c01, c11, ty), tz);
+    }
+};
+
+// 4 以上・kMaxResolution 以下の 2 の累乗に丸める
+uint32_t RoundResolution(uint32_t resolution)
+{
+    uint32_t n = 4;
+    while (n < resolution && n < kMaxResolution) {
+        n <<= 1;
+    }
+    return n;
+}
+
+uint32_t Log2(uint32_t powerOfTwo)
+{
+    uint32_t shift = 0;
+    while ((1u << shift) < powerOfTwo) {
+        ++shift;
+    }
+    return shift;
+}
+
+// 8 隅の値を x → y → z の順に補間する（SIMD 版と同じ順番）
+inline float Trilinear(const float* plane, const uint32_t (&index)[8], float tx, float ty, float tz)
+{
+    const float c00 = plane[index[0]] + (plane[index[1]] - plane[index[0]]) * tx;
+    const float c10 = plane[index[2]] + (plane[index[3]] - plane[index[2]]) * tx;
+    const float c01 = plane[index[4]] + (plane[index[5]] - plane[index[4]]) * tx;
+    const float c11 = plane[index[6]] + (plane[index[7]] - plane[index[6]]) * tx;
+    const float c0 = c00 + (c10 - c00) * ty;
+    const float c1 = c01 + (c11 - c01) * ty;
+    return c0 + (c1 - c0) * tz;
+}
+
+} // namespace
+#pragma endregion
+
+#pragma region 作成・読み書き
+void CurlNoiseField::Bake(uint32_t resolution, float period, uint64_t seed)
+{
+    const uint32_t n = RoundResolution(resolution);
+    const size_t count = static_cast<size_t>(n) * n * n;
+
+    // -----------------------------
+    // ポテンシャル ψ（3 成分）= 周期ノイズ 2 オクターブ
+    // -----------------------------
+    struct Octave {
+        uint32_t lattice;
+        float amplitude;
+    };
+    const Octave octaves[] = { { 4, 1.0f }, { 8, 0.5f } };
+
+    Random random(seed);
+    std::vector<float> potential[3];
+    for (std::vector<float>& psi : potential) {
+        psi.assign(count, 0.0f);
+        for (const Octave& octave : octaves) {
+            const uint32_t lattice = (std::min)(octave.lattice, n);
+            PeriodicValueNoise noise;
+            noise.Initialize(lattice, random);
+            const float toLattice = static_cast<float>(lattice) / static_cast<float>(n);
+            for (uint32_t z = 0; z < n; ++z) {
+                for (uint32_t y = 0; y < n; ++y) {
+                    for (uint32_t x = 0; x < n; ++x) {
+                        psi[(static_cast<size_t>(z) * n + y) * n + x] += octave.amplitude
+                            * noise.Evaluate(x * toLattice, y * toLattice, z * toLattice);
+                    }
+                }
+            }
+        }
+    }
+
+    // -----------------------------
+    // curl ψ を中心差分で求める（端は反対側につなぐ）
+    // -----------------------------
+    resolution_ = n;
+    mask_ = n - 1;
+    shift_ = Log2(n);
+    period_ = (period > 0.0f) ? period : kDefaultPeriod;
+    x_.assign(count, 0.0f);
+    y_.assign(count, 0.0f);
+    z_.assign(count, 0.0f);
+
+    double sumSq = 0.0;
+    for (uint32_t z = 0; z < n; ++z) {
+        for (uint32_t y = 0; y < n; ++y) {
+            for (uint32_t x = 0; x < n; ++x) {
+                const uint32_t xp = Index((x + 1) & mask_, y, z), xm = Index((x - 1) & mask_, y, z);
+                const uint32_t yp = Index(x, (y + 1) & mask_, z), ym = Index(x, (y - 1) & mask_, z);
+                const uint32_t zp = Index(x, y, (z + 1) & mask_), zm = Index(x, y, (z - 1) & mask_);
+                // 格子単位の微分（最後に正規化するので間隔は気にしない）
+                auto d = [&](int c, uint32_t plus, uint32_t minus) { return (potential[c][plus] - potential[c][minus]) * 0.5f; };
+
+                const uint32_t i = Index(x, y, z);
+                x_[i] = d(2, yp, ym) - d(1, zp, zm);
+                y_[i] = d(0, zp, zm) - d(2, xp, xm);
+                z_[i] = d(1, xp, xm) - d(0, yp, ym);
+                sumSq += double(x_[i]) * x_[i] + double(y_[i]) * y_[i] + double(z_[i]) * z_[i];
+            }
+        }
+    }
+
+    const double rms = std::sqrt(sumSq / static_cast<double>(count));
+    if (rms > 0.0) {
+        const float inv = static_cast<float>(1.0 / rms);
+        for (size_t i = 0; i < count; ++i) {
+            x_[i] *= inv;
+            y_[i] *= inv;
+            z_[i] *= inv;
+        }
+    }
+}
+
+bool CurlNoiseField::Load(const std::string& path)
+{
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs) {
+        return false;
+    }
+
+    uint32_t header[3] = {};
+    float period = 0.0f;
+    ifs.read(reinterpret_cast<char*>(header), sizeof(header));
+    ifs.read(reinterpret_cast<char*>(&period), sizeof(period));
+    const uint32_t n = header[2];
+    if (!ifs || header[0] != kFileMagic || header[1] != kFileVersion || n < 4 || n > kMaxResolution
+        || (n & (n - 1)) != 0 || !(period > 0.0f)) {
+        return false;
+    }
+
+    const size_t count = static_cast<size_t>(n) * n * n;
+    std::vector<float> planes[3];
+    for (std::vector<float>& plane : planes) {
+        plane.resize(count);
+        ifs.read(reinterpret_cast<char*>(plane.data()), count * sizeof(float));
+    }
+    if (!ifs) {
+        return false;
+    }
+
+    resolution_ = n;
+    mask_ = n - 1;
+    shift_ = Log2(n);
+    period_ = period;
+    x_ = std::move(planes[0]);
+    y_ = std::move(planes[1]);
+    z_ = std::move(planes[2]);
+    return true;
+}
+
+bool CurlNoiseField::Save(const std::string& path) const
+{
+    if (Empty()) {
+        return false;
+    }
+    std::ofstream ofs(path, std::ios::binary);
+    if (!ofs) {
+        return false;
+    }
+    const uint32_t header[3] = { kFileMagic, kFileVersion, resolution_ };
+    ofs.write(reinterpret_cast<const char*>(header), sizeof(header));
+    ofs.write(reinterpret_cast<const char*>(&period_), sizeof(period_));
+    for (const std::vector<float>* plane : { &x_, &y_, &z_ }) {
+        ofs.write(reinterpret_cast<const char*>(plane->data()), plane->size() * sizeof(float));
+    }
+    return static_cast<bool>(ofs);
+}
+#pragma endregion
+
+#pragma region 参照
+Vector3 CurlNoiseField::Sample(const Vector3& position, float frequency) const
+{
+    if (Empty()) {
+        return { 0.0f, 0.0f, 0.0f };
+    }
+
+    // ワールド座標 → 格子単位
+    const float scale = frequency * static_cast<float>(resolution_) / period_;
+    const float g[3] = { position.x * scale, position.y * scale, position.z * scale };
+    uint32_t i0[3], i1[3];
+    float t[3];
+    for (int a = 0; a < 3; ++a) {
+        const float f = std::floor(g[a]);
+        const int32_t i = static_cast<int32_t>(f);
+        t[a] = g[a] - f;
+        i0[a] = static_cast<uint32_t>(i) & mask_;
+        i1[a] = static_cast<uint32_t>(i + 1) & mask_;
+    }
+
+    const uint32_t index[8] = {
+        Index(i0[0], i0[1], i0[2]), Index(i1[0], i0[1], i0[2]),
+        Index(i0[0], i1[1], i0[2]), Index(i1[0], i1[1], i0[2]),
+        Index(i0[0], i0[1], i1[2]), Index(i1[0], i0[1], i1[2]),
+        Index(i0[0], i1[1], i1[2]), Index(i1[0], i1[1], i1[2]),
+    };
+    return {
+        Trilinear(x_.data(), index, t[0], t[1], t[2]),
+        Trilinear(y_.data(), index, t[0], t[1], t[2]),
+        Trilinear(z_.data(), index, t[0], t[1], t[2]),
+    };
+}
+
+void CurlNoiseField::SampleArray(const Vector3* positions, uint32_t count, float frequency, Vector3* out) const
+{
+    if (Empty()) {
+        for (uint32_t i = 0; i < count; ++i) {
+            out[i] = { 0.0f, 0.0f, 0.0f };
+        }
+        return;
+    }
+
+    uint32_t i = 0;
+#if defined(MATH_USE_SSE)
+    const float scaleValue = frequency * static_cast<float>(resolution_) / period_;
+    const __m128 scale = _mm_set1_ps(scaleValue);
+    const __m128i mask = _mm_set1_epi32(static_cast<int32_t>(mask_));
+    const __m128i one = _mm_set1_epi32(1);
+    const float* planes[3] = { x_.data(), y_.data(), z_.data() };
+
+    for (; i + 4 <= count; i += 4) {
+        const Vector3* p = positions + i;
+        const __m128 g[3] = {
+            _mm_mul_ps(_mm_setr_ps(p[0].x, p[1].x, p[2].x, p[3].x), scale),
+            _mm_mul_ps(_mm_setr_ps(p[0].y, p[1].y, p[2].y, p[3].y), scale),
+            _mm_mul_ps(_mm_setr_ps(p[0].z, p[1].z, p[2].z, p[3].z), scale),
+        };
+
+        // floor（SSE2 には無いので切り捨て後に負の側を 1 ずらす）と重み・折り返した添字
+        __m128 t[3];
+        __m128i i0[3], i1[3];
+        for (int a = 0; a < 3; ++a) {
+            __m128i truncated = _mm_cvttps_epi32(g[a]);
+            const __m128 over = _mm_cmpgt_ps(_mm_cvtepi32_ps(truncated), g[a]);
+            truncated = _mm_add_epi32(truncated, _mm_castps_si128(over)); // over は -1
+            t[a] = _mm_sub_ps(g[a], _mm_cvtepi32_ps(truncated));
+            i0[a] = _mm_and_si128(truncated, mask);
+            i1[a] = _mm_and_si128(_mm_add_epi32(truncated, one), mask);
+        }
+
+        // 8 隅の添字 = (z << 2shift) + (y << shift) + x
+        const __m128i shiftY = _mm_cvtsi32_si128(static_cast<int>(shift_));
+        const __m128i shiftZ = _mm_cvtsi32_si128(static_cast<int>(shift_ * 2));
+        const __m128i y0 = _mm_sll_epi32(i0[1], shiftY), y1 = _mm_sll_epi32(i1[1], shiftY);
+        const __m128i z0 = _mm_sll_epi32(i0[2], shiftZ), z1 = _mm_sll_epi32(i1[2], shiftZ);
+        const __m128i yz[4] = {
+            _mm_add_epi32(y0, z0), _mm_add_epi32(y1, z0), _mm_add_epi32(y0, z1), _mm_add_epi32(y1, z1)
+        };
+        alignas(16) uint32_t corner[8][4];
+        for (int k = 0; k < 4; ++k) {
+            _mm_store_si128(reinterpret_cast<__m128i*>(corner[k * 2 + 0]), _mm_add_epi32(yz[k], i0[0]));
+            _mm_store_si128(reinterpret_cast<__m128i*>(corner[k * 2 + 1]), _mm_add_epi32(yz[k], i1[0]));
+        }
+
+        // 成分ごとに 8 隅を 4 点ぶん集めて x → y → z の順に補間する
+        alignas(16) float result[3][4];
+        for (int c = 0; c < 3; ++c) {
+            const float* plane = planes[c];
+            __m128 v[8];
+            for (int k = 0; k < 8; ++k) {
+                v[k] = _mm_setr_ps(plane[corner[k][0]], plane[corner[k][1]], plane[corner[k][2]], plane[corner[k][3]]);
+            }
+            const __m128 c00 = _mm_add_ps(v[0], _mm_mul_ps(_mm_sub_ps(v[1], v[0]), t[0]));
+            const __m128 c10 = _mm_add_ps(v[2], _mm_mul_ps(_mm_sub_ps(v[3], v[2]), t[0]));
+            const __m128 c01 = _mm_add_ps(v[4], _mm_mul_ps(_mm_sub_ps(v[5], v[4]), t[0]));
+            const __m128 c11 = _mm_add_ps(v[6], _mm_mul_ps(_mm_sub_ps(v[7], v[6]), t[0]));
+            const __m128 c0 = _mm_add_ps(c00, _mm_mul_ps(_mm_sub_ps(c10, c00), t[1]));
+            const __m128 c1 = _mm_add_ps(c01, _mm_mul_ps(_mm_sub_ps(c11, c01), t[1]));
+            _mm_store_ps(result[c], _mm_add_ps(c0, _mm_mul_ps(_mm_sub_ps(c1, c0), t[2])));
+        }
+        for (int lane = 0; lane < 4; ++lane) {
+            out[i + lane] = { result[0][lane], result[1][lane], result[2][lane] };
+        }
+    }
+#endif
+
+    // 端数（SIMD なしなら全部）
+    for (; i < count; ++i) {
+        out[i] = Sample(positions[i], frequency);
+    }
+}
+#pragma endregion
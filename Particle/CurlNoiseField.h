@@ -0,0 +1,55 @@
+#pragma once
+#include "MathStruct.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ===============================
+// curl ノイズの速度場（乱流用）
+// ===============================
+// 周期的なノイズのポテンシャルから curl を取った発散 0 の速度場を N^3 の格子に焼いておき、
+// 粒子は格子を三線形補間で引くだけにする（粒子ごとのノイズ計算はしない）
+// 場は period ワールド単位ごとに繰り返すので、どこを引いても継ぎ目が出ない
+// 値は全体の RMS が 1 になるように正規化してある（強さはエフェクト側で掛ける）
+// D3D に依存しないのでベンチマークからも使える
+class CurlNoiseField {
+
+public:
+    // 1 辺の格子数（2 の累乗）
+    static constexpr uint32_t kDefaultResolution = 32;
+    // 場が繰り返す長さ（ワールド単位）
+    static constexpr float kDefaultPeriod = 8.0f;
+
+    // ノイズから焼く（resolution は 4 以上の 2 の累乗に丸める）
+    void Bake(uint32_t resolution = kDefaultResolution, float period = kDefaultPeriod, uint64_t seed = 0);
+
+    // Save で書いたファイルを読む。失敗したら false（中身はそのまま）
+    bool Load(const std::string& path);
+    bool Save(const std::string& path) const;
+
+    bool Empty() const { return resolution_ == 0; }
+    uint32_t GetResolution() const { return resolution_; }
+    float GetPeriod() const { return period_; }
+    // 格子が使っているメモリ（バイト）
+    size_t GetMemorySize() const { return (x_.size() + y_.size() + z_.size()) * sizeof(float); }
+
+    // position * frequency の位置の速度（1 点ずつ・比較用）
+    Vector3 Sample(const Vector3& position, float frequency = 1.0f) const;
+    // positions[0..count) をまとめて引いて out に書く（添字・重み・補間を 4 点ずつ SIMD で計算）
+    void SampleArray(const Vector3* positions, uint32_t count, float frequency, Vector3* out) const;
+
+private:
+    uint32_t Index(uint32_t x, uint32_t y, uint32_t z) const { return (z * resolution_ + y) * resolution_ + x; }
+
+private:
+    uint32_t resolution_ = 0;
+    // resolution_ - 1（添字の折り返し用）と log2(resolution_)
+    uint32_t mask_ = 0;
+    uint32_t shift_ = 0;
+    float period_ = kDefaultPeriod;
+
+    // 成分ごとに分けて持つ（SoA）
+    std::vector<float> x_;
+    std::vector<float> y_;
+    std::vector<float> z_;
+};
@@ -0,0 +1,459 @@
+#include "MeshParticleManager.h"
+#include "Model.h"
+#include "ModelManager.h"
+#include <algorithm>
+#include <cassert>
+
+MeshParticleManager* MeshParticleManager::instance = nullptr;
+
+MeshParticleManager* MeshParticleManager::GetInstance()
+{
+    if (!instance) {
+        instance = new MeshParticleManager();
+    }
+    return instance;
+}
+
+#pragma region 初期化・終了
+void MeshParticleManager::Initialize(DirectXCommon* dxCommon, SrvManager* srvManager, Camera* camera)
+{
+    dxCommon_ = dxCommon;
+    srvManager_ = srvManager;
+    camera_ = camera;
+
+    CreateRootSignature();
+    CreateGraphicsPipeline();
+
+    // マテリアルは全モデル共通（色はインスタンスごとに掛ける）
+    materialResource_ = dxCommon_->CreateBufferResource(sizeof(Material));
+    materialResource_->SetName(L"MeshParticleManager::MaterialCB");
+    Material* material = nullptr;
+    materialResource_->Map(0, nullptr, reinterpret_cast<void**>(&material));
+    material->color = { 1.0f, 1.0f, 1.0f, 1.0f };
+    material->enableLighting = 1;
+    material->padding[0] = 0.0f;
+    material->padding[1] = 0.0f;
+    material->shininess = 32.0f;
+    material->uvTransform = MatrixMath::MakeIdentity4x4();
+    materialResource_->Unmap(0, nullptr);
+}
+
+void MeshParticleManager::Finalize()
+{
+    if (dxCommon_) {
+        dxCommon_->WaitForGPU();
+    }
+
+    for (auto& [name, group] : groups_) {
+        if (group.instancingResource && group.instanceData) {
+            group.instancingResource->Unmap(0, nullptr);
+            group.instanceData = nullptr;
+        }
+        if (group.transformResource && group.transformData) {
+            group.transformResource->Unmap(0, nullptr);
+            group.transformData = nullptr;
+        }
+        group.instancingResource.Reset();
+        group.transformResource.Reset();
+    }
+    groups_.clear();
+
+    materialResource_.Reset();
+    rootSignature_.Reset();
+    for (int i = 0; i < kCountOfBlendMode; i++) {
+        pipelineStates_[i].Reset();
+    }
+
+    dxCommon_ = nullptr;
+    srvManager_ = nullptr;
+    camera_ = nullptr;
+}
+#pragma endregion
+
+#pragma region 発生
+MeshParticleManager::MeshGroup& MeshParticleManager::FindOrCreateGroup(const std::string& modelName)
+{
+    auto it = groups_.find(modelName);
+    if (it != groups_.end()) {
+        return it->second;
+    }
+
+    MeshGroup group {};
+    group.model = ModelManager::GetInstance()->FindModel(modelName);
+    assert(group.model && "MeshParticleManager: model is not loaded");
+
+    // SRV スロット確保（バッファを作り直してもスロットは使い回す）
+    group.instancingSrvIndex = srvManager_->Allocate();
+
+    group.transformResource = dxCommon_->CreateBufferResource(sizeof(TransformForGPU));
+    group.transformResource->SetName((L"MeshParticleManager::TransformCB_" + StringUtility::ConvertString(modelName)).c_str());
+    group.transformResource->Map(0, nullptr, reinterpret_cast<void**>(&group.transformData));
+    group.transformData->viewProjection = MatrixMath::MakeIdentity4x4();
+    group.transformData->local = group.model->GetModelData().rootNode.localMatrix;
+
+    auto [inserted, ok] = groups_.emplace(modelName, std::move(group));
+    ResizeInstancingBuffer(modelName, inserted->second, kInitialInstanceCapacity);
+    return inserted->second;
+}
+
+void MeshParticleManager::Spawn(const std::string& modelName, const SpawnDesc* descs, uint32_t count)
+{
+    if (count == 0) {
+        return;
+    }
+
+    MeshGroup& group = FindOrCreateGroup(modelName);
+
+    const size_t required = group.translate.size() + count;
+    group.translate.reserve(required);
+    group.velocity.reserve(required);
+    group.color.reserve(required);
+    group.startScale.reserve(required);
+    group.lifeTime.reserve(required);
+    group.currentTime.reserve(required);
+    group.gravity.reserve(required);
+    group.shrinkPerSecond.reserve(required);
+    group.lifeScale.reserve(required);
+
+    for (uint32_t n = 0; n < count; ++n) {
+        const SpawnDesc& desc = descs[n];
+        group.translate.push_back(desc.position);
+        group.velocity.push_back(desc.velocity);
+        group.color.push_back(desc.color);
+        group.startScale.push_back(desc.scale);
+        group.lifeTime.push_back(desc.lifeTime);
+        group.currentTime.push_back(0.0f);
+        group.gravity.push_back(desc.gravity);
+        group.shrinkPerSecond.push_back(desc.shrinkPerSecond);
+        group.lifeScale.push_back(desc.shrinkWithLife ? 1.0f : 0.0f);
+    }
+}
+
+void MeshParticleManager::SetCollision(const std::string& modelName, const ParticleCollisionResponse& response)
+{
+    FindOrCreateGroup(modelName).collision = response;
+}
+
+void MeshParticleManager::MeshGroup::SwapRemove(uint32_t index)
+{
+    assert(index < Size());
+
+    const uint32_t last = Size() - 1;
+    if (index != last) {
+        translate[index] = translate[last];
+        velocity[index] = velocity[last];
+        color[index] = color[last];
+        startScale[index] = startScale[last];
+        lifeTime[index] = lifeTime[last];
+        currentTime[index] = currentTime[last];
+        gravity[index] = gravity[last];
+        shrinkPerSecond[index] = shrinkPerSecond[last];
+        lifeScale[index] = lifeScale[last];
+    }
+    translate.pop_back();
+    velocity.pop_back();
+    color.pop_back();
+    startScale.pop_back();
+    lifeTime.pop_back();
+    currentTime.pop_back();
+    gravity.pop_back();
+    shrinkPerSecond.pop_back();
+    lifeScale.pop_back();
+}
+
+void MeshParticleManager::Clear()
+{
+    for (auto& [name, group] : groups_) {
+        group.translate.clear();
+        group.velocity.clear();
+        group.color.clear();
+        group.startScale.clear();
+        group.lifeTime.clear();
+        group.currentTime.clear();
+        group.gravity.clear();
+        group.shrinkPerSecond.clear();
+        group.lifeScale.clear();
+        group.numInstance = 0;
+    }
+}
+
+uint32_t MeshParticleManager::GetLiveCount() const
+{
+    uint32_t count = 0;
+    for (const auto& [name, group] : groups_) {
+        count += group.Size();
+    }
+    return count;
+}
+#pragma endregion
+
+#pragma region 更新
+void MeshParticleManager::Update(float deltaTime)
+{
+    if (!camera_) {
+        return;
+    }
+
+    deltaTime = (std::max)(deltaTime, 0.0f);
+    const Matrix4x4 viewProjection = camera_->GetViewProjectionMatrix();
+
+    for (auto& [name, group] : groups_) {
+
+        // 寿命切れを詰める（入れ替わってきた粒子を同じ i で見るので ++i しない）
+        uint32_t i = 0;
+        while (i < group.Size()) {
+            if (group.currentTime[i] >= group.lifeTime[i]) {
+                group.SwapRemove(i);
+                continue;
+            }
+            ++i;
+        }
+
+        const uint32_t count = group.Size();
+
+        // バッファを生存数まで伸ばす
+        // PostDraw で GPU 完了を待っているので、ここで作り直しても描画中のリソースは無い
+        if (count > group.instanceCapacity) {
+            uint32_t newCapacity = (std::max)(group.instanceCapacity, kInitialInstanceCapacity);
+            while (newCapacity < count) {
+                newCapacity *= 2;
+            }
+            ResizeInstancingBuffer(name, group, newCapacity);
+        }
+
+        // 移動（どの粒子も同じ式で、種類による分岐はしない）
+        for (uint32_t k = 0; k < count; ++k) {
+            group.velocity[k].y -= group.gravity[k] * deltaTime;
+            group.translate[k] += group.velocity[k] * deltaTime;
+        }
+
+        // 壁・地面
+        if (collisionWorld_ && group.collision.mode != ParticleCollisionMode::None && count > 0) {
+            ParticleCollisionWorld::Batch batch {};
+            batch.position = group.translate.data();
+            batch.velocity = group.velocity.data();
+            batch.currentTime = group.currentTime.data();
+            batch.lifeTime = group.lifeTime.data();
+            batch.count = count;
+            collisionWorld_->Resolve(batch, group.collision);
+        }
+
+        // 大きさ → インスタンスの書き込み
+        InstanceForGPU* out = group.instanceData;
+        for (uint32_t k = 0; k < count; ++k) {
+            const float age = group.currentTime[k];
+            const float remaining = 1.0f - age / group.lifeTime[k];
+            const float lifeFactor = 1.0f + group.lifeScale[k] * (remaining - 1.0f);
+            const float scale = (std::max)(group.startScale[k] - group.shrinkPerSecond[k] * age, 0.0f) * lifeFactor;
+
+            out[k].position = group.translate[k];
+            out[k].scale = (std::max)(scale, 0.0f);
+            out[k].color = group.color[k];
+
+            group.currentTime[k] += deltaTime;
+        }
+        group.numInstance = count;
+
+        group.transformData->viewProjection = viewProjection;
+    }
+}
+#pragma endregion
+
+#pragma region 描画
+void MeshParticleManager::PreDraw()
+{
+    auto* cmd = dxCommon_->GetCommandList();
+    cmd->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    cmd->SetGraphicsRootSignature(rootSignature_.Get());
+    cmd->SetPipelineState(pipelineStates_[currentBlendMode_].Get());
+}
+
+void MeshParticleManager::Draw()
+{
+    drawCallCount_ = 0;
+    if (!camera_) {
+        return;
+    }
+
+    auto* cmd = dxCommon_->GetCommandList();
+
+    // マテリアル・カメラ（共通）
+    cmd->SetGraphicsRootConstantBufferView(0, materialResource_->GetGPUVirtualAddress());
+    cmd->SetGraphicsRootConstantBufferView(4, camera_->GetGPUAddress());
+
+    // モデルごとに 1 回
+    for (auto& [name, group] : groups_) {
+        if (group.numInstance == 0) {
+            continue;
+        }
+
+        cmd->SetGraphicsRootConstantBufferView(7, group.transformResource->GetGPUVirtualAddress());
+        cmd->SetGraphicsRootDescriptorTable(1, srvManager_->GetGPUDescriptorHandle(group.instancingSrvIndex));
+
+        group.model->DrawInstanced(group.numInstance);
+        ++drawCallCount_;
+    }
+}
+#pragma endregion
+
+#pragma region GPU リソース
+void MeshParticleManager::ResizeInstancingBuffer(const std::string& name, MeshGroup& group, uint32_t capacity)
+{
+    // 古いバッファは Unmap して捨てる（中身は毎フレーム書き直すのでコピー不要）
+    if (group.instancingResource && group.instanceData) {
+        group.instancingResource->Unmap(0, nullptr);
+        group.instanceData = nullptr;
+    }
+
+    group.instancingResource = dxCommon_->CreateBufferResource(sizeof(InstanceForGPU) * capacity);
+    group.instancingResource->SetName((L"MeshParticleManager::InstancingBuffer_" + StringUtility::ConvertString(name)).c_str());
+    group.instancingResource->Map(0, nullptr, reinterpret_cast<void**>(&group.instanceData));
+    group.instanceCapacity = capacity;
+
+    srvManager_->CreateSRVforStructuredBuffer(group.instancingSrvIndex, group.instancingResource.Get(), capacity, sizeof(InstanceForGPU));
+}
+
+void MeshParticleManager::CreateRootSignature()
+{
+    // ========= SRV (t1, VS) : インスタンス =========
+    D3D12_DESCRIPTOR_RANGE instancingRange {};
+    instancingRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+    instancingRange.NumDescriptors = 1;
+    instancingRange.BaseShaderRegister = 1; // t1
+    instancingRange.OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
+
+    // ========= SRV (t0, PS) : テクスチャ =========
+    D3D12_DESCRIPTOR_RANGE texRange {};
+    texRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+    texRange.NumDescriptors = 1;
+    texRange.BaseShaderRegister = 0; // t0
+    texRange.OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
+
+    // ========= RootParameters（0・2～6 は Object3dManager と同じ） =========
+    D3D12_ROOT_PARAMETER rootParams[8] = {};
+
+    // [0] Material (b0, PS)
+    rootParams[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+    rootParams[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+    rootParams[0].Descriptor.ShaderRegister = 0;
+
+    // [1] Instancing SRV (t1, VS)
+    rootParams[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+    rootParams[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+    rootParams[1].DescriptorTable.NumDescriptorRanges = 1;
+    rootParams[1].DescriptorTable.pDescriptorRanges = &instancingRange;
+
+    // [2] Texture SRV (t0, PS)
+    rootParams[2].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+    rootParams[2].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+    rootParams[2].DescriptorTable.NumDescriptorRanges = 1;
+    rootParams[2].DescriptorTable.pDescriptorRanges = &texRange;
+
+    // [3] DirectionalLight (b1, PS) / [4] Camera (b2, PS) / [5] PointLight (b3, PS) / [6] SpotLight (b4, PS)
+    for (int i = 3; i <= 6; i++) {
+        rootParams[i].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+        rootParams[i].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+        rootParams[i].Descriptor.ShaderRegister = i - 2;
+    }
+
+    // [7] Transform (b0, VS)
+    rootParams[7].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+    rootParams[7].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+    rootParams[7].Descriptor.ShaderRegister = 0;
+
+    // ========= Sampler =========
+    D3D12_STATIC_SAMPLER_DESC sampler {};
+    sampler.Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+    sampler.AddressU = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+    sampler.AddressV = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+    sampler.AddressW = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+    sampler.ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+    sampler.MaxLOD = D3D12_FLOAT32_MAX;
+    sampler.ShaderRegister = 0;
+    sampler.ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+    D3D12_ROOT_SIGNATURE_DESC desc {};
+    desc.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+    desc.NumParameters = _countof(rootParams);
+    desc.pParameters = rootParams;
+    desc.NumStaticSamplers = 1;
+    desc.pStaticSamplers = &sampler;
+
+    Microsoft::WRL::ComPtr<ID3DBlob> sigBlob;
+    Microsoft::WRL::ComPtr<ID3DBlob> errBlob;
+    HRESULT hr = D3D12SerializeRootSignature(&desc, D3D_ROOT_SIGNATURE_VERSION_1, &sigBlob, &errBlob);
+    if (FAILED(hr)) {
+        if (errBlob) {
+            OutputDebugStringA((char*)errBlob->GetBufferPointer());
+        }
+        assert(false);
+    }
+
+    hr = dxCommon_->GetDevice()->CreateRootSignature(
+        0,
+        sigBlob->GetBufferPointer(),
+        sigBlob->GetBufferSize(),
+        IID_PPV_ARGS(&rootSignature_));
+    assert(SUCCEEDED(hr));
+}
+
+void MeshParticleManager::CreateGraphicsPipeline()
+{
+    // ====== 入力レイアウト（Model の VertexData） ======
+    D3D12_INPUT_ELEMENT_DESC inputElementDescs[3] = {};
+
+    inputElementDescs[0].SemanticName = "POSITION";
+    inputElementDescs[0].Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+    inputElementDescs[0].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+
+    inputElementDescs[1].SemanticName = "TEXCOORD";
+    inputElementDescs[1].Format = DXGI_FORMAT_R32G32_FLOAT;
+    inputElementDescs[1].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+
+    inputElementDescs[2].SemanticName = "NORMAL";
+    inputElementDescs[2].Format = DXGI_FORMAT_R32G32B32_FLOAT;
+    inputElementDescs[2].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+
+    D3D12_INPUT_LAYOUT_DESC inputLayoutDesc {};
+    inputLayoutDesc.pInputElementDescs = inputElementDescs;
+    inputLayoutDesc.NumElements = _countof(inputElementDescs);
+
+    // ====== ラスタライザ・デプス（Object3d と同じ） ======
+    D3D12_RASTERIZER_DESC rasterizerDesc {};
+    rasterizerDesc.CullMode = D3D12_CULL_MODE_BACK;
+    rasterizerDesc.FillMode = D3D12_FILL_MODE_SOLID;
+
+    D3D12_DEPTH_STENCIL_DESC depthStencilDesc {};
+    depthStencilDesc.DepthEnable = TRUE;
+    depthStencilDesc.StencilEnable = FALSE;
+    depthStencilDesc.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL;
+    depthStencilDesc.DepthFunc = D3D12_COMPARISON_FUNC_LESS_EQUAL;
+
+    // ====== シェーダーのコンパイル ======
+    Microsoft::WRL::ComPtr<IDxcBlob> vertexShaderBlob = dxCommon_->CompileShader(L"resources/shaders/MeshParticle.VS.hlsl", L"vs_6_0");
+    Microsoft::WRL::ComPtr<IDxcBlob> pixelShaderBlob = dxCommon_->CompileShader(L"resources/shaders/MeshParticle.PS.hlsl", L"ps_6_0");
+    assert(vertexShaderBlob && pixelShaderBlob);
+
+    D3D12_GRAPHICS_PIPELINE_STATE_DESC base {};
+    base.pRootSignature = rootSignature_.Get();
+    base.InputLayout = inputLayoutDesc;
+    base.VS = { vertexShaderBlob->GetBufferPointer(), vertexShaderBlob->GetBufferSize() };
+    base.PS = { pixelShaderBlob->GetBufferPointer(), pixelShaderBlob->GetBufferSize() };
+    base.RasterizerState = rasterizerDesc;
+    base.DepthStencilState = depthStencilDesc;
+    base.NumRenderTargets = 1;
+    base.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+    base.DSVFormat = DXGI_FORMAT_D24_UNORM_S8_UINT;
+    base.SampleDesc.Count = 1;
+    base.SampleMask = D3D12_DEFAULT_SAMPLE_MASK;
+    base.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+
+    for (int i = 0; i < kCountOfBlendMode; i++) {
+        D3D12_GRAPHICS_PIPELINE_STATE_DESC desc = base;
+        desc.BlendState = CreateBlendDesc(static_cast<BlendMode>(i));
+        HRESULT hr = dxCommon_->GetDevice()->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(&pipelineStates_[i]));
+        assert(SUCCEEDED(hr));
+        (void)hr;
+    }
+}
+#pragma endregion
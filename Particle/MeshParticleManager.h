@@ -0,0 +1,161 @@
+#pragma once
+#include "Camera.h"
+#include "DirectXCommon.h"
+#include "Object3DStruct.h"
+#include "ParticleCollision.h"
+#include "SrvManager.h"
+#include "blendutil.h"
+#include <d3d12.h>
+#include <map>
+#include <string>
+#include <vector>
+#include <wrl.h>
+
+class Model;
+
+// ===============================
+// モデルを使うパーティクル（星・破片など）
+// ===============================
+// モデルごとに SoA で粒子を持ち、1 モデル 1 回のインスタンス描画で全部描く
+// 描画は Object3d と同じライト（LightManager::Bind）を使うので、
+// ルートシグネチャの 0・2～6 番は Object3dManager と同じ並びにしてある
+class MeshParticleManager {
+public:
+    // =========================================================
+    // Singleton Access
+    // =========================================================
+    static MeshParticleManager* GetInstance();
+    void Finalize();
+
+    // =========================================================
+    // GPUに送る構造体
+    // =========================================================
+    // 1 インスタンス 32 バイト（MeshParticle.hlsli と同じ並び）
+    struct InstanceForGPU {
+        Vector3 position;
+        float scale;
+        Vector4 color;
+    };
+    static_assert(sizeof(InstanceForGPU) == 32, "MeshParticle.hlsli の MeshParticleInstance と揃えること");
+
+    // モデルごとの共通値（b0, VS）
+    struct TransformForGPU {
+        Matrix4x4 viewProjection;
+        // モデルのルートノード行列（Object3d と同じく頂点に最初に掛ける）
+        Matrix4x4 local;
+    };
+
+    // 1 粒子ぶんの発生パラメータ
+    struct SpawnDesc {
+        Vector3 position {};
+        Vector3 velocity {};
+        Vector4 color { 1.0f, 1.0f, 1.0f, 1.0f };
+        float scale = 1.0f;
+        // 秒
+        float lifeTime = 1.0f;
+        // 下向きの加速度（m/s^2）
+        float gravity = 0.0f;
+        // 1 秒あたりに小さくなる量
+        float shrinkPerSecond = 0.0f;
+        // true なら残り寿命の割合も大きさに掛ける（寿命の終わりで 0）
+        bool shrinkWithLife = false;
+    };
+
+public:
+    // =========================================================
+    // 基本操作
+    // =========================================================
+    void Initialize(DirectXCommon* dxCommon, SrvManager* srvManager, Camera* camera);
+    // deltaTime は実時間（秒）
+    void Update(float deltaTime);
+    // PreDraw の後に LightManager::Bind してから Draw する
+    void PreDraw();
+    void Draw();
+
+    // modelName は ModelManager に読み込み済みのファイル名
+    void Spawn(const std::string& modelName, const SpawnDesc* descs, uint32_t count);
+    void Spawn(const std::string& modelName, const SpawnDesc& desc) { Spawn(modelName, &desc, 1); }
+
+    void Clear();
+
+    void SetCamera(Camera* camera) { camera_ = camera; }
+    void SetBlendMode(BlendMode mode) { currentBlendMode_ = mode; }
+
+    // 壁・地面（シーンが持つ。nullptr なら当たり判定しない）
+    void SetCollisionWorld(const ParticleCollisionWorld* world) { collisionWorld_ = world; }
+    // モデルごとの当たった時の反応（modelName は読み込み済みであること）
+    void SetCollision(const std::string& modelName, const ParticleCollisionResponse& response);
+
+    // 全モデル合計の生存数
+    uint32_t GetLiveCount() const;
+    // 直近の Draw で発行した描画コール数（= 粒子のいるモデルの数）
+    uint32_t GetDrawCallCount() const { return drawCallCount_; }
+
+private:
+    // =========================================================
+    // Singleton Safety
+    // =========================================================
+    MeshParticleManager() = default;
+    ~MeshParticleManager() = default;
+
+    MeshParticleManager(const MeshParticleManager&) = delete;
+    MeshParticleManager& operator=(const MeshParticleManager&) = delete;
+    static MeshParticleManager* instance;
+
+private:
+    // 1 モデルぶんの粒子（属性ごとの連続配列 + インスタンシングバッファ）
+    struct MeshGroup {
+        Model* model = nullptr;
+
+        std::vector<Vector3> translate;
+        std::vector<Vector3> velocity;
+        std::vector<Vector4> color;
+        std::vector<float> startScale;
+        std::vector<float> lifeTime;
+        std::vector<float> currentTime;
+        std::vector<float> gravity;
+        std::vector<float> shrinkPerSecond;
+        // 0 / 1（残り寿命の割合を大きさに掛けるか）
+        std::vector<float> lifeScale;
+
+        Microsoft::WRL::ComPtr<ID3D12Resource> instancingResource;
+        InstanceForGPU* instanceData = nullptr;
+        uint32_t instancingSrvIndex = 0;
+        uint32_t instanceCapacity = 0;
+        uint32_t numInstance = 0;
+
+        Microsoft::WRL::ComPtr<ID3D12Resource> transformResource;
+        TransformForGPU* transformData = nullptr;
+
+        ParticleCollisionResponse collision;
+
+        uint32_t Size() const { return static_cast<uint32_t>(translate.size()); }
+        // index の粒子を末尾の粒子で上書きして 1 個減らす
+        void SwapRemove(uint32_t index);
+    };
+
+    void CreateRootSignature();
+    void CreateGraphicsPipeline();
+    MeshGroup& FindOrCreateGroup(const std::string& modelName);
+    // インスタンシングバッファを capacity 要素で作り直し、SRV も同じスロットに張り直す
+    void ResizeInstancingBuffer(const std::string& name, MeshGroup& group, uint32_t capacity);
+
+private:
+    DirectXCommon* dxCommon_ = nullptr;
+    SrvManager* srvManager_ = nullptr;
+    Camera* camera_ = nullptr;
+    const ParticleCollisionWorld* collisionWorld_ = nullptr;
+
+    Microsoft::WRL::ComPtr<ID3D12RootSignature> rootSignature_;
+    Microsoft::WRL::ComPtr<ID3D12PipelineState> pipelineStates_[kCountOfBlendMode];
+    int currentBlendMode_ = kBlendModeNormal;
+
+    Microsoft::WRL::ComPtr<ID3D12Resource> materialResource_;
+
+    // 最初に確保するインスタンス数（足りなければ倍々で伸ばす）
+    static constexpr uint32_t kInitialInstanceCapacity = 64;
+
+    // 描画順を毎フレーム固定するため map
+    std::map<std::string, MeshGroup> groups_;
+    uint32_t drawCallCount_ = 0;
+};
@@ -0,0 +1,143 @@
+#include "ParticleAtlas.h"
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+#pragma region 内部関数
+namespace {
+
+// value 以上の 2 の累乗
+uint32_t CeilPowerOfTwo(uint32_t value)
+{
+    uint32_t n = 1;
+    while (n < value) {
+        n <<= 1;
+    }
+    return n;
+}
+
+} // namespace
+#pragma endregion
+
+uint32_t ParticleAtlas::SlotSize(uint32_t size)
+{
+    const uint32_t padded = size + kPadding * 2;
+    return (padded + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+uint32_t ParticleAtlas::Pack(const std::vector<Piece>& pieces, const std::vector<uint32_t>& order, uint32_t width,
+    std::vector<Placement>& placements)
+{
+    // 背の高い順に左から並べ、はみ出したら次の棚へ
+    // 区画の大きさは kAlignment の倍数なので、どの区画の左上も kAlignment の倍数になる
+    uint32_t x = 0;
+    uint32_t y = 0;
+    uint32_t shelfHeight = 0;
+    for (uint32_t i : order) {
+        const uint32_t w = SlotSize(pieces[i].width);
+        const uint32_t h = SlotSize(pieces[i].height);
+        if (w > width) {
+            return 0;
+        }
+        if (x + w > width) {
+            x = 0;
+            y += shelfHeight;
+            shelfHeight = 0;
+        }
+        placements[i] = { x, y };
+        x += w;
+        shelfHeight = (std::max)(shelfHeight, h);
+    }
+    return y + shelfHeight;
+}
+
+bool ParticleAtlas::Build(const std::vector<Image>& images)
+{
+    if (images.empty()) {
+        return false;
+    }
+
+    // 画像をコマに切り分ける（割り切れない端のピクセルは使わない）
+    std::vector<Piece> pieces;
+    std::vector<uint32_t> firstPiece(images.size());
+    std::vector<uint32_t> pieceCount(images.size());
+    for (uint32_t i = 0; i < images.size(); ++i) {
+        const Image& image = images[i];
+        const uint32_t columns = (std::max)(image.columns, 1u);
+        const uint32_t rows = (std::max)(image.rows, 1u);
+        if (image.width < columns || image.height < rows || !image.rgba) {
+            return false;
+        }
+        const uint32_t cellW = image.width / columns;
+        const uint32_t cellH = image.height / rows;
+        firstPiece[i] = static_cast<uint32_t>(pieces.size());
+        pieceCount[i] = columns * rows;
+        for (uint32_t cell = 0; cell < columns * rows; ++cell) {
+            pieces.push_back({ i, (cell % columns) * cellW, (cell / columns) * cellH, cellW, cellH });
+        }
+    }
+
+    std::vector<uint32_t> order(pieces.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return pieces[a].height > pieces[b].height; });
+
+    // 正方形に近くなる一番小さい幅を探す
+    std::vector<Placement> placements(pieces.size());
+    uint32_t width = 0;
+    uint32_t height = 0;
+    for (uint32_t candidate = 64; candidate <= kMaxSize; candidate <<= 1) {
+        const uint32_t used = Pack(pieces, order, candidate, placements);
+        if (used > 0 && used <= candidate) {
+            width = candidate;
+            height = CeilPowerOfTwo(used);
+            break;
+        }
+    }
+    if (width == 0) {
+        return false;
+    }
+
+    width_ = width;
+    height_ = height;
+    pixels_.assign(static_cast<size_t>(width) * height * 4, 0);
+    rects_.resize(pieces.size());
+    firstPiece_ = std::move(firstPiece);
+    pieceCount_ = std::move(pieceCount);
+
+    const float invW = 1.0f / static_cast<float>(width);
+    const float invH = 1.0f / static_cast<float>(height);
+    for (size_t i = 0; i < pieces.size(); ++i) {
+        const Piece& piece = pieces[i];
+        const Image& image = images[piece.image];
+        const Placement& p = placements[i];
+
+        // 区画ごと書く（コマの外側は一番近い端のピクセル）
+        const int32_t pad = static_cast<int32_t>(kPadding);
+        const int32_t w = static_cast<int32_t>(piece.width);
+        const int32_t h = static_cast<int32_t>(piece.height);
+        const uint32_t slotW = SlotSize(piece.width);
+        const uint32_t slotH = SlotSize(piece.height);
+        for (uint32_t sy = 0; sy < slotH; ++sy) {
+            const int32_t srcY = std::clamp(static_cast<int32_t>(sy) - pad, 0, h - 1) + static_cast<int32_t>(piece.y);
+            const uint8_t* row = image.rgba + (static_cast<size_t>(srcY) * image.width + piece.x) * 4;
+            uint8_t* dst = &pixels_[(static_cast<size_t>(p.y + sy) * width + p.x) * 4];
+            for (uint32_t sx = 0; sx < slotW; ++sx, dst += 4) {
+                const int32_t srcX = std::clamp(static_cast<int32_t>(sx) - pad, 0, w - 1);
+                std::memcpy(dst, row + static_cast<size_t>(srcX) * 4, 4);
+            }
+        }
+
+        rects_[i] = {
+            static_cast<float>(p.x + kPadding) * invW,
+            static_cast<float>(p.y + kPadding) * invH,
+            static_cast<float>(piece.width) * invW,
+            static_cast<float>(piece.height) * invH,
+        };
+    }
+    return true;
+}
+
+const Vector4& ParticleAtlas::GetRect(size_t image, uint32_t cell) const
+{
+    return rects_[firstPiece_[image] + (std::min)(cell, pieceCount_[image] - 1)];
+}
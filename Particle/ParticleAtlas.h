@@ -0,0 +1,74 @@
+#pragma once
+#include "MathStruct.h"
+#include <cstdint>
+#include <vector>
+
+// ===============================
+// パーティクル用テクスチャアトラス（棚詰め）
+// ===============================
+// エフェクトごとの画像を 1 枚にまとめ、各画像（フリップブックならコマごと）の UV 範囲を返す
+// コマの周りは端のピクセルを kPadding だけ複製し、余白込みの区画を kAlignment 単位にそろえて置く
+// ミップを kMipLevels 段までにすれば、どの段でも余白が 1 texel 以上残り、線形補間で隣のコマがにじまない
+// ピクセルは RGBA8 のまま並べ替えるだけ（色空間は呼び出し側の画像に合わせる）
+// D3D に依存しないのでベンチマークからも使える
+class ParticleAtlas {
+
+public:
+    // RGBA8・行の詰め物なし（width * 4 バイトずつ）
+    struct Image {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        const uint8_t* rgba = nullptr;
+        // フリップブックのコマ割り（左上から横へ）。コマごとに余白を付けて別々に置く
+        uint32_t columns = 1;
+        uint32_t rows = 1;
+    };
+
+    // コマの周りの余白（ピクセル）
+    static constexpr uint32_t kPadding = 4;
+    // アトラスに付けてよいミップの段数（余白が 1 texel 以上残る段まで = log2(kPadding) + 1）
+    static constexpr uint32_t kMipLevels = 3;
+    // 余白込みの区画の位置・大きさをこの倍数にそろえる（縮小しても区画の境目が texel の境目に乗る）
+    static constexpr uint32_t kAlignment = 1u << (kMipLevels - 1);
+    static_assert((kPadding >> (kMipLevels - 1)) >= 1, "padding must stay at least one texel on the last mip");
+    // アトラスの 1 辺の上限
+    static constexpr uint32_t kMaxSize = 4096;
+
+    // images を 1 枚に詰める。入りきらなければ false（中身はそのまま）
+    bool Build(const std::vector<Image>& images);
+
+    uint32_t GetWidth() const { return width_; }
+    uint32_t GetHeight() const { return height_; }
+    const std::vector<uint8_t>& GetPixels() const { return pixels_; }
+    // images[image] の cell コマ目の UV 範囲（x, y = 左上 / z, w = 幅・高さ）
+    const Vector4& GetRect(size_t image, uint32_t cell = 0) const;
+    size_t GetImageCount() const { return firstPiece_.size(); }
+
+private:
+    // 1 コマ分の切り出し
+    struct Piece {
+        uint32_t image;
+        uint32_t x;
+        uint32_t y;
+        uint32_t width;
+        uint32_t height;
+    };
+    struct Placement {
+        uint32_t x;
+        uint32_t y;
+    };
+    // 余白込み・kAlignment にそろえた区画の大きさ
+    static uint32_t SlotSize(uint32_t size);
+    // 幅 width の棚に詰めて、必要な高さを返す（入らなければ 0）。placements は区画の左上
+    static uint32_t Pack(const std::vector<Piece>& pieces, const std::vector<uint32_t>& order, uint32_t width,
+        std::vector<Placement>& placements);
+
+private:
+    uint32_t width_ = 0;
+    uint32_t height_ = 0;
+    std::vector<uint8_t> pixels_;
+    // コマごとの UV 範囲と、画像ごとの先頭コマ・コマ数
+    std::vector<Vector4> rects_;
+    std::vector<uint32_t> firstPiece_;
+    std::vector<uint32_t> pieceCount_;
+};
@@ -0,0 +1,412 @@
+#include "ParticleCollision.h"
+#include "SimdConfig.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#pragma region 内部関数
+namespace {
+
+// 空きレーンの half（半径を足しても負のままなので必ず外れる）
+constexpr float kEmptyHalf = -FLT_MAX * 0.5f;
+
+// 点と箱（ローカル軸 axis・半サイズ half + radius）
+// めり込んでいれば一番浅い軸の外向き法線と深さを返す
+inline bool PointVsBox(const Vector3& point, const Vector3& center, const Vector3 (&axis)[3], const Vector3& half,
+    float radius, Vector3& outNormal, float& outDepth)
+{
+    const Vector3 d = point - center;
+    const float halfs[3] = { half.x, half.y, half.z };
+
+    float minDepth = FLT_MAX;
+    int minAxis = 0;
+    float minSign = 1.0f;
+    for (int k = 0; k < 3; ++k) {
+        const float local = Dot(d, axis[k]);
+        const float depth = halfs[k] + radius - std::abs(local);
+        if (depth <= 0.0f) {
+            return false;
+        }
+        if (depth < minDepth) {
+            minDepth = depth;
+            minAxis = k;
+            minSign = (local < 0.0f) ? -1.0f : 1.0f;
+        }
+    }
+
+    outNormal = axis[minAxis] * minSign;
+    outDepth = minDepth;
+    return true;
+}
+
+// 押し出して反応させる
+inline void ApplyResponse(const ParticleCollisionResponse& response, const Vector3& normal, float depth,
+    Vector3& position, Vector3& velocity, float& currentTime, float lifeTime)
+{
+    position += normal * depth;
+
+    switch (response.mode) {
+    case ParticleCollisionMode::Bounce: {
+        // 壁に向かう成分だけ反転（離れていく粒子はそのまま）
+        const float vn = Dot(velocity, normal);
+        if (vn < 0.0f) {
+            const Vector3 normalVelocity = normal * vn;
+            const Vector3 tangentVelocity = velocity - normalVelocity;
+            velocity = tangentVelocity * (1.0f - response.friction) - normalVelocity * response.restitution;
+        }
+        break;
+    }
+    case ParticleCollisionMode::Stick:
+        velocity = { 0.0f, 0.0f, 0.0f };
+        break;
+    case ParticleCollisionMode::Kill:
+        currentTime = lifeTime;
+        break;
+    case ParticleCollisionMode::None:
+        break;
+    }
+}
+
+} // namespace
+#pragma endregion
+
+#pragma region 構築
+void ParticleCollisionWorld::Clear()
+{
+    boxes_.clear();
+    cellStart_.clear();
+    blocks_.clear();
+    cellsX_ = 0;
+    cellsZ_ = 0;
+    registeredCount_ = 0;
+}
+
+void ParticleCollisionWorld::AddBox(const Vector3& center, const Vector3& half, const Vector3 (&axis)[3])
+{
+    Box box;
+    box.center = center;
+    box.half = half;
+    box.axis[0] = axis[0];
+    box.axis[1] = axis[1];
+    box.axis[2] = axis[2];
+    boxes_.push_back(box);
+}
+
+void ParticleCollisionWorld::AddAABB(const Vector3& center, const Vector3& half)
+{
+    static const Vector3 kIdentity[3] = { { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } };
+    AddBox(center, half, kIdentity);
+}
+
+void ParticleCollisionWorld::Build()
+{
+    cellStart_.clear();
+    blocks_.clear();
+    cellsX_ = 0;
+    cellsZ_ = 0;
+    registeredCount_ = 0;
+    builtMargin_ = (std::max)(kRegisterMargin, maxRadius_);
+    const float margin = builtMargin_;
+
+    if (boxes_.empty()) {
+        return;
+    }
+
+    // -----------------------------
+    // 各箱を自分の軸に沿って余白ぶん太らせたもののワールド AABB（回っている箱は軸ごとの張り出しの和）
+    // 判定も箱の軸に沿って半径ぶん太らせるので、回っている箱はワールドの AABB に余白を足すだけでは足りない
+    // -----------------------------
+    std::vector<Vector3> boundsMin(boxes_.size());
+    std::vector<Vector3> boundsMax(boxes_.size());
+    Vector3 worldMin { FLT_MAX, FLT_MAX, FLT_MAX };
+    Vector3 worldMax { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    for (size_t i = 0; i < boxes_.size(); ++i) {
+        const Box& box = boxes_[i];
+        Vector3 extent {};
+        for (int k = 0; k < 3; ++k) {
+            const float h = ((k == 0) ? box.half.x : (k == 1) ? box.half.y : box.half.z) + margin;
+            extent.x += std::abs(box.axis[k].x) * h;
+            extent.y += std::abs(box.axis[k].y) * h;
+            extent.z += std::abs(box.axis[k].z) * h;
+        }
+        boundsMin[i] = box.center - extent;
+        boundsMax[i] = box.center + extent;
+
+        worldMin.x = (std::min)(worldMin.x, boundsMin[i].x);
+        worldMin.y = (std::min)(worldMin.y, boundsMin[i].y);
+        worldMin.z = (std::min)(worldMin.z, boundsMin[i].z);
+        worldMax.x = (std::max)(worldMax.x, boundsMax[i].x);
+        worldMax.y = (std::max)(worldMax.y, boundsMax[i].y);
+        worldMax.z = (std::max)(worldMax.z, boundsMax[i].z);
+    }
+    minY_ = worldMin.y;
+    maxY_ = worldMax.y;
+
+    // -----------------------------
+    // グリッドの大きさ（広すぎるステージはセルを大きくする）
+    // -----------------------------
+    originX_ = worldMin.x;
+    originZ_ = worldMin.z;
+    const float sizeX = worldMax.x - originX_;
+    const float sizeZ = worldMax.z - originZ_;
+    builtCellSize_ = (std::max)({ cellSize_, sizeX / kMaxCellsPerAxis, sizeZ / kMaxCellsPerAxis });
+    invCellSize_ = 1.0f / builtCellSize_;
+    cellsX_ = (std::max)(1u, static_cast<uint32_t>(std::ceil(sizeX * invCellSize_)));
+    cellsZ_ = (std::max)(1u, static_cast<uint32_t>(std::ceil(sizeZ * invCellSize_)));
+    cellsX_ = (std::min)(cellsX_, kMaxCellsPerAxis);
+    cellsZ_ = (std::min)(cellsZ_, kMaxCellsPerAxis);
+    const uint32_t cellCount = cellsX_ * cellsZ_;
+
+    auto cellRange = [&](size_t i, uint32_t& x0, uint32_t& x1, uint32_t& z0, uint32_t& z1) {
+        auto toCell = [&](float v, float origin, uint32_t cells) {
+            const int c = static_cast<int>((v - origin) * invCellSize_);
+            return static_cast<uint32_t>(std::clamp(c, 0, static_cast<int>(cells) - 1));
+        };
+        x0 = toCell(boundsMin[i].x, originX_, cellsX_);
+        x1 = toCell(boundsMax[i].x, originX_, cellsX_);
+        z0 = toCell(boundsMin[i].z, originZ_, cellsZ_);
+        z1 = toCell(boundsMax[i].z, originZ_, cellsZ_);
+    };
+
+    // -----------------------------
+    // セルごとの箱の数 → 4 枚単位のブロック数 → 開始位置
+    // -----------------------------
+    std::vector<uint32_t> boxCount(cellCount, 0);
+    for (size_t i = 0; i < boxes_.size(); ++i) {
+        uint32_t x0, x1, z0, z1;
+        cellRange(i, x0, x1, z0, z1);
+        for (uint32_t z = z0; z <= z1; ++z) {
+            for (uint32_t x = x0; x <= x1; ++x) {
+                ++boxCount[z * cellsX_ + x];
+            }
+        }
+    }
+
+    cellStart_.resize(cellCount + 1);
+    uint32_t blockCount = 0;
+    for (uint32_t c = 0; c < cellCount; ++c) {
+        cellStart_[c] = blockCount;
+        blockCount += (boxCount[c] + 3) / 4;
+        registeredCount_ += boxCount[c];
+    }
+    cellStart_[cellCount] = blockCount;
+
+    BoxBlock empty {};
+    for (int c = 0; c < 3; ++c) {
+        for (int lane = 0; lane < 4; ++lane) {
+            empty.half[c][lane] = kEmptyHalf;
+        }
+    }
+    for (int lane = 0; lane < 4; ++lane) {
+        empty.index[lane] = UINT32_MAX;
+    }
+    blocks_.assign(blockCount, empty);
+
+    // -----------------------------
+    // 箱をレーンに詰める
+    // -----------------------------
+    std::vector<uint32_t> filled(cellCount, 0);
+    for (size_t i = 0; i < boxes_.size(); ++i) {
+        const Box& box = boxes_[i];
+        uint32_t x0, x1, z0, z1;
+        cellRange(i, x0, x1, z0, z1);
+        for (uint32_t z = z0; z <= z1; ++z) {
+            for (uint32_t x = x0; x <= x1; ++x) {
+                const uint32_t cell = z * cellsX_ + x;
+                const uint32_t slot = filled[cell]++;
+                BoxBlock& block = blocks_[cellStart_[cell] + slot / 4];
+                const uint32_t lane = slot % 4;
+
+                block.center[0][lane] = box.center.x;
+                block.center[1][lane] = box.center.y;
+                block.center[2][lane] = box.center.z;
+                for (int k = 0; k < 3; ++k) {
+                    block.axis[k][0][lane] = box.axis[k].x;
+                    block.axis[k][1][lane] = box.axis[k].y;
+                    block.axis[k][2][lane] = box.axis[k].z;
+                }
+                block.half[0][lane] = box.half.x;
+                block.half[1][lane] = box.half.y;
+                block.half[2][lane] = box.half.z;
+                block.index[lane] = static_cast<uint32_t>(i);
+            }
+        }
+    }
+}
+#pragma endregion
+
+#pragma region 判定
+bool ParticleCollisionWorld::FindCell(const Vector3& position, float minY, float maxY, uint32_t& outCell) const
+{
+    if (position.y < minY || position.y > maxY) {
+        return false;
+    }
+    const float fx = (position.x - originX_) * invCellSize_;
+    const float fz = (position.z - originZ_) * invCellSize_;
+    if (!(fx >= 0.0f && fz >= 0.0f && fx < static_cast<float>(cellsX_) && fz < static_cast<float>(cellsZ_))) {
+        return false;
+    }
+    outCell = static_cast<uint32_t>(fz) * cellsX_ + static_cast<uint32_t>(fx);
+    return true;
+}
+
+bool ParticleCollisionWorld::ResolveInCell(uint32_t cell, uint32_t& nextBox, Vector3& position, Vector3& velocity, float& currentTime,
+    float lifeTime, const ParticleCollisionResponse& response) const
+{
+    for (uint32_t b = cellStart_[cell]; b < cellStart_[cell + 1]; ++b) {
+        const BoxBlock& block = blocks_[b];
+
+        // 4 枚まとめて「中にいるか」だけ調べる（押し出しは当たったレーンだけスカラーで）
+        int mask = 0;
+#if defined(MATH_USE_SSE)
+        {
+            const __m128 radius = _mm_set1_ps(response.radius);
+            const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+            const __m128 dx = _mm_sub_ps(_mm_set1_ps(position.x), _mm_load_ps(block.center[0]));
+            const __m128 dy = _mm_sub_ps(_mm_set1_ps(position.y), _mm_load_ps(block.center[1]));
+            const __m128 dz = _mm_sub_ps(_mm_set1_ps(position.z), _mm_load_ps(block.center[2]));
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (int k = 0; k < 3; ++k) {
+                __m128 local = _mm_mul_ps(dx, _mm_load_ps(block.axis[k][0]));
+                local = _mm_add_ps(local, _mm_mul_ps(dy, _mm_load_ps(block.axis[k][1])));
+                local = _mm_add_ps(local, _mm_mul_ps(dz, _mm_load_ps(block.axis[k][2])));
+                const __m128 limit = _mm_add_ps(_mm_load_ps(block.half[k]), radius);
+                inside = _mm_and_ps(inside, _mm_cmplt_ps(_mm_and_ps(local, absMask), limit));
+            }
+            mask = _mm_movemask_ps(inside);
+        }
+#else
+        for (int lane = 0; lane < 4; ++lane) {
+            const float dx = position.x - block.center[0][lane];
+            const float dy = position.y - block.center[1][lane];
+            const float dz = position.z - block.center[2][lane];
+            bool inside = true;
+            for (int k = 0; k < 3 && inside; ++k) {
+                const float local = dx * block.axis[k][0][lane] + dy * block.axis[k][1][lane] + dz * block.axis[k][2][lane];
+                inside = std::abs(local) < block.half[k][lane] + response.radius;
+            }
+            mask |= inside ? (1 << lane) : 0;
+        }
+#endif
+        if (mask == 0) {
+            continue;
+        }
+
+        for (int lane = 0; lane < 4; ++lane) {
+            if ((mask & (1 << lane)) == 0 || block.index[lane] < nextBox) {
+                continue;
+            }
+            const Vector3 center { block.center[0][lane], block.center[1][lane], block.center[2][lane] };
+            const Vector3 axis[3] = {
+                { block.axis[0][0][lane], block.axis[0][1][lane], block.axis[0][2][lane] },
+                { block.axis[1][0][lane], block.axis[1][1][lane], block.axis[1][2][lane] },
+                { block.axis[2][0][lane], block.axis[2][1][lane], block.axis[2][2][lane] },
+            };
+            const Vector3 half { block.half[0][lane], block.half[1][lane], block.half[2][lane] };
+
+            Vector3 normal;
+            float depth;
+            if (!PointVsBox(position, center, axis, half, response.radius, normal, depth)) {
+                continue;
+            }
+            ApplyResponse(response, normal, depth, position, velocity, currentTime, lifeTime);
+            nextBox = block.index[lane] + 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t ParticleCollisionWorld::Resolve(const Batch& batch, const ParticleCollisionResponse& response) const
+{
+    if (response.mode == ParticleCollisionMode::None) {
+        return 0;
+    }
+
+    // 余白より大きい半径は登録していないセルの壁にも届くので、グリッドを使わずに調べる
+    if (response.radius > builtMargin_) {
+        return ResolveBruteForce(batch, response);
+    }
+
+    const bool hasGrid = !blocks_.empty();
+    const float groundLimit = groundHeight_ + response.radius;
+    // 余白込みの高さの範囲（半径は余白以下なのでこの外の粒子はどの壁にも当たらない）
+    const float wallMinY = minY_;
+    const float wallMaxY = maxY_;
+
+    uint32_t hits = 0;
+    for (uint32_t i = 0; i < batch.count; ++i) {
+        Vector3& position = batch.position[i];
+        bool hit = false;
+
+        // 地面
+        if (hasGround_ && position.y < groundLimit) {
+            ApplyResponse(response, { 0.0f, 1.0f, 0.0f }, groundLimit - position.y,
+                position, batch.velocity[i], batch.currentTime[i], batch.lifeTime[i]);
+            hit = true;
+            if (response.mode == ParticleCollisionMode::Kill) {
+                ++hits;
+                continue;
+            }
+        }
+
+        // 壁（高さの範囲外・グリッドの外は調べない）
+        // 1 枚押し出すたびにセルを引き直し、総当たりと同じく番号順に次の壁から続ける
+        // （押し出しで隣のセルに移ると、元のセルには登録されていない壁に当たることがあるため）
+        uint32_t cell = 0;
+        uint32_t nextBox = 0;
+        bool inGrid = hasGrid && FindCell(position, wallMinY, wallMaxY, cell);
+        while (inGrid && ResolveInCell(cell, nextBox, position, batch.velocity[i], batch.currentTime[i], batch.lifeTime[i], response)) {
+            hit = true;
+            if (response.mode == ParticleCollisionMode::Kill) {
+                break;
+            }
+            inGrid = FindCell(position, wallMinY, wallMaxY, cell);
+        }
+
+        hits += hit ? 1 : 0;
+    }
+    return hits;
+}
+
+uint32_t ParticleCollisionWorld::ResolveBruteForce(const Batch& batch, const ParticleCollisionResponse& response) const
+{
+    if (response.mode == ParticleCollisionMode::None) {
+        return 0;
+    }
+
+    const float groundLimit = groundHeight_ + response.radius;
+
+    uint32_t hits = 0;
+    for (uint32_t i = 0; i < batch.count; ++i) {
+        Vector3& position = batch.position[i];
+        bool hit = false;
+
+        if (hasGround_ && position.y < groundLimit) {
+            ApplyResponse(response, { 0.0f, 1.0f, 0.0f }, groundLimit - position.y,
+                position, batch.velocity[i], batch.currentTime[i], batch.lifeTime[i]);
+            hit = true;
+            if (response.mode == ParticleCollisionMode::Kill) {
+                ++hits;
+                continue;
+            }
+        }
+
+        for (const Box& box : boxes_) {
+            Vector3 normal;
+            float depth;
+            if (!PointVsBox(position, box.center, box.axis, box.half, response.radius, normal, depth)) {
+                continue;
+            }
+            ApplyResponse(response, normal, depth, position, batch.velocity[i], batch.currentTime[i], batch.lifeTime[i]);
+            hit = true;
+            if (response.mode == ParticleCollisionMode::Kill) {
+                break;
+            }
+        }
+
+        hits += hit ? 1 : 0;
+    }
+    return hits;
+}
+#pragma endregion
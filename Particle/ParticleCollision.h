@@ -0,0 +1,139 @@
+#pragma once
+#include "MathStruct.h"
+#include <cstdint>
+#include <vector>
+
+// ===============================
+// パーティクルと壁・地面の当たり判定
+// ===============================
+// 壁（AABB / OBB）を XZ の一様グリッドに登録しておき、粒子は自分のいるセルの壁だけ調べる
+// セル内の壁は 4 枚ずつ SoA に並べ直してあり、1 粒子 vs 4 枚を SSE でまとめて判定する
+// 壁の数が増えても 1 粒子あたりの判定数はセル内の枚数でほぼ決まる
+// D3D に依存しないのでベンチマークからも使える
+enum class ParticleCollisionMode {
+    None,
+    // 法線方向に跳ね返る
+    Bounce,
+    // その場で止まる
+    Stick,
+    // 寿命を終わらせる（次の Update で消える）
+    Kill,
+};
+
+// グループごとの当たった時の反応
+struct ParticleCollisionResponse {
+    ParticleCollisionMode mode = ParticleCollisionMode::None;
+    // Bounce: 法線方向の速度に掛ける反発係数
+    float restitution = 0.4f;
+    // Bounce: 接線方向の速度を減らす割合（0 ～ 1）
+    float friction = 0.2f;
+    // 粒子の半径（壁・地面をこの分太らせて判定）
+    float radius = 0.0f;
+};
+
+class ParticleCollisionWorld {
+
+public:
+    // 1 回の Resolve に渡す粒子（SoA の各配列の先頭）
+    struct Batch {
+        Vector3* position;
+        Vector3* velocity;
+        float* currentTime;
+        const float* lifeTime;
+        uint32_t count;
+    };
+
+    // セルの一辺（ワールド単位）
+    static constexpr float kDefaultCellSize = 4.0f;
+    // 1 軸あたりのセル数の上限（超える広さならセルを大きくする）
+    static constexpr uint32_t kMaxCellsPerAxis = 256;
+    // 壁をセルに登録する時の余白の最小値（粒子の中心が隣のセルにあっても半径ぶんは当たるように）
+    // SetMaxRadius でこれより大きい半径を指定すると、余白もその半径まで広げて登録する
+    static constexpr float kRegisterMargin = 0.5f;
+    // 押し出しは余白より大きく動くことがあるので、Resolve は押し出すたびにセルを引き直して続きを調べる
+
+    // 壁を全部消す（地面はそのまま）
+    void Clear();
+
+    // axis は箱のローカル軸（ワールド向きの単位ベクトル）
+    void AddBox(const Vector3& center, const Vector3& half, const Vector3 (&axis)[3]);
+    void AddAABB(const Vector3& center, const Vector3& half);
+
+    // 地面（この高さより下に行かない）
+    void SetGround(float height)
+    {
+        groundHeight_ = height;
+        hasGround_ = true;
+    }
+    void ClearGround() { hasGround_ = false; }
+
+    void SetCellSize(float cellSize) { cellSize_ = (cellSize > 0.0f) ? cellSize : kDefaultCellSize; }
+    // 使う粒子の半径の上限（余白は kRegisterMargin とこの大きい方。変えたら Build し直す）
+    void SetMaxRadius(float radius) { maxRadius_ = (radius > 0.0f) ? radius : 0.0f; }
+
+    // 追加した壁からグリッドを作る（壁を変えたら呼び直す）
+    void Build();
+
+    // 壁・地面にめり込んだ粒子を押し出して反応させる。当たった数を返す
+    // batch の範囲にしか書かないので、範囲が重ならなければ複数スレッドから呼んでよい
+    // response.radius が Build 時の余白より大きいとセルでは取りこぼすので、その時は総当たりで調べる
+    uint32_t Resolve(const Batch& batch, const ParticleCollisionResponse& response) const;
+    // グリッドを使わず全部の壁を調べる（比較・ベンチマーク用）
+    uint32_t ResolveBruteForce(const Batch& batch, const ParticleCollisionResponse& response) const;
+
+    bool Empty() const { return boxes_.empty() && !hasGround_; }
+    uint32_t GetBoxCount() const { return static_cast<uint32_t>(boxes_.size()); }
+    uint32_t GetCellCount() const { return cellsX_ * cellsZ_; }
+    float GetCellSize() const { return builtCellSize_; }
+    // Build で使った余白（これ以下の半径ならグリッドで調べられる）
+    float GetRegisterMargin() const { return builtMargin_; }
+    // 全セルの登録数（1 枚の壁が複数セルにまたがると重複して数える）
+    uint32_t GetRegisteredCount() const { return registeredCount_; }
+
+private:
+    struct Box {
+        Vector3 center;
+        Vector3 half;
+        Vector3 axis[3];
+    };
+
+    // セル内の壁 4 枚ぶん（[成分][レーン]）。空きレーンは half を負にして当たらないようにする
+    struct alignas(16) BoxBlock {
+        float center[3][4];
+        // axis[k][c][lane] : k 番目のローカル軸の c 成分
+        float axis[3][3][4];
+        float half[3][4];
+        // boxes_ での番号（セル内は番号順に並ぶ）
+        uint32_t index[4];
+    };
+
+    // position がいるセル（高さの範囲外・グリッドの外なら false）
+    bool FindCell(const Vector3& position, float minY, float maxY, uint32_t& outCell) const;
+    // セル内の番号 nextBox 以降の壁で最初に当たったもの 1 枚だけ押し出す（当たったら true、nextBox はその次に進む）
+    bool ResolveInCell(uint32_t cell, uint32_t& nextBox, Vector3& position, Vector3& velocity, float& currentTime, float lifeTime,
+        const ParticleCollisionResponse& response) const;
+
+private:
+    std::vector<Box> boxes_;
+
+    float cellSize_ = kDefaultCellSize;
+    float builtCellSize_ = kDefaultCellSize;
+    float invCellSize_ = 1.0f / kDefaultCellSize;
+    float maxRadius_ = 0.0f;
+    float builtMargin_ = kRegisterMargin;
+    float originX_ = 0.0f;
+    float originZ_ = 0.0f;
+    uint32_t cellsX_ = 0;
+    uint32_t cellsZ_ = 0;
+    // 余白ぶん太らせた全壁の高さの範囲（外なら壁は調べない）
+    float minY_ = 0.0f;
+    float maxY_ = 0.0f;
+
+    // セル c の壁は blocks_[cellStart_[c], cellStart_[c + 1])
+    std::vector<uint32_t> cellStart_;
+    std::vector<BoxBlock> blocks_;
+    uint32_t registeredCount_ = 0;
+
+    float groundHeight_ = 0.0f;
+    bool hasGround_ = false;
+};
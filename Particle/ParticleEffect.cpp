@@ -0,0 +1,384 @@
+#include "ParticleEffect.h"
+#include "CurlNoiseField.h"
+#include "SinCos.h"
+#include "../externals/nlohmann/json.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <numbers>
+#include <sstream>
+
+using json = nlohmann::json;
+
+#pragma region 読み込み
+namespace {
+
+Vector3 ReadVec3(const json& j, const Vector3& fallback)
+{
+    return Vector3 {
+        j.value("x", fallback.x),
+        j.value("y", fallback.y),
+        j.value("z", fallback.z)
+    };
+}
+
+Vector4 ReadColor(const json& j, const Vector4& fallback)
+{
+    return Vector4 {
+        j.value("r", fallback.x),
+        j.value("g", fallback.y),
+        j.value("b", fallback.z),
+        j.value("a", fallback.w)
+    };
+}
+
+// {"min": a, "max": b} または数値 1 個（min = max）
+void ReadRange(const json& j, float& outMin, float& outMax)
+{
+    if (j.is_number()) {
+        outMin = outMax = j.get<float>();
+        return;
+    }
+    outMin = j.value("min", outMin);
+    outMax = j.value("max", outMax);
+}
+
+ParticleSpawnShape ReadShape(const std::string& s)
+{
+    if (s == "box") return ParticleSpawnShape::Box;
+    if (s == "sphere") return ParticleSpawnShape::Sphere;
+    if (s == "ring") return ParticleSpawnShape::Ring;
+    return ParticleSpawnShape::Point;
+}
+
+// キー列（t 昇順）を折れ線として表にする。キーが無ければ何もしない
+template <class T, class ReadValue, class Lerp>
+void BakeCurve(const json& keys, T (&lut)[ParticleEffect::kLutSize], ReadValue readValue, Lerp lerp)
+{
+    if (!keys.is_array() || keys.empty()) {
+        return;
+    }
+
+    std::vector<std::pair<float, T>> points;
+    points.reserve(keys.size());
+    for (const json& key : keys) {
+        points.emplace_back(key.value("t", 0.0f), readValue(key));
+    }
+    std::stable_sort(points.begin(), points.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    for (uint32_t k = 0; k < ParticleEffect::kLutSize; ++k) {
+        const float t = static_cast<float>(k) / static_cast<float>(ParticleEffect::kLutSize - 1);
+
+        if (t <= points.front().first) {
+            lut[k] = points.front().second;
+            continue;
+        }
+        if (t >= points.back().first) {
+            lut[k] = points.back().second;
+            continue;
+        }
+
+        size_t seg = 1;
+        while (points[seg].first < t) {
+            ++seg;
+        }
+        const auto& a = points[seg - 1];
+        const auto& b = points[seg];
+        const float span = b.first - a.first;
+        const float u = (span > 0.0f) ? (t - a.first) / span : 1.0f;
+        lut[k] = lerp(a.second, b.second, u);
+    }
+}
+
+} // namespace
+
+ParticleEffect::ParticleEffect()
+{
+    for (uint32_t k = 0; k < kLutSize; ++k) {
+        const float t = static_cast<float>(k) / static_cast<float>(kLutSize - 1);
+        colorLut[k] = { 1.0f, 1.0f, 1.0f, 1.0f - t };
+        scaleLut[k] = 1.0f;
+    }
+}
+
+uint32_t ParticleEffect::LutIndex(float age, float lifeTime)
+{
+    // min/max は分岐なしの命令になる
+    const float t = (std::min)((std::max)(age / lifeTime, 0.0f), 1.0f);
+    return static_cast<uint32_t>(t * static_cast<float>(kLutSize - 1) + 0.5f);
+}
+
+uint32_t ParticleEffect::FrameIndex(float age, float lifeTime) const
+{
+    const float t = (std::min)((std::max)(age / lifeTime, 0.0f), 1.0f);
+    const uint32_t frame = static_cast<uint32_t>(t * flipbookCycles * static_cast<float>(frameCount));
+    // 最後の瞬間（t = 1）は次の周の 0 コマ目ではなく最後のコマにする
+    return (t >= 1.0f) ? frameCount - 1 : frame % frameCount;
+}
+
+bool ParticleEffectLoader::Parse(const std::string& text, ParticleEffect& out, std::string* error)
+{
+    try {
+        const json root = json::parse(text);
+
+        ParticleEffect effect;
+        effect.name = root.value("name", std::string());
+
+        if (root.contains("spawn")) {
+            const json& spawn = root["spawn"];
+            effect.shape = ReadShape(spawn.value("shape", std::string("point")));
+            if (spawn.contains("extents")) effect.extents = ReadVec3(spawn["extents"], effect.extents);
+            effect.radius = spawn.value("radius", effect.radius);
+        }
+
+        if (root.contains("velocity")) {
+            const json& velocity = root["velocity"];
+            if (velocity.contains("speed")) ReadRange(velocity["speed"], effect.speedMin, effect.speedMax);
+            if (velocity.contains("min")) effect.velocityMin = ReadVec3(velocity["min"], effect.velocityMin);
+            if (velocity.contains("max")) effect.velocityMax = ReadVec3(velocity["max"], effect.velocityMax);
+        }
+
+        if (root.contains("lifeTime")) ReadRange(root["lifeTime"], effect.lifeTimeMin, effect.lifeTimeMax);
+        if (root.contains("scale")) effect.scale = ReadVec3(root["scale"], effect.scale);
+        if (root.contains("color")) effect.color = ReadColor(root["color"], effect.color);
+        if (root.contains("gravity")) effect.gravity = ReadVec3(root["gravity"], effect.gravity);
+        effect.drag = root.value("drag", effect.drag);
+        effect.texture = root.value("texture", effect.texture);
+        if (root.contains("flipbook")) {
+            const json& flipbook = root["flipbook"];
+            effect.flipbookColumns = (std::max)(flipbook.value("columns", effect.flipbookColumns), 1u);
+            effect.flipbookRows = (std::max)(flipbook.value("rows", effect.flipbookRows), 1u);
+            const uint32_t cells = effect.flipbookColumns * effect.flipbookRows;
+            effect.frameCount = std::clamp(flipbook.value("frames", cells), 1u, cells);
+            effect.flipbookCycles = (std::max)(flipbook.value("cycles", effect.flipbookCycles), 0.0f);
+        }
+        if (root.contains("turbulence")) {
+            const json& turbulence = root["turbulence"];
+            effect.turbulence = turbulence.value("strength", effect.turbulence);
+            effect.turbulenceFrequency = turbulence.value("frequency", effect.turbulenceFrequency);
+        }
+
+        if (root.contains("colorOverLife")) {
+            BakeCurve(root["colorOverLife"], effect.colorLut,
+                [](const json& key) { return ReadColor(key.at("color"), Vector4 { 1.0f, 1.0f, 1.0f, 1.0f }); },
+                [](const Vector4& a, const Vector4& b, float u) {
+                    return Vector4 { a.x + (b.x - a.x) * u, a.y + (b.y - a.y) * u, a.z + (b.z - a.z) * u, a.w + (b.w - a.w) * u };
+                });
+        }
+        if (root.contains("scaleOverLife")) {
+            BakeCurve(root["scaleOverLife"], effect.scaleLut,
+                [](const json& key) { return key.value("value", 1.0f); },
+                [](float a, float b, float u) { return a + (b - a) * u; });
+        }
+
+        if (effect.lifeTimeMin <= 0.0f || effect.lifeTimeMax < effect.lifeTimeMin) {
+            if (error) *error = "lifeTime must satisfy 0 < min <= max";
+            return false;
+        }
+
+        out = std::move(effect);
+        return true;
+    } catch (const json::exception& e) {
+        if (error) *error = e.what();
+        return false;
+    }
+}
+
+bool ParticleEffectLoader::LoadFile(const std::string& path, ParticleEffect& out, std::string* error)
+{
+    std::ifstream ifs(std::filesystem::path(path), std::ios::binary);
+    if (!ifs.is_open()) {
+        if (error) *error = "cannot open " + path;
+        return false;
+    }
+
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+    if (!Parse(ss.str(), out, error)) {
+        return false;
+    }
+    if (out.name.empty()) {
+        out.name = std::filesystem::path(path).stem().string();
+    }
+    return true;
+}
+
+std::vector<ParticleEffect> ParticleEffectLoader::LoadDirectory(const std::string& directory)
+{
+    std::vector<ParticleEffect> effects;
+
+    std::error_code ec;
+    const std::filesystem::path dir = std::filesystem::path(directory);
+    if (!std::filesystem::is_directory(dir, ec)) {
+        return effects;
+    }
+
+    // 読み込み順を環境によらず固定する
+    std::vector<std::filesystem::path> files;
+    for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".json") {
+            files.push_back(entry.path());
+        }
+    }
+    std::sort(files.begin(), files.end());
+
+    for (const auto& file : files) {
+        ParticleEffect effect;
+        if (LoadFile(file.string(), effect)) {
+            effects.push_back(std::move(effect));
+        }
+    }
+    return effects;
+}
+#pragma endregion
+
+#pragma region 発生・更新
+void ParticleKernel::Spawn(const ParticleEffect& effect, ParticlePool& pool, uint32_t first, uint32_t count,
+    const Vector3& position, Random& random, std::vector<float>& scratch, std::vector<Vector3>& directions)
+{
+    if (count == 0) {
+        return;
+    }
+
+    // -----------------------------
+    // 乱数を種類ごとにまとめて生成（消費順は固定）
+    // -----------------------------
+    // [0, 3n) : 発生位置 / [3n, 4n) : 速さ / [4n, 7n) : 軸ごとの速度 / [7n, 8n) : 寿命
+    const size_t n = count;
+    scratch.resize(n * 8);
+    directions.resize(n * 2);
+    float* spawn = scratch.data();
+    float* speed = spawn + n * 3;
+    float* velocity = speed + n;
+    float* life = velocity + n * 3;
+    Vector3* spawnDir = directions.data();
+    Vector3* velocityDir = spawnDir + n;
+
+    // 発生位置は発生点からのオフセットとして spawn[3k..3k+2] に入れる
+    switch (effect.shape) {
+    case ParticleSpawnShape::Point:
+        std::fill(spawn, spawn + n * 3, 0.0f);
+        break;
+
+    case ParticleSpawnShape::Box:
+        random.FillUniform(spawn, n * 3, -1.0f, 1.0f);
+        for (size_t k = 0; k < n; ++k) {
+            spawn[k * 3 + 0] *= effect.extents.x;
+            spawn[k * 3 + 1] *= effect.extents.y;
+            spawn[k * 3 + 2] *= effect.extents.z;
+        }
+        break;
+
+    case ParticleSpawnShape::Sphere:
+        // 体積で一様にするため半径は u^(1/3)
+        random.FillUnitVectors(spawnDir, n);
+        random.FillUniform(spawn, n, 0.0f, 1.0f);
+        for (size_t k = n; k-- > 0;) {
+            const float r = effect.radius * std::cbrt(spawn[k]);
+            spawn[k * 3 + 0] = spawnDir[k].x * r;
+            spawn[k * 3 + 1] = spawnDir[k].y * r;
+            spawn[k * 3 + 2] = spawnDir[k].z * r;
+        }
+        break;
+
+    case ParticleSpawnShape::Ring: {
+        // 角度 → sin/cos は作業領域の後ろ半分を借りる
+        float* angle = spawn + n * 2;
+        float* s = velocity;
+        float* c = velocity + n;
+        random.FillUniform(angle, n, 0.0f, 2.0f * std::numbers::pi_v<float>);
+        SinCosMath::SinCosArray(angle, s, c, n, SinCosMode::Fast);
+        for (size_t k = 0; k < n; ++k) {
+            spawn[k * 3 + 0] = c[k] * effect.radius;
+            spawn[k * 3 + 1] = 0.0f;
+            spawn[k * 3 + 2] = s[k] * effect.radius;
+        }
+        break;
+    }
+    }
+
+    // 全方向成分（速さの幅が 0 なら乱数を引かない）
+    const bool radial = effect.speedMax != 0.0f || effect.speedMin != 0.0f;
+    if (radial) {
+        random.FillUnitVectors(velocityDir, n);
+        random.FillUniform(speed, n, effect.speedMin, effect.speedMax);
+    } else {
+        std::fill(velocityDir, velocityDir + n, Vector3 { 0.0f, 0.0f, 0.0f });
+        std::fill(speed, speed + n, 0.0f);
+    }
+
+    // 軸ごとの成分（min == max の軸は定数）
+    const float axisMin[3] = { effect.velocityMin.x, effect.velocityMin.y, effect.velocityMin.z };
+    const float axisMax[3] = { effect.velocityMax.x, effect.velocityMax.y, effect.velocityMax.z };
+    for (int axis = 0; axis < 3; ++axis) {
+        float* dst = velocity + n * axis;
+        if (axisMin[axis] != axisMax[axis]) {
+            random.FillUniform(dst, n, axisMin[axis], axisMax[axis]);
+        } else {
+            std::fill(dst, dst + n, axisMin[axis]);
+        }
+    }
+
+    random.FillUniform(life, n, effect.lifeTimeMin, effect.lifeTimeMax);
+
+    // -----------------------------
+    // 連続領域に書き込む
+    // -----------------------------
+    for (size_t k = 0; k < n; ++k) {
+        const uint32_t i = first + static_cast<uint32_t>(k);
+
+        pool.translate[i] = {
+            position.x + spawn[k * 3 + 0],
+            position.y + spawn[k * 3 + 1],
+            position.z + spawn[k * 3 + 2]
+        };
+        pool.previousTranslate[i] = pool.translate[i];
+        pool.rotate[i] = { 0.0f, 0.0f, 0.0f };
+        pool.scale[i] = effect.scale;
+        pool.velocity[i] = {
+            velocityDir[k].x * speed[k] + velocity[k],
+            velocityDir[k].y * speed[k] + velocity[n + k],
+            velocityDir[k].z * speed[k] + velocity[n * 2 + k]
+        };
+        pool.color[i] = effect.color;
+        pool.lifeTime[i] = life[k];
+        pool.currentTime[i] = 0.0f;
+    }
+}
+
+void ParticleKernel::Integrate(const ParticleEffect& effect, ParticlePool& pool, uint32_t begin, uint32_t end, float stepTime,
+    const CurlNoiseField* turbulence)
+{
+    // ステップ内で一定の係数は先に求めておく（抵抗なし・重力なしなら v はそのまま）
+    const float damping = std::exp(-effect.drag * stepTime);
+    const Vector3 gravityStep = effect.gravity * stepTime;
+
+    if (turbulence && !turbulence->Empty() && effect.turbulence != 0.0f) {
+        // 場は kTurbulenceBlock 個ずつまとめて引く（スタック上に置くのでジョブごとの確保は無し）
+        constexpr uint32_t kTurbulenceBlock = 64;
+        Vector3 flow[kTurbulenceBlock];
+        const float flowStep = effect.turbulence * stepTime;
+        for (uint32_t blockBegin = begin; blockBegin < end; blockBegin += kTurbulenceBlock) {
+            const uint32_t count = (std::min)(kTurbulenceBlock, end - blockBegin);
+            turbulence->SampleArray(&pool.translate[blockBegin], count, effect.turbulenceFrequency, flow);
+            for (uint32_t k = 0; k < count; ++k) {
+                const uint32_t i = blockBegin + k;
+                pool.previousTranslate[i] = pool.translate[i];
+                pool.currentTime[i] += stepTime;
+                pool.velocity[i] = pool.velocity[i] * damping + gravityStep;
+                pool.translate[i] += pool.velocity[i] * stepTime + flow[k] * flowStep;
+            }
+        }
+        return;
+    }
+
+    for (uint32_t i = begin; i < end; ++i) {
+        pool.previousTranslate[i] = pool.translate[i];
+        pool.currentTime[i] += stepTime;
+        pool.velocity[i] = pool.velocity[i] * damping + gravityStep;
+        pool.translate[i] += pool.velocity[i] * stepTime;
+    }
+}
+#pragma endregion
@@ -0,0 +1,111 @@
+#pragma once
+#include "MathStruct.h"
+#include "ParticlePool.h"
+#include "Random.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class CurlNoiseField;
+
+// ===============================
+// パーティクルエフェクト定義
+// ===============================
+// resources/particles/*.json から読み込む（書式は resources/particles/default.json 参照）
+// カーブは読み込み時に kLutSize 点へ事前サンプリングするので、
+// 毎フレームの評価は「添字計算 + 表引き」だけになる
+
+// 発生位置の形
+enum class ParticleSpawnShape {
+    Point,  // 発生点そのもの
+    Box,    // 発生点 ± extents の箱の中
+    Sphere, // 半径 radius の球の中（一様）
+    Ring,   // XZ 平面の半径 radius の円周上
+};
+
+struct ParticleEffect {
+    // 寿命カーブの表の点数
+    static constexpr uint32_t kLutSize = 64;
+    // texture を書かなかった時の画像
+    static constexpr const char* kDefaultTexture = "resources/circle.png";
+
+    std::string name;
+
+    // ---- 発生 ----
+    ParticleSpawnShape shape = ParticleSpawnShape::Point;
+    Vector3 extents { 0.0f, 0.0f, 0.0f };
+    float radius = 0.0f;
+
+    // ---- 初速 = 全方向の単位ベクトル × speed + 軸ごとの一様乱数 ----
+    float speedMin = 0.0f;
+    float speedMax = 0.0f;
+    Vector3 velocityMin { 0.0f, 0.0f, 0.0f };
+    Vector3 velocityMax { 0.0f, 0.0f, 0.0f };
+
+    float lifeTimeMin = 1.0f;
+    float lifeTimeMax = 1.0f;
+
+    Vector3 scale { 1.0f, 1.0f, 1.0f };
+    Vector4 color { 1.0f, 1.0f, 1.0f, 1.0f };
+
+    // ---- 運動 ----
+    Vector3 gravity { 0.0f, 0.0f, 0.0f };
+    // 速度の減衰率（1 シミュレーション単位あたり v *= exp(-drag)）
+    float drag = 0.0f;
+    // curl ノイズの乱流（速度にこの倍率で場の値を足して動かす。0 なら引かない）
+    float turbulence = 0.0f;
+    // 場を引く位置に掛ける（大きいほど細かい渦）
+    float turbulenceFrequency = 1.0f;
+
+    // ---- 見た目 ----
+    // 使う画像（ParticleManager が全エフェクトの画像を 1 枚のアトラスにまとめる）
+    std::string texture = kDefaultTexture;
+    // 画像を columns × rows のコマに分け、寿命の間に frameCount コマを flipbookCycles 周する（左上から横へ）
+    uint32_t flipbookColumns = 1;
+    uint32_t flipbookRows = 1;
+    uint32_t frameCount = 1;
+    float flipbookCycles = 1.0f;
+    // フレーム表でのこのエフェクトの先頭（ParticleManager が埋める）
+    uint32_t frameBase = 0;
+
+    // ---- 寿命（0→1）に対するカーブ。color / scale に掛ける ----
+    Vector4 colorLut[kLutSize];
+    float scaleLut[kLutSize];
+
+    // 何も読まなかった場合の既定（白・等倍・寿命で α が 1→0）
+    ParticleEffect();
+
+    // 寿命の割合 t（0～1 の外でも可）から表の添字を求める
+    static uint32_t LutIndex(float age, float lifeTime);
+    // 経過時間から何コマ目か（0 ～ frameCount - 1。frameBase は足さない）
+    uint32_t FrameIndex(float age, float lifeTime) const;
+};
+
+class ParticleEffectLoader {
+
+public:
+    // JSON 文字列から読む。失敗したら false（error に理由）
+    static bool Parse(const std::string& text, ParticleEffect& out, std::string* error = nullptr);
+    // ファイルから読む。name が空ならファイル名（拡張子なし）を使う
+    static bool LoadFile(const std::string& path, ParticleEffect& out, std::string* error = nullptr);
+    // directory 直下の *.json を全部読む（読めなかったファイルは飛ばす）
+    static std::vector<ParticleEffect> LoadDirectory(const std::string& directory);
+};
+
+// ===============================
+// エフェクトごとの発生・更新処理
+// ===============================
+// どちらもエフェクト種別で分岐しないループ（種類の違いは係数と表の中身だけ）
+class ParticleKernel {
+
+public:
+    // pool の [first, first + count) を effect に従って初期化する
+    // scratch は乱数の一時置き場（呼び出し側で使い回す）
+    static void Spawn(const ParticleEffect& effect, ParticlePool& pool, uint32_t first, uint32_t count,
+        const Vector3& position, Random& random, std::vector<float>& scratch, std::vector<Vector3>& directions);
+
+    // [begin, end) を stepTime だけ進める（重力・抵抗込み）
+    // turbulence があり effect.turbulence > 0 なら、場の速度を足した分だけ位置を流す（速度そのものは変えない）
+    static void Integrate(const ParticleEffect& effect, ParticlePool& pool, uint32_t begin, uint32_t end, float stepTime,
+        const CurlNoiseField* turbulence = nullptr);
+};
@@ -1,8 +1,6 @@
 ﻿#include "ParticleEmitter.h"
 #include "ParticleManager.h"
 
-static constexpr float kDeltaTime = 0.1f;
-
 ParticleEmitter::ParticleEmitter()
 {
     // 未初期化状態
@@ -12,25 +10,28 @@ void ParticleEmitter::Init(
     const std::string& groupName,
     const Transform& transform,
     uint32_t count,
-    float frequency)
+    float frequency,
+    const std::string& effectName)
 {
     name_ = groupName;
+    effectName_ = effectName;
     transform_ = transform;
     count_ = count;
     frequency_ = frequency;
     elapsedTime_ = 0.0f;
 }
 
-void ParticleEmitter::Update()
+void ParticleEmitter::Update(float deltaTime)
 {
     if (frequency_ <= 0.0f) {
         return; // Init 前ガード
     }
 
-    elapsedTime_ += kDeltaTime;
+    elapsedTime_ += deltaTime * ParticleManager::GetInstance()->GetTimeScale();
 
-    if (elapsedTime_ >= frequency_) {
-        ParticleManager::GetInstance()->Emit( name_, transform_.translate,count_);
+    // 処理落ちで複数回ぶん溜まったら、その回数ぶん出す
+    while (elapsedTime_ >= frequency_) {
+        ParticleManager::GetInstance()->Emit( name_, effectName_, transform_.translate,count_);
 
         elapsedTime_ -= frequency_;
     }
@@ -42,6 +43,6 @@ void ParticleEmitter::Emit()
         return; // Init 前ガード
     }
 
-    ParticleManager::GetInstance()->Emit(name_, transform_.translate, count_);
+    ParticleManager::GetInstance()->Emit(name_, effectName_, transform_.translate, count_);
 
 }
@@ -13,12 +13,16 @@ public:
         const std::string& groupName,
         const Transform& transform,
         uint32_t count,
-        float frequency);
+        float frequency,
+        const std::string& effectName = "default");
 
-    void Update();
+    // deltaTime は実時間（秒）。パーティクルと同じ時間スケールで発生間隔を数える
+    void Update(float deltaTime);
     void Emit();
 
     std::string name_;
+    // resources/particles/*.json の name
+    std::string effectName_ = "default";
 private:
     Transform transform_ {};
     uint32_t count_ = 0;
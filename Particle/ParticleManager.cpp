@@ -1,7 +1,14 @@
 #include "ParticleManager.h"
 #include "ImGuiManager.h"
+#include "ParticleAtlas.h"
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <map>
 #include <numbers>
+#include <tuple>
 #include "MathStruct.h"
 ParticleManager* ParticleManager::instance = nullptr;
 
@@ -19,8 +26,16 @@ void ParticleManager::Initialize(DirectXCommon* dxCommon, SrvManager* srvManager
     srvManager_ = srvManager;
     camera_ = camera;
 
-    // パーティクルのランダム生成に使う装置を準備
-    randomEngine_ = std::mt19937(seedGenerator_());
+    // 乱数・更新用ワーカー（ワーカーはシーンをまたいで使い回す）
+    simulation_.Initialize();
+    // インスタンスは Map したインスタンシングバッファへ直接書かせる
+    simulation_.SetInstanceBufferCallback([this](const std::string& name, uint32_t capacity) {
+        return ResizeInstancingBuffer(name, capacity);
+    });
+
+    // エフェクト定義（JSON）・乱流の場
+    LoadEffects();
+    simulation_.LoadTurbulenceField(kTurbulenceFieldPath, kTurbulenceSeed);
 
     // シェーダーにどうデータを渡すかを決める
     CreateRootSignature();
@@ -32,87 +47,33 @@ void ParticleManager::Initialize(DirectXCommon* dxCommon, SrvManager* srvManager
     CreateBoardMesh();
 }
 
-void ParticleManager::Update()
+void ParticleManager::Update(float deltaTime)
 {
     // カメラが無いなら何もしない
     if (!camera_) {
         return;
     }
 
-    // ビルボード行列（平行移動成分をゼロにして回転だけ使う）
-    Matrix4x4 cameraMat = camera_->GetWorldMatrix();
-    cameraMat.m[3][0] = 0.0f;
-    cameraMat.m[3][1] = 0.0f;
-    cameraMat.m[3][2] = 0.0f;
-    const Matrix4x4 billboardMatrix = cameraMat;
-
-    // VP 行列
-    const Matrix4x4 vp = camera_->GetViewProjectionMatrix();
-
-    // 全グループ処理
-    for (auto& [name, group] : particleGroups_) {
-
-        // ★インスタンシングが準備できてないグループはスキップ
-        if (!group.instancingResource || !group.instanceData) {
-            continue;
-        }
-
-        group.numInstance = 0;
-
-        // グループ内パーティクル
-        for (auto it = group.particles.begin(); it != group.particles.end(); ) {
-
-            Particle& p = *it;
-
-            // ★ここで listノードが壊れてるかどうかを即判定する
-            if (!std::isfinite(p.lifeTime) || !std::isfinite(p.currentTime) ||
-                !std::isfinite(p.transform.scale.x) || !std::isfinite(p.transform.scale.y) || !std::isfinite(p.transform.scale.z)) {
-                assert(false && "Particle data corrupted (memory overwrite likely)");
-            }
-
-
-
-            // 寿命
-            if (p.currentTime >= p.lifeTime) {
-                it = group.particles.erase(it);
-                continue;
-            }
-
-            // 更新
-            p.currentTime += kdeltaTime;
-            p.transform.translate += p.velocity * kdeltaTime;
-
-            // α
-            const float alpha = 1.0f - (p.currentTime / p.lifeTime);
-
-            // World 行列
-            Matrix4x4 world{};
-            if (useBillboard_) {
-                const Matrix4x4 scaleMat = MatrixMath::Matrix4x4MakeScaleMatrix(p.transform.scale);
-                const Matrix4x4 transMat = MatrixMath::MakeTranslateMatrix(p.transform.translate);
-                world = MatrixMath::Multiply(MatrixMath::Multiply(scaleMat, billboardMatrix), transMat);
-            } else {
-                world = MatrixMath::MakeAffineMatrix(p.transform.scale, p.transform.rotate, p.transform.translate);
-            }
-
-            // WVP
-            const Matrix4x4 wvp = MatrixMath::Multiply(world, vp);
-
-            // GPU へ
-            if (group.numInstance < kNumMaxInstance) {
-                group.instanceData[group.numInstance].World = world;
-                group.instanceData[group.numInstance].WVP = wvp;
-                group.instanceData[group.numInstance].color = p.color;
-                group.instanceData[group.numInstance].color.w = alpha;
-                ++group.numInstance;
-            }
-            if (group.particles.size() > 100000) {
-                assert(false && "Too many particles (emitter runaway)");
-            }
-
-            ++it;
-        }
+    // ビルボードの軸（カメラのワールド行列の 1・2 行目 = 右・上）と VP は VS に渡す
+    const Matrix4x4& cameraMat = camera_->GetWorldMatrix();
+    ParticleSimulation::View view {};
+    view.position = { cameraMat.m[3][0], cameraMat.m[3][1], cameraMat.m[3][2] };
+    view.viewProjection = camera_->GetViewProjectionMatrix();
+    view.pixelsPerUnit = camera_->GetProjectionMatrix().m[1][1] * static_cast<float>(WinApp::kClientHeight) * 0.5f;
+
+    cameraData_->viewProjection = view.viewProjection;
+    if (useBillboard_) {
+        cameraData_->right = { cameraMat.m[0][0], cameraMat.m[0][1], cameraMat.m[0][2] };
+        cameraData_->up = { cameraMat.m[1][0], cameraMat.m[1][1], cameraMat.m[1][2] };
+    } else {
+        cameraData_->right = { 1.0f, 0.0f, 0.0f };
+        cameraData_->up = { 0.0f, 1.0f, 0.0f };
     }
+
+    // 移動・寿命・LOD・天候・インスタンスの書き込みまで
+    // バッファが足りなければ ResizeInstancingBuffer が呼ばれる
+    // （PostDraw で GPU 完了を待っているので、ここで作り直しても描画中のリソースは無い）
+    simulation_.Update(deltaTime, view);
 }
 
 void ParticleManager::Draw()
@@ -122,25 +83,49 @@ void ParticleManager::Draw()
     // マテリアル（共通）
     cmd->SetGraphicsRootConstantBufferView(0, materialResource->GetGPUVirtualAddress());
 
+    // ビルボードの軸と VP（共通）
+    cmd->SetGraphicsRootConstantBufferView(3, cameraResource_->GetGPUVirtualAddress());
+
     // 頂点・インデックス（共通）
     cmd->IASetVertexBuffers(0, 1, &vertexBufferView);
     cmd->IASetIndexBuffer(&indexBufferView);
 
-    // 全パーティクルグループ
-    for (auto& [name, group] : particleGroups_) {
+    // 全パーティクルグループ（テクスチャ・フレーム表は前のグループと同じなら張り直さない）
+    drawCallCount_ = 0;
+    descriptorBindCount_ = 0;
+    D3D12_GPU_DESCRIPTOR_HANDLE boundTexture {};
+    bool boundAtlasFrames = false;
+    bool bound = false;
+    for (const auto& [name, group] : simulation_.GetParticleGroups()) {
 
         if (group.numInstance == 0) {
             continue;
         }
+        const GroupResources& resources = groupResources_.at(name);
 
         // インスタンシング SRV
-        cmd->SetGraphicsRootDescriptorTable(1, group.instancingSrvHandleGPU);
-
-        // テクスチャ SRV
-        cmd->SetGraphicsRootDescriptorTable(2, TextureManager::GetInstance()->GetSrvHandleGPU(group.texturePath));
+        cmd->SetGraphicsRootDescriptorTable(1, resources.instancingSrvHandleGPU);
+
+        // テクスチャ SRV・フレーム表（アトラスを使うグループ同士なら 1 回だけ）
+        const bool useAtlas = resources.texturePath.empty();
+        const D3D12_GPU_DESCRIPTOR_HANDLE texture = useAtlas
+            ? atlasSrvHandle_
+            : TextureManager::GetInstance()->GetSrvHandleGPU(resources.texturePath);
+        if (!bound || texture.ptr != boundTexture.ptr) {
+            cmd->SetGraphicsRootDescriptorTable(2, texture);
+            boundTexture = texture;
+            ++descriptorBindCount_;
+        }
+        if (!bound || useAtlas != boundAtlasFrames) {
+            cmd->SetGraphicsRootDescriptorTable(4, srvManager_->GetGPUDescriptorHandle(frameSrvIndices_[useAtlas ? 0 : 1]));
+            boundAtlasFrames = useAtlas;
+            ++descriptorBindCount_;
+        }
+        bound = true;
 
         // 描画
         cmd->DrawIndexedInstanced(6, group.numInstance, 0, 0, 0);
+        ++drawCallCount_;
     }
 }
 
@@ -170,8 +155,16 @@ void ParticleManager::CreateRootSignature()
     texRange.RegisterSpace = 0;
     texRange.OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
 
+    // ========= SRV (t2) : フレーム表（コマの UV 範囲） =========
+    D3D12_DESCRIPTOR_RANGE frameRange {};
+    frameRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+    frameRange.NumDescriptors = 1;
+    frameRange.BaseShaderRegister = 2; // t2
+    frameRange.RegisterSpace = 0;
+    frameRange.OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
+
     // ========= RootParameters =========
-    D3D12_ROOT_PARAMETER rootParams[3] = {};
+    D3D12_ROOT_PARAMETER rootParams[5] = {};
 
     // [0] Material (b0, PS)
     rootParams[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
@@ -190,6 +183,17 @@ void ParticleManager::CreateRootSignature()
     rootParams[2].DescriptorTable.NumDescriptorRanges = 1;
     rootParams[2].DescriptorTable.pDescriptorRanges = &texRange;
 
+    // [3] Camera (b1, VS)
+    rootParams[3].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+    rootParams[3].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+    rootParams[3].Descriptor.ShaderRegister = 1; // b1
+
+    // [4] Frame table SRV (t2, VS)
+    rootParams[4].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+    rootParams[4].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+    rootParams[4].DescriptorTable.NumDescriptorRanges = 1;
+    rootParams[4].DescriptorTable.pDescriptorRanges = &frameRange;
+
     // ========= Sampler =========
     D3D12_STATIC_SAMPLER_DESC sampler {};
     sampler.Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
@@ -309,41 +313,17 @@ void ParticleManager::CreateGraphicsPipeline()
 void ParticleManager::CreateBoardMesh()
 {
     // ===========================
-    //  頂点データ作成
-    // ===========================
-
-    // 左上
-    vertices[0].position = { -0.5f, 0.5f, 0, -1.0f };
-    vertices[0].texcoord = { 0, 0 };
-    vertices[0].normal = { 0, 0, -1 };
-
-    // 右上
-    vertices[1].position = { 0.5f, 0.5f, 0, -1.0f };
-    vertices[1].texcoord = { 1, 0 };
-    vertices[1].normal = { 0, 0, -1 };
-
-    // 右下
-    vertices[2].position = { 0.5f, -0.5f, 0, -1.0f };
-    vertices[2].texcoord = { 1, 1 };
-    vertices[2].normal = { 0, 0, -1 };
-
-    // 左下
-    vertices[3].position = { -0.5f, -0.5f, 0, -1.0f };
-    vertices[3].texcoord = { 0, 1 };
-    vertices[3].normal = { 0, 0, -1 };
-
-    // ===========================
-    //  頂点バッファ作成
+    //  頂点バッファ作成（頂点データは kBoardVertices）
     // ===========================
-    vertexResource = dxCommon_->CreateBufferResource(sizeof(vertices));
+    vertexResource = dxCommon_->CreateBufferResource(sizeof(kBoardVertices));
     vertexResource->SetName(L"ParticleManager::VertexBuffer");
     VertexData* vbData = nullptr;
     vertexResource->Map(0, nullptr, reinterpret_cast<void**>(&vbData));
-    memcpy(vbData, vertices, sizeof(vertices));
+    memcpy(vbData, kBoardVertices, sizeof(kBoardVertices));
     vertexResource->Unmap(0, nullptr);
 
     vertexBufferView.BufferLocation = vertexResource->GetGPUVirtualAddress();
-    vertexBufferView.SizeInBytes = sizeof(vertices);
+    vertexBufferView.SizeInBytes = sizeof(kBoardVertices);
     vertexBufferView.StrideInBytes = sizeof(VertexData);
 
     // ===========================
@@ -387,6 +367,16 @@ void ParticleManager::CreateBoardMesh()
     *lightCB = lightData_;
     lightResource->Unmap(0, nullptr);
 
+    // ===========================
+    //  CameraCB作成（Root[3]、Map したまま毎フレーム書く）
+    // ===========================
+    cameraResource_ = dxCommon_->CreateBufferResource(sizeof(ParticleCameraForGPU));
+    cameraResource_->SetName(L"ParticleManager::CameraCB");
+    cameraResource_->Map(0, nullptr, reinterpret_cast<void**>(&cameraData_));
+    cameraData_->viewProjection = camera_->GetViewProjectionMatrix();
+    cameraData_->right = { 1.0f, 0.0f, 0.0f };
+    cameraData_->up = { 0.0f, 1.0f, 0.0f };
+
     // ===========================
     //  テクスチャSRVハンドル取得
     // ===========================
@@ -441,20 +431,21 @@ void ParticleManager::Finalize()
     // -------------------------
     // ParticleGroup ごとに解放
     // -------------------------
-    for (auto& [name, group] : particleGroups_) {
+    for (auto& [name, resources] : groupResources_) {
 
         // Unmap
-        if (group.instancingResource && group.instanceData) {
-            group.instancingResource->Unmap(0, nullptr);
-            group.instanceData = nullptr;
+        if (resources.instancingResource && resources.instanceData) {
+            resources.instancingResource->Unmap(0, nullptr);
+            resources.instanceData = nullptr;
         }
 
         // GPUリソース解放
-        group.instancingResource.Reset();
+        resources.instancingResource.Reset();
     }
 
-    // グループ自体をクリア
-    particleGroups_.clear();
+    // グループ自体をクリアしてワーカースレッド停止
+    groupResources_.clear();
+    simulation_.Finalize();
 
     // -------------------------
     // 共通リソース解放
@@ -462,6 +453,11 @@ void ParticleManager::Finalize()
     materialResource.Reset();
     transformResource.Reset();
     lightResource.Reset();
+    if (cameraResource_ && cameraData_) {
+        cameraResource_->Unmap(0, nullptr);
+        cameraData_ = nullptr;
+    }
+    cameraResource_.Reset();
     vertexResource.Reset();
     indexResource.Reset();
 
@@ -481,163 +477,330 @@ void ParticleManager::Finalize()
     instance = nullptr;*/
 }
 
+void ParticleManager::CreateParticleGroup(const std::string& name)
+{
+    CreateParticleGroup(name, std::string());
+}
+
 void ParticleManager::CreateParticleGroup(const std::string& name, const std::string& textureFilePath)
 {
     // 重複チェック
-    assert(particleGroups_.find(name) == particleGroups_.end());
+    assert(groupResources_.find(name) == groupResources_.end());
 
-    ParticleGroup group {};
+    GroupResources& resources = groupResources_[name];
 
-    //  テクスチャ設定
-    group.texturePath = textureFilePath;
-    TextureManager::GetInstance()->LoadTexture(textureFilePath);
+    //  テクスチャ設定（空ならアトラス）
+    resources.texturePath = textureFilePath;
+    if (!textureFilePath.empty()) {
+        TextureManager::GetInstance()->LoadTexture(textureFilePath);
+    }
 
-    // インスタンシングバッファ作成
-    group.instancingResource = dxCommon_->CreateBufferResource(sizeof(ParticleForGPU) * kNumMaxInstance);
-    group.instancingResource->SetName((L"ParticleManager::InstancingBuffer_" + StringUtility::ConvertString(name)).c_str());
+    //  SRV スロット確保（バッファを作り直してもスロットは使い回す）
+    resources.instancingSrvIndex = srvManager_->Allocate();
+    resources.instancingSrvHandleGPU = srvManager_->GetGPUDescriptorHandle(resources.instancingSrvIndex);
 
-    group.instancingResource->Map(0, nullptr, reinterpret_cast<void**>(&group.instanceData));
+    //  登録（インスタンシングバッファは ResizeInstancingBuffer で作られる）
+    simulation_.CreateParticleGroup(name);
+}
 
-    group.numInstance = 0;
+ParticleManager::ParticleForGPU* ParticleManager::ResizeInstancingBuffer(const std::string& name, uint32_t capacity)
+{
+    GroupResources& resources = groupResources_.at(name);
+
+    // 古いバッファは Unmap して捨てる（中身は毎フレーム書き直すのでコピー不要）
+    if (resources.instancingResource && resources.instanceData) {
+        resources.instancingResource->Unmap(0, nullptr);
+        resources.instanceData = nullptr;
+    }
 
-    //  SRV 作成
-    uint32_t srvIndex = srvManager_->Allocate();
+    resources.instancingResource = dxCommon_->CreateBufferResource(sizeof(ParticleForGPU) * capacity);
+    resources.instancingResource->SetName((L"ParticleManager::InstancingBuffer_" + StringUtility::ConvertString(name)).c_str());
 
+    resources.instancingResource->Map(0, nullptr, reinterpret_cast<void**>(&resources.instanceData));
+
+    // NumElements をバッファと揃える
     D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc {};
     srvDesc.Format = DXGI_FORMAT_UNKNOWN;
     srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
     srvDesc.ViewDimension = D3D12_SRV_DIMENSION_BUFFER;
     srvDesc.Buffer.FirstElement = 0;
-    srvDesc.Buffer.NumElements = kNumMaxInstance;
+    srvDesc.Buffer.NumElements = capacity;
     srvDesc.Buffer.StructureByteStride = sizeof(ParticleForGPU);
 
-    dxCommon_->GetDevice()->CreateShaderResourceView(group.instancingResource.Get(), &srvDesc, srvManager_->GetCPUDescriptorHandle(srvIndex));
-
-    group.instancingSrvHandleGPU = srvManager_->GetGPUDescriptorHandle(srvIndex);
-
-    //  登録
-    particleGroups_.emplace(name, std::move(group));
+    dxCommon_->GetDevice()->CreateShaderResourceView(resources.instancingResource.Get(), &srvDesc, srvManager_->GetCPUDescriptorHandle(resources.instancingSrvIndex));
+    return resources.instanceData;
 }
 
-void ParticleManager::Emit(const std::string& name, const Vector3& position, uint32_t count)
+void ParticleManager::LoadEffects()
 {
-    auto& group = particleGroups_.at(name);
+    // 古い定義を指すバッチ・天候はシミュレーション側で捨てる
+    simulation_.SetEffects(ParticleEffectLoader::LoadDirectory(kEffectDirectory));
 
-    for (uint32_t i = 0; i < count; ++i) {
-        group.particles.push_back(MakeParticleDefault(position));
-    }
+    // 画像をアトラスにまとめて、コマの表を作り直す
+    BuildFrameTable(BuildAtlas());
 }
 
-void ParticleManager::EmitFire(const std::string& name, const Vector3& position, uint32_t count)
+std::unordered_map<std::string, std::vector<Vector4>> ParticleManager::BuildAtlas()
 {
-    auto it = particleGroups_.find(name);
-    assert(it != particleGroups_.end());
+    // 読めなかった画像の代わり（白）。アトラスの先頭に必ず入れておく
+    static constexpr uint32_t kFallbackSize = 4;
+    static const std::vector<uint8_t> kFallbackPixels(kFallbackSize * kFallbackSize * 4, 0xFF);
+
+    // 使われている画像とコマ割りの組（名前順にして、同じ組み合わせなら同じアトラス・同じ名前になるようにする）
+    // 同じ画像でもコマ割りが違えば別々に置く（余白はコマごとに付くため）
+    using Source = std::tuple<std::string, uint32_t, uint32_t>;
+    std::map<Source, int32_t> sourceIndex;
+    for (const auto& [name, effect] : simulation_.GetEffects()) {
+        sourceIndex.emplace(Source { effect.texture, effect.flipbookColumns, effect.flipbookRows }, -1);
+    }
 
-    ParticleGroup& group = it->second;
+    // 読み込んだ画像（同じ画像は 1 回だけ読む。width が 0 なら読めなかった）
+    struct Loaded {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<uint8_t> rgba;
+    };
+    std::map<std::string, Loaded> loadedImages;
+    auto load = [](const std::string& path, Loaded& out) {
+        DirectX::ScratchImage loaded {};
+        if (FAILED(DirectX::LoadFromWICFile(StringUtility::ConvertString(path).c_str(), DirectX::WIC_FLAGS_FORCE_SRGB, nullptr, loaded))) {
+            Logger::Log(std::format("ParticleManager: failed to load {}", path));
+            return;
+        }
+        // RGBA8（sRGB）にそろえる
+        DirectX::ScratchImage converted {};
+        const DirectX::Image* source = loaded.GetImage(0, 0, 0);
+        if (loaded.GetMetadata().format != DXGI_FORMAT_R8G8B8A8_UNORM_SRGB) {
+            if (FAILED(DirectX::Convert(*source, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, DirectX::TEX_FILTER_DEFAULT,
+                    DirectX::TEX_THRESHOLD_DEFAULT, converted))) {
+                return;
+            }
+            source = converted.GetImage(0, 0, 0);
+        }
 
-    std::uniform_real_distribution<float> distXZ(-0.1f, 0.1f);
-    std::uniform_real_distribution<float> distUp(0.3f, 0.6f);
-    std::uniform_real_distribution<float> distLife(0.5f, 1.0f);
+        // 行の詰め物を外して並べる
+        out.width = static_cast<uint32_t>(source->width);
+        out.height = static_cast<uint32_t>(source->height);
+        out.rgba.resize(static_cast<size_t>(out.width) * out.height * 4);
+        for (uint32_t y = 0; y < out.height; ++y) {
+            std::memcpy(&out.rgba[static_cast<size_t>(y) * out.width * 4], source->pixels + source->rowPitch * y, static_cast<size_t>(out.width) * 4);
+        }
+    };
 
-    for (uint32_t i = 0; i < count; ++i) {
+    std::vector<ParticleAtlas::Image> images;
+    images.push_back({ kFallbackSize, kFallbackSize, kFallbackPixels.data() });
+    std::string key = "particle_atlas";
 
-        Particle p {};
+    for (auto& [source, index] : sourceIndex) {
+        const auto& [path, columns, rows] = source;
+        auto [it, inserted] = loadedImages.try_emplace(path);
+        if (inserted) {
+            load(path, it->second);
+        }
+        const Loaded& image = it->second;
+        if (image.width < columns || image.height < rows) {
+            continue;
+        }
 
-        // 炎の根元
-        p.transform.translate = {
-            position.x + distXZ(randomEngine_),
-            position.y,
-            position.z + distXZ(randomEngine_)
-        };
+        index = static_cast<int32_t>(images.size());
+        images.push_back({ image.width, image.height, image.rgba.data(), columns, rows });
+        key += std::format("|{}@{}x{}", path, columns, rows);
+    }
 
-        // 縦長
-        float s = 0.1f;
-        p.transform.scale = { s * 0.5f, s * 2.0f, s * 0.5f };
+    ParticleAtlas atlas;
+    if (!atlas.Build(images)) {
+        // 入りきらない時は白だけのアトラスにする
+        Logger::Log("ParticleManager: particle textures do not fit in one atlas");
+        images.resize(1);
+        atlas.Build(images);
+        for (auto& [source, index] : sourceIndex) {
+            index = -1;
+        }
+        key = "particle_atlas";
+    }
 
-        // 上昇
-        p.velocity = {
-            distXZ(randomEngine_) * 0.1f,
-            distUp(randomEngine_),
-            distXZ(randomEngine_) * 0.1f
-        };
+    // 同じ組み合わせなら TextureManager 側で二重に作らない
+    DirectX::ScratchImage atlasImage {};
+    HRESULT hr = atlasImage.Initialize2D(DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, atlas.GetWidth(), atlas.GetHeight(), 1, 1);
+    assert(SUCCEEDED(hr));
+    (void)hr;
+    const DirectX::Image* dst = atlasImage.GetImage(0, 0, 0);
+    for (uint32_t y = 0; y < atlas.GetHeight(); ++y) {
+        std::memcpy(dst->pixels + dst->rowPitch * y, &atlas.GetPixels()[static_cast<size_t>(y) * atlas.GetWidth() * 4],
+            static_cast<size_t>(atlas.GetWidth()) * 4);
+    }
+    atlasKey_ = key;
+    // ミップは余白が 1 texel 以上残る段までにする（それより下は隣のコマと混ざる）
+    TextureManager::GetInstance()->LoadTextureFromImage(atlasKey_, atlasImage, ParticleAtlas::kMipLevels);
+    atlasSrvHandle_ = TextureManager::GetInstance()->GetSrvHandleGPU(atlasKey_);
+
+    std::unordered_map<std::string, std::vector<Vector4>> frames;
+    for (const auto& [name, effect] : simulation_.GetEffects()) {
+        const auto it = sourceIndex.find(Source { effect.texture, effect.flipbookColumns, effect.flipbookRows });
+        const int32_t index = (it != sourceIndex.end()) ? it->second : -1;
+        std::vector<Vector4>& rects = frames[name];
+        for (uint32_t f = 0; f < effect.frameCount; ++f) {
+            rects.push_back(index >= 0 ? atlas.GetRect(static_cast<size_t>(index), f) : atlas.GetRect(0));
+        }
+    }
+    return frames;
+}
 
-        // 赤→黄
-        p.color = { 1.0f, 0.4f, 0.0f, 1.0f };
+void ParticleManager::BuildFrameTable(const std::unordered_map<std::string, std::vector<Vector4>>& atlasFrames)
+{
+    std::vector<Vector4> frames[2];
+    for (auto& [name, effect] : simulation_.GetEffects()) {
+        effect.frameBase = static_cast<uint32_t>(frames[0].size());
+
+        const auto it = atlasFrames.find(name);
+        const float cellW = 1.0f / static_cast<float>(effect.flipbookColumns);
+        const float cellH = 1.0f / static_cast<float>(effect.flipbookRows);
+        for (uint32_t f = 0; f < effect.frameCount; ++f) {
+            const Vector4 local {
+                static_cast<float>(f % effect.flipbookColumns) * cellW,
+                static_cast<float>(f / effect.flipbookColumns) * cellH,
+                cellW,
+                cellH,
+            };
+            // アトラスではコマごとに余白付きで置いてあるので、コマの UV 範囲をそのまま使う
+            const bool inAtlas = (it != atlasFrames.end()) && f < it->second.size();
+            frames[0].push_back(inAtlas ? it->second[f] : local);
+            frames[1].push_back(local);
+        }
+    }
+    frameTableSize_ = static_cast<uint32_t>(frames[0].size());
 
-        // 短命
-        p.lifeTime = distLife(randomEngine_);
-        p.currentTime = 0.0f;
+    // SRV のスロットは一度だけ確保して使い回す
+    if (!frameSrvAllocated_) {
+        frameSrvIndices_[0] = srvManager_->Allocate();
+        frameSrvIndices_[1] = srvManager_->Allocate();
+        frameSrvAllocated_ = true;
+    }
 
-        group.particles.push_back(p);
+    // 読み込み時にしか変わらないので書いたら Unmap する
+    for (int t = 0; t < 2; ++t) {
+        frameResources_[t] = dxCommon_->CreateBufferResource(sizeof(Vector4) * frameTableSize_);
+        frameResources_[t]->SetName(t == 0 ? L"ParticleManager::AtlasFrames" : L"ParticleManager::LocalFrames");
+        Vector4* mapped = nullptr;
+        frameResources_[t]->Map(0, nullptr, reinterpret_cast<void**>(&mapped));
+        std::memcpy(mapped, frames[t].data(), sizeof(Vector4) * frameTableSize_);
+        frameResources_[t]->Unmap(0, nullptr);
+        srvManager_->CreateSRVforStructuredBuffer(frameSrvIndices_[t], frameResources_[t].Get(), frameTableSize_, sizeof(Vector4));
     }
 }
 
-ParticleManager::Particle ParticleManager::MakeParticleDefault(const Vector3& pos)
+void ParticleManager::ImGui()
 {
-    Particle p {};
-
-    // -----------------------------
-    // 乱数
-    // -----------------------------
-    std::uniform_real_distribution<float> offset(-0.05f, 0.05f); // にじみ
-    std::uniform_real_distribution<float> dir(-1.0f, 1.0f); // 方向
-    std::uniform_real_distribution<float> speed(1.0f, 1.5f); // 広がり強さ
-    std::uniform_real_distribution<float> life(0.8f, 1.0f);
-
-    // -----------------------------
-    // 初期位置（少しだけ散らす）
-    // -----------------------------
-    p.transform.translate = {
-        pos.x + offset(randomEngine_),
-        pos.y + offset(randomEngine_),
-        pos.z + offset(randomEngine_)
-    };
+    ParticleSimulation& sim = simulation_;
 
-    // -----------------------------
-    // スケール
-    // -----------------------------
-    p.transform.scale = { 0.3f, 0.3f, 0.3f };
-    p.transform.rotate = { 0, 0, 0 };
-
-    // -----------------------------
-    // 速度（全方向に広がる）
-    // -----------------------------
-    Vector3 v {
-        dir(randomEngine_),
-        dir(randomEngine_),
-        dir(randomEngine_)
-    };
+    ImGui::Begin("Particle Stats");
 
-    // 正規化
-    float len = std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
-    if (len > 0.0f) {
-        v.x /= len;
-        v.y /= len;
-        v.z /= len;
+    int maxInstances = static_cast<int>(sim.GetMaxInstancesPerGroup());
+    if (ImGui::InputInt("Max Instances / Group", &maxInstances, 256, 4096)) {
+        sim.SetMaxInstancesPerGroup(static_cast<uint32_t>((std::max)(maxInstances, 1)));
     }
 
-    float s = speed(randomEngine_);
-    p.velocity = { v.x * s, v.y * s, v.z * s };
+    bool parallelUpdate = sim.IsParallelUpdate();
+    if (ImGui::Checkbox("Parallel Update", &parallelUpdate)) {
+        sim.SetParallelUpdate(parallelUpdate);
+    }
 
-    // -----------------------------
-    // 色
-    // -----------------------------
-    p.color = { 1.0f, 1.0f, 1.0f, 1.0f };
+    int budget = static_cast<int>(sim.GetParticleBudget());
+    if (ImGui::InputInt("Budget", &budget, 1000, 10000)) {
+        sim.SetParticleBudget(static_cast<uint32_t>((std::max)(budget, 1)));
+    }
+    float lodDistance = sim.GetLodDistance();
+    if (ImGui::DragFloat("LOD Distance", &lodDistance, 1.0f, 1.0f, 10000.0f)) {
+        sim.SetLodDistance(lodDistance);
+    }
+    float lodMinPixelSize = sim.GetLodMinPixelSize();
+    if (ImGui::DragFloat("LOD Min Pixels", &lodMinPixelSize, 0.05f, 0.0f, 64.0f)) {
+        sim.SetLodMinPixelSize(lodMinPixelSize);
+    }
+    ImGui::Text("Live: %u / %u  throttled=%u culled=%u", sim.GetLiveParticleCount(), sim.GetParticleBudget(),
+        sim.GetThrottledCount(), sim.GetCulledCount());
 
-    // -----------------------------
-    // 寿命
-    // -----------------------------
-    p.lifeTime = life(randomEngine_);
-    p.currentTime = 0.0f;
+    bool fixedStep = sim.GetFixedTimeStep() > 0.0f;
+    if (ImGui::Checkbox("Fixed Step (60Hz)", &fixedStep)) {
+        sim.SetFixedTimeStep(fixedStep ? 1.0f / 60.0f : 0.0f);
+    }
+    ImGui::Text("Steps (frame): %u", sim.GetLastStepCount());
+    ImGui::Text("Seed: %llu", static_cast<unsigned long long>(sim.GetRandomSeed()));
+    ImGui::Text("Workers: %u", sim.GetWorkerCount());
+
+    ImGui::Text("Dropped (frame): %u", sim.GetDroppedInstanceCount());
+    ImGui::Text("Dropped (total): %llu", static_cast<unsigned long long>(sim.GetTotalDroppedInstanceCount()));
+
+    static const char* const kSortModeNames[] = { "None", "Radix", "Incremental" };
+    static const char* const kCollisionModeNames[] = { "None", "Bounce", "Stick", "Kill" };
+
+    // 天候（箱型のエフェクトから選ぶ）
+    if (!sim.GetWeatherGroupName().empty()) {
+        std::vector<const char*> weatherNames;
+        int current = -1;
+        for (const auto& [effectName, effect] : sim.GetEffects()) {
+            if (effect.shape != ParticleSpawnShape::Box) {
+                continue;
+            }
+            if (&effect == sim.GetWeatherEffect()) {
+                current = static_cast<int>(weatherNames.size());
+            }
+            weatherNames.push_back(effectName.c_str());
+        }
+        if (ImGui::Combo("Weather", &current, weatherNames.data(), static_cast<int>(weatherNames.size())) && current >= 0) {
+            sim.SetWeather(sim.GetWeatherGroupName(), weatherNames[current], sim.GetWeatherDensity());
+        }
+        float density = sim.GetWeatherDensity();
+        if (ImGui::SliderFloat("Weather Density", &density, 0.0f, 0.5f)) {
+            sim.SetWeatherDensity(density);
+        }
+        ImGui::Text("Weather: %u particles", sim.GetWeatherCount());
+    }
 
-    return p;
-}
+    ImGui::Text("Draws: %u  binds: %u  frames: %u", drawCallCount_, descriptorBindCount_, frameTableSize_);
+    const CurlNoiseField& turbulence = sim.GetTurbulenceField();
+    ImGui::Text("Turbulence: %u^3 (%.0f KB) period=%.1f", turbulence.GetResolution(),
+        turbulence.GetMemorySize() / 1024.0f, turbulence.GetPeriod());
 
-void ParticleManager::ClearAllParticles()
-{
-    for (auto& [name, group] : particleGroups_) {
-        group.particles.clear();
-        group.numInstance = 0;
-        // instanceData は Map したままでOK（FinalizeでだけUnmapする）
+    if (const ParticleCollisionWorld* collisionWorld = sim.GetCollisionWorld()) {
+        ImGui::Text("Collision: boxes=%u cells=%u (%.1f)", collisionWorld->GetBoxCount(),
+            collisionWorld->GetCellCount(), collisionWorld->GetCellSize());
+    }
+
+    for (auto& [name, group] : sim.GetParticleGroups()) {
+        ImGui::Text("%s : alive=%u drawn=%u cap=%u dropped=%u",
+            name.c_str(), CountParticles(group), group.numInstance, group.instanceCapacity, group.droppedInstances);
+        for (const ParticleBatch& batch : group.batches) {
+            ImGui::Text("  [%s] %u", batch.effect->name.c_str(), batch.particles.Size());
+        }
+
+        if (ImGui::DragFloat(("Priority##" + name).c_str(), &group.priority, 0.05f, 0.01f, 16.0f)) {
+            sim.SetGroupPriority(name, group.priority);
+        }
+        ImGui::Text("  culled=%u", group.culledCount);
+
+        int sortMode = static_cast<int>(group.sortMode);
+        if (ImGui::Combo(("Sort##" + name).c_str(), &sortMode, kSortModeNames, IM_ARRAYSIZE(kSortModeNames))) {
+            sim.SetSortMode(name, static_cast<ParticleSortMode>(sortMode));
+        }
+        if (group.sortMode == ParticleSortMode::Incremental) {
+            ImGui::Text("  sort fallbacks=%u", group.sortFallbacks);
+        }
+
+        int collisionMode = static_cast<int>(group.collision.mode);
+        if (ImGui::Combo(("Collision##" + name).c_str(), &collisionMode, kCollisionModeNames, IM_ARRAYSIZE(kCollisionModeNames))) {
+            group.collision.mode = static_cast<ParticleCollisionMode>(collisionMode);
+        }
+        if (group.collision.mode == ParticleCollisionMode::Bounce) {
+            ImGui::DragFloat(("Restitution##" + name).c_str(), &group.collision.restitution, 0.01f, 0.0f, 1.0f);
+            ImGui::DragFloat(("Friction##" + name).c_str(), &group.collision.friction, 0.01f, 0.0f, 1.0f);
+        }
+        if (group.collision.mode != ParticleCollisionMode::None) {
+            ImGui::Text("  hits=%u", group.collisionHits);
+        }
     }
+
+    ImGui::Text("Effects: %u", static_cast<uint32_t>(sim.GetEffects().size()));
+
+    ImGui::End();
 }
@@ -1,16 +1,22 @@
 #pragma once
 #include "Camera.h"
 #include "DirectXCommon.h"
+#include "ParticleSimulation.h"
 #include "SrvManager.h"
 #include "TextureManager.h"
 #include "blendutil.h"
 #include <d3d12.h>
-#include <list>
-#include <random>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <wrl.h>
 
+// ===============================
+// パーティクルの描画（D3D12）
+// ===============================
+// 粒子の発生・更新は ParticleSimulation に任せ、ここはインスタンシングバッファ・
+// アトラス・フレーム表・PSO を持って描くだけ。インスタンスは Map したバッファへ
+// シミュレーションが直接書く（SetInstanceBufferCallback）
 class ParticleManager {
 public:
     // =========================================================
@@ -46,26 +52,17 @@ public:
         Vector3 normal;
     };
 
-    struct Particle {
-        Transform transform;
-        Vector3 velocity;
-        Vector4 color;
-        float lifeTime;
-        float currentTime;
-    };
-
-    struct ParticleForGPU {
-        Matrix4x4 WVP;
-        Matrix4x4 World;
-        Vector4 color;
-    };
-
-    struct Shockwave {
-        Vector3 pos;
-        float lifeTime;
-        float currentTime;
-        float startScale;
-        float endScale;
+    // 1 インスタンス 32 バイト（Particle.hlsli と同じ並び）
+    using ParticleForGPU = ParticleSimulation::ParticleForGPU;
+
+    // 全インスタンス共通（b1, VS）
+    struct ParticleCameraForGPU {
+        Matrix4x4 viewProjection;
+        // 板の x / y を並べる方向（ビルボード時はカメラの右・上、それ以外はワールドの X / Y）
+        Vector3 right;
+        float padding0;
+        Vector3 up;
+        float padding1;
     };
 
     struct Emitter {
@@ -75,49 +72,117 @@ public:
         float frequencyTime;
     };
 
-    enum class ParticleType {
-        Normal,
-        Fire,
-        Smoke,
-        Spark,
-        FireWork
-    };
-    ParticleType type = ParticleType::Normal;
-
-    struct ParticleGroup {
-        std::string texturePath;
-        std::list<Particle> particles;
-        Microsoft::WRL::ComPtr<ID3D12Resource> instancingResource;
-        ParticleForGPU* instanceData = nullptr;
-        D3D12_GPU_DESCRIPTOR_HANDLE instancingSrvHandleGPU {};
-        uint32_t numInstance = 0;
-    };
-
-    std::unordered_map<std::string, ParticleGroup> particleGroups_;
+    using ParticleBatch = ParticleSimulation::ParticleBatch;
+    using ParticleGroup = ParticleSimulation::ParticleGroup;
 
 public:
     // =========================================================
     // 基本操作
     // =========================================================
     void Initialize(DirectXCommon* dxCommon, SrvManager* srvManager, Camera* camera);
-    void Update();
+    // deltaTime は実時間（秒）
+    void Update(float deltaTime);
     void PreDraw();
     void Draw();
 
     // BlendMode の setter
     void SetBlendMode(BlendMode mode) { currentBlendMode_ = mode; }
-    // パーティクルグループ作成
+    // パーティクルグループ作成（アトラスを使うので、違うエフェクトを混ぜても 1 回で描ける）
+    void CreateParticleGroup(const std::string& name);
+    // 画像 1 枚を全エフェクトで使うグループ
     void CreateParticleGroup(const std::string& name, const std::string& textureFilePath);
-    // パーティクルの発生
-    void Emit(const std::string& name, const Vector3& position, uint32_t count);
-    void EmitFire(const std::string& name, const Vector3& position, uint32_t count);
-    // UI
-    // void ImGui();
-    Particle MakeParticleDefault(const Vector3& pos);
+    // パーティクルの発生（effectName は resources/particles/*.json の name）
+    void Emit(const std::string& name, const std::string& effectName, const Vector3& position, uint32_t count)
+    {
+        simulation_.Emit(name, effectName, position, count);
+    }
+    // "default" エフェクトで発生
+    void Emit(const std::string& name, const Vector3& position, uint32_t count) { Emit(name, "default", position, count); }
+    // 読み込んだエフェクト（無ければ "default"）
+    const ParticleEffect& GetEffect(const std::string& effectName) const { return simulation_.GetEffect(effectName); }
+    // 乱流の場（エフェクトの turbulence で引く。起動時に読み込むか焼く）
+    const CurlNoiseField& GetTurbulenceField() const { return simulation_.GetTurbulenceField(); }
+    // グループの生存数（全エフェクト合計）
+    static uint32_t CountParticles(const ParticleGroup& group) { return ParticleSimulation::CountParticles(group); }
+    // UI（グループごとの粒子数・バッファ容量・描けなかった数）
+    void ImGui();
+
+    // 更新・発生の本体（予算・LOD・天候・当たり判定・時間の設定はこちらを直接触ってもよい）
+    ParticleSimulation& GetSimulation() { return simulation_; }
+    const ParticleSimulation& GetSimulation() const { return simulation_; }
+
+    // 乱数のシードを固定する（リプレイ・テスト用。Initialize 後に呼んでもその場で反映）
+    void SetRandomSeed(uint64_t seed) { simulation_.SetRandomSeed(seed); }
+    uint64_t GetRandomSeed() const { return simulation_.GetRandomSeed(); }
 
     void SetCamera(Camera* camera) { camera_ = camera; }
 
-    void ClearAllParticles();
+    void ClearAllParticles() { simulation_.ClearAllParticles(); }
+
+    // グループごとの奥→手前ソート（Normal ブレンドの煙など用）
+    void SetSortMode(const std::string& name, ParticleSortMode mode) { simulation_.SetSortMode(name, mode); }
+
+    // ---------------------------------------------------------
+    // 予算・LOD
+    // ---------------------------------------------------------
+    // 全グループ合計の生存数の上限。埋まってくると Emit の数を優先度に応じて絞る
+    void SetParticleBudget(uint32_t budget) { simulation_.SetParticleBudget(budget); }
+    uint32_t GetParticleBudget() const { return simulation_.GetParticleBudget(); }
+    void SetGroupPriority(const std::string& name, float priority) { simulation_.SetGroupPriority(name, priority); }
+    // この距離より遠い粒子を消す（優先度を掛けた距離で判定）
+    void SetLodDistance(float distance) { simulation_.SetLodDistance(distance); }
+    float GetLodDistance() const { return simulation_.GetLodDistance(); }
+    // 画面上の大きさ（ピクセル）がこれ未満の粒子を消す（優先度で割った値で判定）
+    void SetLodMinPixelSize(float pixels) { simulation_.SetLodMinPixelSize(pixels); }
+    float GetLodMinPixelSize() const { return simulation_.GetLodMinPixelSize(); }
+    uint32_t GetLiveParticleCount() const { return simulation_.GetLiveParticleCount(); }
+    // 直近フレームに絞られた発生数 / LOD で消した数
+    uint32_t GetThrottledCount() const { return simulation_.GetThrottledCount(); }
+    uint32_t GetCulledCount() const { return simulation_.GetCulledCount(); }
+
+    // ---------------------------------------------------------
+    // 天候（雨・雪・砂ぼこり）
+    // ---------------------------------------------------------
+    // name は CreateParticleGroup 済みのグループ（天候専用にすること）。詳しくは ParticleSimulation::SetWeather
+    void SetWeather(const std::string& name, const std::string& effectName, float density)
+    {
+        simulation_.SetWeather(name, effectName, density);
+    }
+    void SetWeatherDensity(float density) { simulation_.SetWeatherDensity(density); }
+    float GetWeatherDensity() const { return simulation_.GetWeatherDensity(); }
+    void ClearWeather() { simulation_.ClearWeather(); }
+    // 直近の Update での天候の粒子数
+    uint32_t GetWeatherCount() const { return simulation_.GetWeatherCount(); }
+
+    // 直近の Draw で発行した描画コール数・テクスチャ/フレーム表を張り直した回数
+    uint32_t GetDrawCallCount() const { return drawCallCount_; }
+    uint32_t GetDescriptorBindCount() const { return descriptorBindCount_; }
+
+    // ---------------------------------------------------------
+    // 当たり判定
+    // ---------------------------------------------------------
+    // 壁・地面（シーンが持つ。nullptr なら当たり判定しない）
+    void SetCollisionWorld(const ParticleCollisionWorld* world) { simulation_.SetCollisionWorld(world); }
+    void SetCollision(const std::string& name, const ParticleCollisionResponse& response) { simulation_.SetCollision(name, response); }
+
+    // 1グループあたりのインスタンス上限（超えた分は描画されず dropped に数える）
+    void SetMaxInstancesPerGroup(uint32_t maxInstances) { simulation_.SetMaxInstancesPerGroup(maxInstances); }
+    uint32_t GetMaxInstancesPerGroup() const { return simulation_.GetMaxInstancesPerGroup(); }
+    // 直近の Update で全グループ合計何個落としたか
+    uint32_t GetDroppedInstanceCount() const { return simulation_.GetDroppedInstanceCount(); }
+    // 起動してからの累計
+    uint64_t GetTotalDroppedInstanceCount() const { return simulation_.GetTotalDroppedInstanceCount(); }
+
+    // 実時間 1 秒で何シミュレーション単位進めるか
+    void SetTimeScale(float timeScale) { simulation_.SetTimeScale(timeScale); }
+    float GetTimeScale() const { return simulation_.GetTimeScale(); }
+    // 固定ステップ幅（実時間・秒）。0 なら毎フレーム deltaTime で 1 回進める
+    void SetFixedTimeStep(float seconds) { simulation_.SetFixedTimeStep(seconds); }
+    float GetFixedTimeStep() const { return simulation_.GetFixedTimeStep(); }
+
+    // 複数スレッドで更新するか（粒子数が少なければ常に単一スレッド）
+    void SetParallelUpdate(bool enable) { simulation_.SetParallelUpdate(enable); }
+    bool IsParallelUpdate() const { return simulation_.IsParallelUpdate(); }
 
 private:
     // =========================================================
@@ -138,6 +203,15 @@ private:
     void CreateRootSignature();
     void CreateGraphicsPipeline();
     void CreateBoardMesh();
+    // インスタンシングバッファを capacity 要素で作り直し、SRV も同じスロットに張り直す
+    // （ParticleSimulation の書き出し先コールバック。Map した先頭を返す）
+    ParticleForGPU* ResizeInstancingBuffer(const std::string& name, uint32_t capacity);
+    // エフェクト定義を読み込み、アトラスとフレーム表を作り直す
+    void LoadEffects();
+    // 全エフェクトの画像をコマごとに 1 枚にまとめて登録し、エフェクト名 → コマの UV 範囲（コマ順）を返す
+    std::unordered_map<std::string, std::vector<Vector4>> BuildAtlas();
+    // エフェクトのコマの UV 範囲を並べた表を作って frameBase を埋める
+    void BuildFrameTable(const std::unordered_map<std::string, std::vector<Vector4>>& atlasFrames);
 
 private:
     // =========================================================
@@ -158,22 +232,44 @@ private:
     // GPU リソース
     // =========================================================
 
-    static const uint32_t kNumMaxInstance = 100;
+    // グループごとの GPU 側（粒子そのものは simulation_ のグループが持つ）
+    struct GroupResources {
+        // 空ならエフェクトのアトラスを使う（エフェクトごとの画像・フリップブックのコマ）
+        // 指定した場合はその画像 1 枚をエフェクトのコマ割りで使う
+        std::string texturePath;
+        Microsoft::WRL::ComPtr<ID3D12Resource> instancingResource;
+        ParticleForGPU* instanceData = nullptr;
+        D3D12_GPU_DESCRIPTOR_HANDLE instancingSrvHandleGPU {};
+        uint32_t instancingSrvIndex = 0;
+    };
+    std::unordered_map<std::string, GroupResources> groupResources_;
 
-    std::list<Shockwave> shokParticles;
+    // =========================================================
+    // シミュレーション
+    // =========================================================
+    ParticleSimulation simulation_;
 
     D3D12_GPU_DESCRIPTOR_HANDLE srvHandle {};
 
     Microsoft::WRL::ComPtr<ID3D12Resource> materialResource;
     Microsoft::WRL::ComPtr<ID3D12Resource> transformResource;
     Microsoft::WRL::ComPtr<ID3D12Resource> lightResource;
+    // ビルボードの軸と VP（Update で毎フレーム書き換える）
+    Microsoft::WRL::ComPtr<ID3D12Resource> cameraResource_;
+    ParticleCameraForGPU* cameraData_ = nullptr;
 
     Material materialData_ {};
     TransformationMatrix transformData_ {};
     DirectionalLight lightData_ {};
 
-    VertexData vertices[4];
-    uint32_t indexList[6] = { 0, 1, 2, 0, 2, 3 };
+    // 板ポリ（左上・右上・右下・左下）はコンパイル時に確定している
+    static constexpr VertexData kBoardVertices[4] = {
+        { { -0.5f, 0.5f, 0, -1.0f }, { 0, 0 }, { 0, 0, -1 } },
+        { { 0.5f, 0.5f, 0, -1.0f }, { 1, 0 }, { 0, 0, -1 } },
+        { { 0.5f, -0.5f, 0, -1.0f }, { 1, 1 }, { 0, 0, -1 } },
+        { { -0.5f, -0.5f, 0, -1.0f }, { 0, 1 }, { 0, 0, -1 } },
+    };
+    static constexpr uint32_t indexList[6] = { 0, 1, 2, 0, 2, 3 };
 
     Microsoft::WRL::ComPtr<ID3D12Resource> vertexResource;
     Microsoft::WRL::ComPtr<ID3D12Resource> indexResource;
@@ -187,9 +283,28 @@ private:
         { 0.0f, 0.0f, 0.0f }
     };
 
-    std::random_device seedGenerator_;
-    std::mt19937 randomEngine_;
-    bool useBillboard_ = true;
+    // =========================================================
+    // エフェクト定義
+    // =========================================================
+    static constexpr const char* kEffectDirectory = "resources/particles";
+    // 乱流（curl ノイズ）の場。ファイルが無い時は固定シードで焼くので毎回同じ場になる
+    static constexpr const char* kTurbulenceFieldPath = "resources/particles/curl_noise.bin";
+    static constexpr uint64_t kTurbulenceSeed = 0x7D3C0F1E;
 
-    float kdeltaTime = 0.1f;
+    // =========================================================
+    // アトラス・フレーム表
+    // =========================================================
+    // アトラスの TextureManager 上の名前（画像の組み合わせごとに変わる）
+    std::string atlasKey_;
+    D3D12_GPU_DESCRIPTOR_HANDLE atlasSrvHandle_ {};
+    // [0] アトラス上の UV 範囲 [1] 画像 1 枚の中での UV 範囲（添字は同じ）
+    Microsoft::WRL::ComPtr<ID3D12Resource> frameResources_[2];
+    uint32_t frameSrvIndices_[2] = {};
+    bool frameSrvAllocated_ = false;
+    uint32_t frameTableSize_ = 0;
+
+    uint32_t drawCallCount_ = 0;
+    uint32_t descriptorBindCount_ = 0;
+
+    bool useBillboard_ = true;
 };
@@ -0,0 +1,57 @@
+#include "ParticlePool.h"
+#include <cassert>
+
+void ParticlePool::Reserve(uint32_t capacity)
+{
+    if (capacity <= capacity_) {
+        return;
+    }
+
+    // 属性配列はすべて同じ長さに揃える
+    translate.resize(capacity);
+    previousTranslate.resize(capacity);
+    rotate.resize(capacity);
+    scale.resize(capacity);
+    velocity.resize(capacity);
+    color.resize(capacity);
+    lifeTime.resize(capacity);
+    currentTime.resize(capacity);
+
+    capacity_ = capacity;
+}
+
+uint32_t ParticlePool::Append(uint32_t count)
+{
+    const uint32_t first = size_;
+    const uint32_t required = size_ + count;
+
+    // 足りない時だけ倍々で広げる（バーストのたびに再確保しない）
+    if (required > capacity_) {
+        uint32_t newCapacity = (capacity_ > 0) ? capacity_ : kDefaultCapacity;
+        while (newCapacity < required) {
+            newCapacity *= 2;
+        }
+        Reserve(newCapacity);
+    }
+
+    size_ = required;
+    return first;
+}
+
+void ParticlePool::SwapRemove(uint32_t index)
+{
+    assert(index < size_);
+
+    const uint32_t last = size_ - 1;
+    if (index != last) {
+        translate[index] = translate[last];
+        previousTranslate[index] = previousTranslate[last];
+        rotate[index] = rotate[last];
+        scale[index] = scale[last];
+        velocity[index] = velocity[last];
+        color[index] = color[last];
+        lifeTime[index] = lifeTime[last];
+        currentTime[index] = currentTime[last];
+    }
+    size_ = last;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "MathStruct.h"
+#include <cstdint>
+#include <vector>
+
+// ===============================
+// パーティクルの SoA プール
+// ===============================
+// 属性ごとに連続配列で持つ（1粒子 = 各配列の同じ添字）
+// 各配列は容量ぶん確保したままにし、生存数は size_ で管理する
+// 削除は末尾と入れ替えて詰める（順序は保存しない）
+class ParticlePool {
+
+public:
+    // 最初に確保しておく粒子数
+    static constexpr uint32_t kDefaultCapacity = 1024;
+
+    ParticlePool() { Reserve(kDefaultCapacity); }
+
+    // 容量を最低 capacity まで広げる（縮めない）
+    void Reserve(uint32_t capacity);
+
+    // 末尾に count 個ぶんの枠を確保して先頭添字を返す
+    // 中身は未設定なので呼び出し側で全属性を書くこと
+    uint32_t Append(uint32_t count);
+
+    // index の粒子を末尾の粒子で上書きして 1 個減らす
+    void SwapRemove(uint32_t index);
+
+    void Clear() { size_ = 0; }
+
+    uint32_t Size() const { return size_; }
+    uint32_t Capacity() const { return capacity_; }
+    bool Empty() const { return size_ == 0; }
+
+public:
+    // 属性配列（添字 [0, Size()) が有効）
+    std::vector<Vector3> translate;
+    // 直前のシミュレーションステップ開始時の位置（固定ステップ時の補間用）
+    std::vector<Vector3> previousTranslate;
+    std::vector<Vector3> rotate;
+    std::vector<Vector3> scale;
+    std::vector<Vector3> velocity;
+    std::vector<Vector4> color;
+    std::vector<float> lifeTime;
+    std::vector<float> currentTime;
+
+private:
+    uint32_t size_ = 0;
+    uint32_t capacity_ = 0;
+};
@@ -0,0 +1,702 @@
+#include "ParticleSimulation.h"
+#include <cassert>
+#include <cmath>
+#include <random>
+
+namespace {
+
+// [0,1] の RGBA を RGBA8 に詰める（R が下位バイト = DXGI_FORMAT_R8G8B8A8_UNORM と同じ並び）
+inline uint32_t PackColor(float r, float g, float b, float a)
+{
+    auto toByte = [](float v) {
+        return static_cast<uint32_t>(std::clamp(v, 0.0f, 1.0f) * 255.0f + 0.5f);
+    };
+    return toByte(r) | (toByte(g) << 8) | (toByte(b) << 16) | (toByte(a) << 24);
+}
+
+// value を [center - extent, center + extent) に巻き戻すためのずらし量（箱の幅の整数倍）
+inline float WrapOffset(float value, float center, float extent)
+{
+    const float size = extent * 2.0f;
+    if (size <= 0.0f) {
+        return 0.0f;
+    }
+    return -size * std::floor((value - (center - extent)) / size);
+}
+
+} // namespace
+
+void ParticleSimulation::Initialize(uint32_t workerCount)
+{
+    // パーティクルのランダム生成に使う乱数（固定シードが指定されていればそれを使う）
+    if (hasFixedSeed_) {
+        random_.Seed(fixedSeed_);
+    } else {
+        std::random_device seedGenerator;
+        random_.Seed(static_cast<uint64_t>(seedGenerator()) << 32 | seedGenerator());
+    }
+
+    // 更新用ワーカー（シーンをまたいで使い回す）
+    if (!workerPool_) {
+        workerPool_ = std::make_unique<ParticleWorkerPool>(workerCount);
+    }
+}
+
+void ParticleSimulation::Finalize()
+{
+    particleGroups_.clear();
+    activeGroups_.clear();
+    updateJobs_.clear();
+    weather_ = {};
+    liveParticleCount_ = 0;
+
+    // ワーカースレッド停止
+    workerPool_.reset();
+}
+
+template <class Fn>
+void ParticleSimulation::ParallelFor(bool parallel, uint32_t jobCount, const Fn& fn)
+{
+    if (parallel && workerPool_) {
+        // 参照 1 個なら std::function の内部に収まるので確保が起きない
+        const std::function<void(uint32_t)> task = [&fn](uint32_t j) { fn(j); };
+        workerPool_->ParallelFor(jobCount, task);
+    } else {
+        for (uint32_t j = 0; j < jobCount; ++j) {
+            fn(j);
+        }
+    }
+}
+
+void ParticleSimulation::Update(float deltaTime, const View& view)
+{
+    ChunkParams params {};
+
+    // ソート用の深度（行ベクトルなので 4 列目がクリップ座標の w = ビュー空間の奥行き）
+    const Matrix4x4& viewProjection = view.viewProjection;
+    params.depthAxis = { viewProjection.m[0][3], viewProjection.m[1][3], viewProjection.m[2][3] };
+    params.depthOffset = viewProjection.m[3][3];
+
+    // 天候の箱はカメラに付いてくる
+    params.weatherCenter = view.position;
+    params.weatherExtents = weather_.effect ? weather_.effect->extents : Vector3 { 0.0f, 0.0f, 0.0f };
+
+    // ---------------------------------
+    // LOD（予算が埋まってくるほど厳しくする）
+    // ---------------------------------
+    throttledCount_ = pendingThrottledCount_;
+    pendingThrottledCount_ = 0;
+
+    const float fill = static_cast<float>(liveParticleCount_) / static_cast<float>(particleBudget_);
+    const float pressure = std::clamp((fill - kThrottleStart) / (1.0f - kThrottleStart), 0.0f, 1.0f);
+
+    LodParams lod {};
+    lod.cameraPosition = view.position;
+    lod.depthAxis = params.depthAxis;
+    lod.depthOffset = params.depthOffset;
+    lod.pixelsPerUnit = view.pixelsPerUnit;
+    lod.maxDistance = lodDistance_ * (1.0f - 0.5f * pressure);
+    lod.minPixelSize = lodMinPixelSize_ * (1.0f + 3.0f * pressure);
+
+    // ---------------------------------
+    // 何ステップ進めるか
+    // ---------------------------------
+    deltaTime = (std::max)(deltaTime, 0.0f);
+    uint32_t stepCount = 1;
+    float stepTime = deltaTime * timeScale_;
+    params.interpolation = 1.0f;
+
+    if (fixedTimeStep_ > 0.0f) {
+        accumulator_ += deltaTime;
+        stepCount = 0;
+        while (accumulator_ >= fixedTimeStep_ && stepCount < kMaxSubSteps) {
+            accumulator_ -= fixedTimeStep_;
+            ++stepCount;
+        }
+        // 追いつけない分は捨てる（処理落ちで雪だるま式に重くならないように）
+        if (accumulator_ >= fixedTimeStep_) {
+            accumulator_ = std::fmod(accumulator_, fixedTimeStep_);
+        }
+        stepTime = fixedTimeStep_ * timeScale_;
+        // 描画は「1つ前のステップ」と「最新ステップ」の間を余りの割合で補間する
+        params.interpolation = accumulator_ / fixedTimeStep_;
+    }
+    params.interpolate = (fixedTimeStep_ > 0.0f);
+    params.renderLag = (1.0f - params.interpolation) * stepTime;
+    lastStepCount_ = stepCount;
+
+    droppedInstanceCount_ = 0;
+
+    // ★書き出し先が準備できてないグループは対象外
+    // （unordered_map の走査順はフレーム間で変わらないので、並びもここで固定される）
+    activeGroups_.clear();
+    uint32_t totalParticles = 0;
+    for (auto& [name, group] : particleGroups_) {
+        if (!group.instanceData) {
+            continue;
+        }
+        activeGroups_.push_back({ &name, &group });
+        totalParticles += CountParticles(group);
+        group.collisionHits = 0;
+    }
+
+    // 少ない時はスレッドを起こす方が高くつく
+    const bool parallel = parallelUpdate_ && totalParticles >= kParallelThreshold;
+
+    // ---------------------------------
+    // 1) 追いつき用の途中ステップ（固定ステップ時のみ・グループ単位で並列）
+    // ---------------------------------
+    for (uint32_t step = 0; step + 1 < stepCount; ++step) {
+        ParallelFor(parallel, static_cast<uint32_t>(activeGroups_.size()), [&](uint32_t g) {
+            for (ParticleBatch& batch : activeGroups_[g].group->batches) {
+                RemoveDeadParticles(batch.particles);
+                ParticleKernel::Integrate(*batch.effect, batch.particles, 0, batch.particles.Size(), stepTime, &turbulenceField_);
+                activeGroups_[g].group->collisionHits += CollideParticles(*activeGroups_[g].group, batch.particles, 0, batch.particles.Size());
+            }
+        });
+    }
+
+    // ---------------------------------
+    // 2) 最後のステップの寿命切れ・LOD で消す分を詰める（グループ単位で並列）
+    // ---------------------------------
+    if (stepCount > 0) {
+        ParallelFor(parallel, static_cast<uint32_t>(activeGroups_.size()), [&](uint32_t g) {
+            ParticleGroup& group = *activeGroups_[g].group;
+            group.culledCount = 0;
+            for (ParticleBatch& batch : group.batches) {
+                RemoveDeadParticles(batch.particles);
+                // 天候はカメラの周りにしかいないので消さない（数は RefillWeather で決める）
+                if (!group.weather) {
+                    group.culledCount += CullParticles(batch, lod, group.priority);
+                }
+            }
+        });
+
+        // 天候の寿命切れを補充（乱数を使うのでメインスレッド）
+        RefillWeather(view.position, pressure);
+    }
+    // このフレームに進めるステップが無ければ、移動せず補間だけ進める
+    params.stepTime = (stepCount > 0) ? stepTime : 0.0f;
+
+    // ---------------------------------
+    // 3) 書き出し先の確保とチャンク分割（コールバックが D3D を触るのでメインスレッド）
+    // ---------------------------------
+    updateJobs_.clear();
+    liveParticleCount_ = 0;
+    culledCount_ = 0;
+    for (const ActiveGroup& active : activeGroups_) {
+        ParticleGroup& group = *active.group;
+        const uint32_t alive = CountParticles(group);
+        liveParticleCount_ += alive;
+        culledCount_ += (stepCount > 0) ? group.culledCount : 0;
+
+        // 生存数が入るように書き出し先を伸ばす
+        const uint32_t required = (std::min)(alive, maxInstancesPerGroup_);
+        if (required > group.instanceCapacity) {
+            uint32_t newCapacity = (std::max)(group.instanceCapacity, kInitialInstanceCapacity);
+            while (newCapacity < required) {
+                newCapacity *= 2;
+            }
+            ResizeInstances(*active.name, group, (std::min)(newCapacity, maxInstancesPerGroup_));
+        }
+        // 上限を後から下げた場合は書き出し先が大きいままなので小さい方で切る
+        const uint32_t instanceLimit = (std::min)(group.instanceCapacity, maxInstancesPerGroup_);
+
+        // 上限を超えた末尾の分は更新だけして描かない
+        group.numInstance = (std::min)(alive, instanceLimit);
+        group.droppedInstances = alive - group.numInstance;
+        droppedInstanceCount_ += group.droppedInstances;
+        totalDroppedInstanceCount_ += group.droppedInstances;
+
+        // ソートするグループは一時領域に書く
+        if (group.sortMode != ParticleSortMode::None) {
+            if (group.sortStaging.size() < group.numInstance) {
+                group.sortStaging.resize(group.numInstance);
+            }
+            group.sortDepth.resize(group.numInstance);
+        }
+
+        // チャンクの書き込み先 = それより前のチャンクの出力数の累積
+        // 出力先が入力順で決まるので、どのスレッドが処理しても結果は同じ並びになる
+        // バッチは追加順に並べ、上限を超えた分は後ろのバッチから描かない
+        uint32_t outOffset = 0;
+        for (ParticleBatch& batch : group.batches) {
+            const uint32_t size = batch.particles.Size();
+            for (uint32_t begin = 0; begin < size; begin += kParticleChunkSize) {
+                UpdateJob job {};
+                job.group = &group;
+                job.batch = &batch;
+                job.begin = begin;
+                job.end = (std::min)(begin + kParticleChunkSize, size);
+                job.outOffset = outOffset;
+                updateJobs_.push_back(job);
+
+                const uint32_t drawCount = (std::min)(job.end - begin, group.numInstance - outOffset);
+                outOffset += drawCount;
+            }
+        }
+    }
+
+    // ---------------------------------
+    // 4) 最後のステップの移動とインスタンスの書き込み（チャンク単位で並列）
+    // ---------------------------------
+    jobCollisionHits_.assign(updateJobs_.size(), 0);
+    ParallelFor(parallel, static_cast<uint32_t>(updateJobs_.size()), [&](uint32_t j) {
+        jobCollisionHits_[j] = UpdateChunk(updateJobs_[j], params);
+    });
+    for (size_t j = 0; j < updateJobs_.size(); ++j) {
+        updateJobs_[j].group->collisionHits += jobCollisionHits_[j];
+    }
+
+    // ---------------------------------
+    // 5) 奥→手前に並べ替えて書き出す（グループ単位で並列）
+    // ---------------------------------
+    ParallelFor(parallel, static_cast<uint32_t>(activeGroups_.size()), [&](uint32_t g) {
+        ParticleGroup& group = *activeGroups_[g].group;
+        if (group.sortMode != ParticleSortMode::None) {
+            SortAndUpload(group);
+        }
+    });
+}
+
+void ParticleSimulation::SortAndUpload(ParticleGroup& group)
+{
+    const uint32_t count = group.numInstance;
+
+    if (group.sortMode == ParticleSortMode::Incremental) {
+        if (ParticleSort::SortBackToFrontIncremental(group.sortDepth.data(), count, group.sortOrder, group.sortScratch)) {
+            ++group.sortFallbacks;
+        }
+    } else {
+        ParticleSort::SortBackToFront(group.sortDepth.data(), count, group.sortOrder, group.sortScratch);
+    }
+
+    // instanceData は書き込み専用（Upload ヒープ）のことがあるので、先頭から順に書くだけにする
+    const ParticleForGPU* src = group.sortStaging.data();
+    const uint32_t* order = group.sortOrder.data();
+    for (uint32_t k = 0; k < count; ++k) {
+        group.instanceData[k] = src[order[k]];
+    }
+}
+
+void ParticleSimulation::SetSortMode(const std::string& name, ParticleSortMode mode)
+{
+    auto it = particleGroups_.find(name);
+    assert(it != particleGroups_.end());
+    ParticleGroup& group = it->second;
+
+    group.sortMode = mode;
+    group.sortOrder.clear();
+    if (mode == ParticleSortMode::None) {
+        // 使わなくなった一時領域は返す
+        group.sortStaging = {};
+        group.sortDepth = {};
+        group.sortScratch = {};
+    }
+}
+
+void ParticleSimulation::RemoveDeadParticles(ParticlePool& pool)
+{
+    uint32_t i = 0;
+    while (i < pool.Size()) {
+
+        // ★ここで配列が壊れてるかどうかを即判定する
+        if (!std::isfinite(pool.lifeTime[i]) || !std::isfinite(pool.currentTime[i]) ||
+            !std::isfinite(pool.scale[i].x) || !std::isfinite(pool.scale[i].y) || !std::isfinite(pool.scale[i].z)) {
+            assert(false && "Particle data corrupted (memory overwrite likely)");
+        }
+
+        // 寿命（入れ替わってきた粒子を同じ i で見るので ++i しない）
+        if (pool.currentTime[i] >= pool.lifeTime[i]) {
+            pool.SwapRemove(i);
+            continue;
+        }
+        ++i;
+    }
+}
+
+uint32_t ParticleSimulation::CullParticles(ParticleBatch& batch, const LodParams& lod, float priority)
+{
+    ParticlePool& pool = batch.particles;
+    const ParticleEffect& effect = *batch.effect;
+
+    // 優先度が高いほど遠く・小さくても残す
+    const float maxDistance = lod.maxDistance * priority;
+    const float maxDistanceSq = maxDistance * maxDistance;
+    const float minPixelSize = lod.minPixelSize / priority;
+
+    uint32_t culled = 0;
+    uint32_t i = 0;
+    while (i < pool.Size()) {
+        const Vector3& position = pool.translate[i];
+        const Vector3 toCamera = position - lod.cameraPosition;
+        const bool tooFar = Dot(toCamera, toCamera) > maxDistanceSq;
+
+        // 画面上の大きさ ≒ 大きさ × pixelsPerUnit / 深度（カメラの後ろは大きさでは消さない）
+        const float depth = Dot(position, lod.depthAxis) + lod.depthOffset;
+        const Vector3& scale = pool.scale[i];
+        const float size = (std::max)({ scale.x, scale.y, scale.z })
+            * effect.scaleLut[ParticleEffect::LutIndex(pool.currentTime[i], pool.lifeTime[i])];
+        const bool tooSmall = depth > 0.0f && size * lod.pixelsPerUnit < minPixelSize * depth;
+
+        if (tooFar || tooSmall) {
+            pool.SwapRemove(i);
+            ++culled;
+            continue;
+        }
+        ++i;
+    }
+    return culled;
+}
+
+uint32_t ParticleSimulation::CollideParticles(const ParticleGroup& group, ParticlePool& pool, uint32_t begin, uint32_t end) const
+{
+    if (!collisionWorld_ || group.collision.mode == ParticleCollisionMode::None || begin >= end) {
+        return 0;
+    }
+
+    ParticleCollisionWorld::Batch batch {};
+    batch.position = &pool.translate[begin];
+    batch.velocity = &pool.velocity[begin];
+    batch.currentTime = &pool.currentTime[begin];
+    batch.lifeTime = &pool.lifeTime[begin];
+    batch.count = end - begin;
+    // Kill で寿命を終えた粒子は次の Update の RemoveDeadParticles で消える
+    return collisionWorld_->Resolve(batch, group.collision);
+}
+
+uint32_t ParticleSimulation::UpdateChunk(const UpdateJob& job, const ChunkParams& params)
+{
+    ParticleGroup& group = *job.group;
+    ParticlePool& pool = job.batch->particles;
+    const ParticleEffect& effect = *job.batch->effect;
+
+    // 更新
+    uint32_t collisionHits = 0;
+    if (params.stepTime > 0.0f) {
+        ParticleKernel::Integrate(effect, pool, job.begin, job.end, params.stepTime, &turbulenceField_);
+        collisionHits = CollideParticles(group, pool, job.begin, job.end);
+
+        // 天候は箱から出たら反対側へ（補間がずれないよう前ステップの位置も同じだけずらす）
+        if (group.weather) {
+            const Vector3& center = params.weatherCenter;
+            const Vector3& extents = params.weatherExtents;
+            for (uint32_t i = job.begin; i < job.end; ++i) {
+                const Vector3& p = pool.translate[i];
+                const Vector3 offset {
+                    WrapOffset(p.x, center.x, extents.x),
+                    WrapOffset(p.y, center.y, extents.y),
+                    WrapOffset(p.z, center.z, extents.z),
+                };
+                pool.translate[i] += offset;
+                pool.previousTranslate[i] += offset;
+            }
+        }
+    }
+
+    // 描画される分だけ書き出す（前のバッチ・チャンクで上限に達していれば 0）
+    const uint32_t drawCount = (std::min)(job.end - job.begin, group.numInstance - job.outOffset);
+    if (drawCount == 0) {
+        return collisionHits;
+    }
+    const uint32_t drawEnd = job.begin + drawCount;
+
+    const bool sorting = group.sortMode != ParticleSortMode::None;
+    ParticleForGPU* out = sorting ? &group.sortStaging[job.outOffset] : &group.instanceData[job.outOffset];
+    float* depth = sorting ? &group.sortDepth[job.outOffset] : nullptr;
+
+    for (uint32_t i = job.begin; i < drawEnd; ++i) {
+
+        // 描画位置（固定ステップ時は前ステップとの補間）
+        Vector3 position = pool.translate[i];
+        float age = pool.currentTime[i];
+        if (params.interpolate) {
+            const Vector3& prev = pool.previousTranslate[i];
+            position = prev + (position - prev) * params.interpolation;
+            age -= params.renderLag;
+        }
+
+        // 寿命カーブ（表引きだけ）
+        const uint32_t lut = ParticleEffect::LutIndex(age, pool.lifeTime[i]);
+        const Vector4& tint = effect.colorLut[lut];
+        const float scale = effect.scaleLut[lut];
+
+        // GPU へ（板は z = 0 なので x / y の大きさだけ送る）
+        const uint32_t k = i - job.begin;
+        out[k].position = position;
+        out[k].rotation = pool.rotate[i].z;
+        out[k].scale = { pool.scale[i].x * scale, pool.scale[i].y * scale };
+        out[k].color = PackColor(
+            pool.color[i].x * tint.x,
+            pool.color[i].y * tint.y,
+            pool.color[i].z * tint.z,
+            pool.color[i].w * tint.w);
+        out[k].frame = effect.frameBase + effect.FrameIndex(age, pool.lifeTime[i]);
+        if (depth) {
+            depth[k] = Dot(position, params.depthAxis) + params.depthOffset;
+        }
+    }
+    return collisionHits;
+}
+
+void ParticleSimulation::CreateParticleGroup(const std::string& name)
+{
+    // 重複チェック
+    assert(particleGroups_.find(name) == particleGroups_.end());
+
+    // 先に登録する（コールバックが name でグループを引けるように）
+    ParticleGroup& group = particleGroups_[name];
+    ResizeInstances(name, group, (std::min)(kInitialInstanceCapacity, maxInstancesPerGroup_));
+}
+
+const ParticleSimulation::ParticleGroup& ParticleSimulation::GetParticleGroup(const std::string& name) const
+{
+    auto it = particleGroups_.find(name);
+    assert(it != particleGroups_.end());
+    return it->second;
+}
+
+void ParticleSimulation::ResizeInstances(const std::string& name, ParticleGroup& group, uint32_t capacity)
+{
+    if (instanceBufferCallback_) {
+        group.hostInstances = {};
+        group.instanceData = instanceBufferCallback_(name, capacity);
+    } else {
+        group.hostInstances.resize(capacity);
+        group.instanceData = group.hostInstances.data();
+    }
+    group.instanceCapacity = group.instanceData ? capacity : 0;
+}
+
+void ParticleSimulation::SetEffects(std::vector<ParticleEffect> effects)
+{
+    // 古い定義を指すバッチを残さない
+    for (auto& [name, group] : particleGroups_) {
+        group.batches.clear();
+        group.numInstance = 0;
+    }
+    liveParticleCount_ = 0;
+    // 天候も古い定義を指しているので止める
+    if (!weather_.groupName.empty()) {
+        auto it = particleGroups_.find(weather_.groupName);
+        if (it != particleGroups_.end()) {
+            it->second.weather = false;
+        }
+    }
+    weather_ = {};
+    effects_.clear();
+
+    for (ParticleEffect& effect : effects) {
+        std::string effectName = effect.name;
+        effects_.insert_or_assign(std::move(effectName), std::move(effect));
+    }
+
+    // default.json が無くても動くように、旧 Emit と同じ見た目の定義を入れておく
+    if (effects_.find("default") == effects_.end()) {
+        ParticleEffect effect;
+        effect.name = "default";
+        effect.shape = ParticleSpawnShape::Box;
+        effect.extents = { 0.05f, 0.05f, 0.05f };
+        effect.speedMin = 1.0f;
+        effect.speedMax = 1.5f;
+        effect.lifeTimeMin = 0.8f;
+        effect.lifeTimeMax = 1.0f;
+        effect.scale = { 0.3f, 0.3f, 0.3f };
+        effects_.emplace("default", std::move(effect));
+    }
+}
+
+void ParticleSimulation::LoadTurbulenceField(const std::string& path, uint64_t seed)
+{
+    // シーンをまたいで使い回す（32^3 でも焼くのは起動時の一度だけ）
+    if (!turbulenceField_.Empty()) {
+        return;
+    }
+    if (path.empty() || !turbulenceField_.Load(path)) {
+        turbulenceField_.Bake(CurlNoiseField::kDefaultResolution, CurlNoiseField::kDefaultPeriod, seed);
+    }
+}
+
+const ParticleEffect& ParticleSimulation::GetEffect(const std::string& effectName) const
+{
+    auto it = effects_.find(effectName);
+    if (it == effects_.end()) {
+        it = effects_.find("default");
+    }
+    assert(it != effects_.end());
+    return it->second;
+}
+
+uint32_t ParticleSimulation::CountParticles(const ParticleGroup& group)
+{
+    uint32_t count = 0;
+    for (const ParticleBatch& batch : group.batches) {
+        count += batch.particles.Size();
+    }
+    return count;
+}
+
+void ParticleSimulation::Emit(const std::string& name, const std::string& effectName, const Vector3& position, uint32_t count)
+{
+    auto it = particleGroups_.find(name);
+    assert(it != particleGroups_.end());
+    ParticleGroup& group = it->second;
+
+    // 予算が埋まっていれば数を絞る
+    count = AdmitParticles(group, count);
+    if (count == 0) {
+        return;
+    }
+    liveParticleCount_ += count;
+
+    const ParticleEffect& effect = GetEffect(effectName);
+    ParticleBatch& batch = FindOrAddBatch(group, effect);
+
+    const uint32_t first = batch.particles.Append(count);
+    ParticleKernel::Spawn(effect, batch.particles, first, count, position, random_, randomScratch_, randomDirections_);
+}
+
+ParticleSimulation::ParticleBatch& ParticleSimulation::FindOrAddBatch(ParticleGroup& group, const ParticleEffect& effect)
+{
+    // 同じエフェクトのバッチへ足す（種類はせいぜい数個なので線形探索）
+    for (ParticleBatch& candidate : group.batches) {
+        if (candidate.effect == &effect) {
+            return candidate;
+        }
+    }
+    ParticleBatch& batch = group.batches.emplace_back();
+    batch.effect = &effect;
+    return batch;
+}
+
+void ParticleSimulation::SetWeather(const std::string& name, const std::string& effectName, float density)
+{
+    auto it = particleGroups_.find(name);
+    assert(it != particleGroups_.end());
+
+    // 前の天候は止める（グループが変わる場合は前のグループの粒子も消す）
+    if (!weather_.groupName.empty() && weather_.groupName != name) {
+        ClearWeather();
+    }
+
+    ParticleGroup& group = it->second;
+    group.weather = true;
+    const ParticleEffect& effect = GetEffect(effectName);
+    if (weather_.effect != &effect) {
+        group.batches.clear();
+    }
+
+    weather_.groupName = name;
+    weather_.effect = &effect;
+    SetWeatherDensity(density);
+}
+
+void ParticleSimulation::ClearWeather()
+{
+    auto it = particleGroups_.find(weather_.groupName);
+    if (it != particleGroups_.end()) {
+        it->second.weather = false;
+        it->second.batches.clear();
+        it->second.numInstance = 0;
+    }
+    weather_ = {};
+}
+
+void ParticleSimulation::RefillWeather(const Vector3& center, float pressure)
+{
+    weather_.liveCount = 0;
+    if (!weather_.effect) {
+        return;
+    }
+    auto it = particleGroups_.find(weather_.groupName);
+    if (it == particleGroups_.end()) {
+        return;
+    }
+    ParticleGroup& group = it->second;
+    const ParticleEffect& effect = *weather_.effect;
+    ParticlePool& pool = FindOrAddBatch(group, effect).particles;
+
+    // 目標数 = 予算 × density。予算が埋まってくるほど減らしてゲーム側の粒子に譲る
+    const float target = static_cast<float>(particleBudget_) * weather_.density * (1.0f - pressure);
+    const uint32_t targetCount = static_cast<uint32_t>(target);
+
+    uint32_t size = pool.Size();
+    if (size > targetCount) {
+        // 末尾から減らす（SwapRemove の末尾は入れ替えなし）
+        while (size > targetCount) {
+            pool.SwapRemove(--size);
+        }
+    } else if (size < targetCount) {
+        const bool firstFill = (size == 0);
+        const uint32_t count = targetCount - size;
+        const uint32_t first = pool.Append(count);
+        ParticleKernel::Spawn(effect, pool, first, count, center, random_, randomScratch_, randomDirections_);
+
+        // 最初に一斉に出すと一斉に消えるので、年齢をばらして入れ替わりを均す
+        if (firstFill) {
+            randomScratch_.resize(count);
+            random_.FillUniform(randomScratch_.data(), count, 0.0f, 1.0f);
+            for (uint32_t k = 0; k < count; ++k) {
+                pool.currentTime[first + k] = pool.lifeTime[first + k] * randomScratch_[k];
+            }
+        }
+    }
+    weather_.liveCount = pool.Size();
+}
+
+uint32_t ParticleSimulation::AdmitParticles(ParticleGroup& group, uint32_t requested)
+{
+    const uint32_t room = (liveParticleCount_ < particleBudget_) ? particleBudget_ - liveParticleCount_ : 0;
+
+    // 生存数が kThrottleStart を超えたら、残り枠に比例して減らす（優先度 2 なら半分埋まるまでは全部出す）
+    const float fill = static_cast<float>(liveParticleCount_) / static_cast<float>(particleBudget_);
+    float factor = 1.0f;
+    if (fill > kThrottleStart) {
+        factor = std::clamp((1.0f - fill) / (1.0f - kThrottleStart) * group.priority, 0.0f, 1.0f);
+    }
+
+    uint32_t admitted = requested;
+    if (factor < 1.0f) {
+        // 端数は持ち越す（少数ずつ出すエミッタが完全に止まらないように）
+        const float wanted = static_cast<float>(requested) * factor + group.emitCarry;
+        admitted = static_cast<uint32_t>(wanted);
+        group.emitCarry = wanted - static_cast<float>(admitted);
+    } else {
+        group.emitCarry = 0.0f;
+    }
+
+    // 予算は超えない
+    admitted = (std::min)(admitted, room);
+    pendingThrottledCount_ += requested - admitted;
+    return admitted;
+}
+
+void ParticleSimulation::SetGroupPriority(const std::string& name, float priority)
+{
+    auto it = particleGroups_.find(name);
+    assert(it != particleGroups_.end());
+    // 0 だと割り算で壊れるので下限を設ける
+    it->second.priority = (std::max)(priority, 0.01f);
+}
+
+void ParticleSimulation::SetCollision(const std::string& name, const ParticleCollisionResponse& response)
+{
+    auto it = particleGroups_.find(name);
+    assert(it != particleGroups_.end());
+    it->second.collision = response;
+    it->second.collisionHits = 0;
+}
+
+void ParticleSimulation::ClearAllParticles()
+{
+    for (auto& [name, group] : particleGroups_) {
+        for (ParticleBatch& batch : group.batches) {
+            batch.particles.Clear();
+        }
+        group.emitCarry = 0.0f;
+        group.culledCount = 0;
+        group.numInstance = 0;
+        group.droppedInstances = 0;
+    }
+    liveParticleCount_ = 0;
+}
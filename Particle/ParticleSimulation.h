@@ -0,0 +1,381 @@
+#pragma once
+#include "CurlNoiseField.h"
+#include "ParticleCollision.h"
+#include "ParticleEffect.h"
+#include "ParticlePool.h"
+#include "ParticleSort.h"
+#include "ParticleWorkerPool.h"
+#include "Random.h"
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ===============================
+// パーティクルのシミュレーション本体（D3D 非依存）
+// ===============================
+// グループ・エフェクト・予算/LOD・天候・当たり判定・並列更新を持ち、
+// Update で各グループのインスタンス（ParticleForGPU）を書き出すところまでやる
+// 書き出し先は既定ではグループごとの CPU 配列。SetInstanceBufferCallback で
+// 差し替えると、その領域（ParticleManager なら Map したアップロードバッファ）へ直接書く
+// デバイスが要らないので Linux のベンチマーク・決定性テストからも同じコードを回せる
+class ParticleSimulation {
+public:
+    // 1 インスタンス 32 バイト。ビルボードと VP は VS で掛ける（Particle.hlsli と同じ並び）
+    struct ParticleForGPU {
+        Vector3 position;
+        // 板の面内の回転（ラジアン）
+        float rotation;
+        Vector2 scale;
+        // RGBA8（R が下位バイト）
+        uint32_t color;
+        // フレーム表（UV 範囲）の添字
+        uint32_t frame;
+    };
+    static_assert(sizeof(ParticleForGPU) == 32, "Particle.hlsli の ParticleForGPU と揃えること");
+
+    // 同じエフェクトの粒子だけを並べた塊（更新ループがエフェクト種別で分岐しないように分ける）
+    struct ParticleBatch {
+        const ParticleEffect* effect = nullptr;
+        ParticlePool particles;
+    };
+
+    struct ParticleGroup {
+        // エフェクトごとの塊（初めて Emit された時に追加）
+        std::vector<ParticleBatch> batches;
+        // インスタンスの書き出し先（instanceCapacity 要素）
+        ParticleForGPU* instanceData = nullptr;
+        uint32_t instanceCapacity = 0;
+        // コールバックが無い時の書き出し先
+        std::vector<ParticleForGPU> hostInstances;
+        uint32_t numInstance = 0;
+        // 直近の Update で上限に当たって描けなかった数
+        uint32_t droppedInstances = 0;
+
+        // 奥→手前ソート（None ならソートせず instanceData に直接書く）
+        ParticleSortMode sortMode = ParticleSortMode::None;
+        // ソート時は一旦ここに書き、並べ替えながら instanceData へ写す
+        std::vector<ParticleForGPU> sortStaging;
+        std::vector<float> sortDepth;
+        // sortStaging の添字を奥→手前に並べたもの（Incremental では次フレームの初期値）
+        std::vector<uint32_t> sortOrder;
+        ParticleSort::Scratch sortScratch;
+        // Incremental で基数ソートに切り替えた回数（累計）
+        uint32_t sortFallbacks = 0;
+
+        // 予算が足りない時の優先度（大きいほど発生を絞られにくく、LOD で消されにくい）
+        float priority = 1.0f;
+        // 絞った発生数の端数（次の Emit に持ち越す）
+        float emitCarry = 0.0f;
+        // 直近の Update で LOD により消した数
+        uint32_t culledCount = 0;
+
+        // 天候グループ（カメラ周りの箱で巻き戻す・LOD で消さない）
+        bool weather = false;
+
+        // 壁・地面との当たり判定（None なら調べない）
+        ParticleCollisionResponse collision;
+        // 直近の Update で当たった数
+        uint32_t collisionHits = 0;
+    };
+
+    // Update に渡すカメラの情報（Camera から作る。テストでは固定値）
+    struct View {
+        Vector3 position;
+        Matrix4x4 viewProjection;
+        // 深度 1 の位置で大きさ 1 のものが何ピクセルになるか（射影の m[1][1] × 画面の高さ / 2）
+        float pixelsPerUnit;
+    };
+
+    // name のグループの書き出し先を capacity 要素ぶん用意して返す（メインスレッドから呼ぶ）
+    // 中身は毎フレーム書き直すので、古い内容を写す必要はない
+    using InstanceBufferCallback = std::function<ParticleForGPU*(const std::string& name, uint32_t capacity)>;
+
+    // グループ作成時の書き出し先の要素数（足りなければ倍々で伸ばす）
+    static constexpr uint32_t kInitialInstanceCapacity = 256;
+
+public:
+    // =========================================================
+    // 基本操作
+    // =========================================================
+    // workerCount 本の更新用スレッドを作り、乱数を初期化する（固定シードがあればそれを使う）
+    void Initialize(uint32_t workerCount = ParticleWorkerPool::DefaultWorkerCount());
+    // グループ・天候を捨ててスレッドを止める（エフェクトと乱流の場は残す）
+    void Finalize();
+    // deltaTime は実時間（秒）
+    void Update(float deltaTime, const View& view);
+
+    // 書き出し先を外から渡す（nullptr なら CPU 配列に戻す）。グループを作る前に設定すること
+    void SetInstanceBufferCallback(InstanceBufferCallback callback) { instanceBufferCallback_ = std::move(callback); }
+
+    void CreateParticleGroup(const std::string& name);
+    bool HasParticleGroup(const std::string& name) const { return particleGroups_.find(name) != particleGroups_.end(); }
+    const ParticleGroup& GetParticleGroup(const std::string& name) const;
+    // 全グループ（UI から優先度・当たり判定を直接いじる用）
+    std::unordered_map<std::string, ParticleGroup>& GetParticleGroups() { return particleGroups_; }
+    const std::unordered_map<std::string, ParticleGroup>& GetParticleGroups() const { return particleGroups_; }
+
+    // パーティクルの発生（effectName は SetEffects で渡した name。無ければ "default"）
+    void Emit(const std::string& name, const std::string& effectName, const Vector3& position, uint32_t count);
+    void ClearAllParticles();
+    // グループの生存数（全エフェクト合計）
+    static uint32_t CountParticles(const ParticleGroup& group);
+
+    // =========================================================
+    // エフェクト・乱流
+    // =========================================================
+    // エフェクト定義を差し替える（"default" が無ければ旧 Emit と同じ見た目の定義を足す）
+    // 古い定義を指すバッチと天候は捨てる
+    void SetEffects(std::vector<ParticleEffect> effects);
+    // 読み込んだエフェクト（無ければ "default"）
+    const ParticleEffect& GetEffect(const std::string& effectName) const;
+    // frameBase を埋める用（要素の追加・削除はしないこと）
+    std::unordered_map<std::string, ParticleEffect>& GetEffects() { return effects_; }
+    const std::unordered_map<std::string, ParticleEffect>& GetEffects() const { return effects_; }
+
+    // 乱流の場を path から読む（無ければ seed で焼く。一度作ったら使い回す）
+    void LoadTurbulenceField(const std::string& path, uint64_t seed);
+    const CurlNoiseField& GetTurbulenceField() const { return turbulenceField_; }
+
+    // =========================================================
+    // 乱数
+    // =========================================================
+    // 乱数のシードを固定する（リプレイ・テスト用。Initialize 後に呼んでもその場で反映）
+    void SetRandomSeed(uint64_t seed)
+    {
+        fixedSeed_ = seed;
+        hasFixedSeed_ = true;
+        random_.Seed(seed);
+    }
+    uint64_t GetRandomSeed() const { return random_.GetSeed(); }
+
+    // グループごとの奥→手前ソート（Normal ブレンドの煙など用）
+    void SetSortMode(const std::string& name, ParticleSortMode mode);
+
+    // =========================================================
+    // 予算・LOD
+    // =========================================================
+    // 全グループ合計の生存数の上限。埋まってくると Emit の数を優先度に応じて絞る
+    void SetParticleBudget(uint32_t budget) { particleBudget_ = (budget > 0) ? budget : 1; }
+    uint32_t GetParticleBudget() const { return particleBudget_; }
+    void SetGroupPriority(const std::string& name, float priority);
+    // この距離より遠い粒子を消す（優先度を掛けた距離で判定）
+    void SetLodDistance(float distance) { lodDistance_ = distance; }
+    float GetLodDistance() const { return lodDistance_; }
+    // 画面上の大きさ（ピクセル）がこれ未満の粒子を消す（優先度で割った値で判定）
+    void SetLodMinPixelSize(float pixels) { lodMinPixelSize_ = pixels; }
+    float GetLodMinPixelSize() const { return lodMinPixelSize_; }
+    uint32_t GetLiveParticleCount() const { return liveParticleCount_; }
+    // 直近フレームに絞られた発生数 / LOD で消した数
+    uint32_t GetThrottledCount() const { return throttledCount_; }
+    uint32_t GetCulledCount() const { return culledCount_; }
+
+    // =========================================================
+    // 天候（雨・雪・砂ぼこり）
+    // =========================================================
+    // カメラを中心とした箱（エフェクトの spawn.extents）の中だけで粒子を回し、
+    // 箱から出た粒子は反対側へ巻き戻す。ステージの広さに関係なく粒子数は一定
+    // density は予算に対する割合（0.05 なら予算の 5%）。予算が埋まってくると減らす
+    void SetWeather(const std::string& name, const std::string& effectName, float density);
+    void SetWeatherDensity(float density) { weather_.density = std::clamp(density, 0.0f, 1.0f); }
+    float GetWeatherDensity() const { return weather_.density; }
+    void ClearWeather();
+    // 直近の Update での天候の粒子数
+    uint32_t GetWeatherCount() const { return weather_.liveCount; }
+    // 天候のグループ名とエフェクト（止まっていれば空と nullptr）
+    const std::string& GetWeatherGroupName() const { return weather_.groupName; }
+    const ParticleEffect* GetWeatherEffect() const { return weather_.effect; }
+
+    // =========================================================
+    // 当たり判定
+    // =========================================================
+    // 壁・地面（シーンが持つ。nullptr なら当たり判定しない）
+    void SetCollisionWorld(const ParticleCollisionWorld* world) { collisionWorld_ = world; }
+    const ParticleCollisionWorld* GetCollisionWorld() const { return collisionWorld_; }
+    void SetCollision(const std::string& name, const ParticleCollisionResponse& response);
+
+    // 1グループあたりのインスタンス上限（超えた分は描画されず dropped に数える）
+    void SetMaxInstancesPerGroup(uint32_t maxInstances) { maxInstancesPerGroup_ = (maxInstances > 0) ? maxInstances : 1; }
+    uint32_t GetMaxInstancesPerGroup() const { return maxInstancesPerGroup_; }
+    // 直近の Update で全グループ合計何個落としたか
+    uint32_t GetDroppedInstanceCount() const { return droppedInstanceCount_; }
+    // 起動してからの累計
+    uint64_t GetTotalDroppedInstanceCount() const { return totalDroppedInstanceCount_; }
+
+    // =========================================================
+    // 時間・並列
+    // =========================================================
+    // 実時間 1 秒で何シミュレーション単位進めるか
+    void SetTimeScale(float timeScale) { timeScale_ = timeScale; }
+    float GetTimeScale() const { return timeScale_; }
+    // 固定ステップ幅（実時間・秒）。0 なら毎フレーム deltaTime で 1 回進める
+    // 固定ステップ時は余り時間ぶん前ステップとの補間で描画する
+    void SetFixedTimeStep(float seconds)
+    {
+        fixedTimeStep_ = (seconds > 0.0f) ? seconds : 0.0f;
+        accumulator_ = 0.0f;
+    }
+    float GetFixedTimeStep() const { return fixedTimeStep_; }
+    // 直近の Update で進めたステップ数
+    uint32_t GetLastStepCount() const { return lastStepCount_; }
+
+    // 複数スレッドで更新するか（粒子数が kParallelThreshold 未満なら常に単一スレッド）
+    void SetParallelUpdate(bool enable) { parallelUpdate_ = enable; }
+    bool IsParallelUpdate() const { return parallelUpdate_; }
+    uint32_t GetWorkerCount() const { return workerPool_ ? workerPool_->GetWorkerCount() : 0u; }
+
+private:
+    // =========================================================
+    // 内部処理
+    // =========================================================
+    // 更新対象グループ（このフレームの処理順）
+    struct ActiveGroup {
+        const std::string* name;
+        ParticleGroup* group;
+    };
+
+    // 1バッチの [begin, end) を担当する更新ジョブ
+    struct UpdateJob {
+        ParticleGroup* group;
+        ParticleBatch* batch;
+        uint32_t begin;
+        uint32_t end;
+        // instanceData 上の書き込み先（グループ内の前チャンク・前バッチの出力数の累積）
+        uint32_t outOffset;
+    };
+
+    // 最後のステップで全チャンク共通の値
+    struct ChunkParams {
+        // 移動させる時間（0 なら移動しない）
+        float stepTime;
+        // 描画時の前ステップ→最新ステップの補間率
+        float interpolation;
+        // 描画時刻が最新ステップからどれだけ遅れているか（シミュレーション単位）
+        float renderLag;
+        bool interpolate;
+        // ビュー深度 = dot(position, depthAxis) + depthOffset（VP の 4 列目 = クリップ w）
+        Vector3 depthAxis;
+        float depthOffset;
+        // 天候の箱（中心 ± extents）
+        Vector3 weatherCenter;
+        Vector3 weatherExtents;
+    };
+
+    // LOD 判定に使う値（Update の最初に 1 回作る）
+    struct LodParams {
+        Vector3 cameraPosition;
+        // ビュー深度 = dot(position, depthAxis) + depthOffset
+        Vector3 depthAxis;
+        float depthOffset;
+        // 深度 1 の位置で大きさ 1 のものが何ピクセルになるか
+        float pixelsPerUnit;
+        float maxDistance;
+        float minPixelSize;
+    };
+
+    // jobCount 個のジョブを並列（parallel = false ならこのスレッドで順に）実行する
+    // std::function への変換で毎回確保しないよう、fn は参照 1 個だけ持つラムダで包む
+    template <class Fn>
+    void ParallelFor(bool parallel, uint32_t jobCount, const Fn& fn);
+
+    // 書き出し先を capacity 要素で用意し直す
+    void ResizeInstances(const std::string& name, ParticleGroup& group, uint32_t capacity);
+    // 寿命切れを末尾と入れ替えて詰める
+    static void RemoveDeadParticles(ParticlePool& pool);
+    // 遠すぎる・小さすぎる粒子を消して、消した数を返す
+    static uint32_t CullParticles(ParticleBatch& batch, const LodParams& lod, float priority);
+    // 予算と優先度から、requested のうち実際に出す数を決める
+    uint32_t AdmitParticles(ParticleGroup& group, uint32_t requested);
+    // effect のバッチ（無ければ末尾に足す）
+    static ParticleBatch& FindOrAddBatch(ParticleGroup& group, const ParticleEffect& effect);
+    // 天候の粒子を目標数まで足す・減らす（pressure は予算の埋まり具合 0～1）
+    void RefillWeather(const Vector3& center, float pressure);
+    // 壁・地面に当てて、当たった数を返す
+    uint32_t CollideParticles(const ParticleGroup& group, ParticlePool& pool, uint32_t begin, uint32_t end) const;
+    // 移動 + 当たり判定 + インスタンスを instanceData に書く（他ジョブとは書き込み先が重ならない）
+    // 当たった数を返す
+    uint32_t UpdateChunk(const UpdateJob& job, const ChunkParams& params);
+    // sortStaging を深度順に並べ替えて instanceData へ写す
+    static void SortAndUpload(ParticleGroup& group);
+
+private:
+    std::unordered_map<std::string, ParticleGroup> particleGroups_;
+    InstanceBufferCallback instanceBufferCallback_;
+
+    uint32_t maxInstancesPerGroup_ = 65536;
+    uint32_t droppedInstanceCount_ = 0;
+    uint64_t totalDroppedInstanceCount_ = 0;
+
+    // =========================================================
+    // 予算・LOD
+    // =========================================================
+    // 生存数が予算のこの割合を超えたら発生を絞り始め、LOD も厳しくする
+    static constexpr float kThrottleStart = 0.75f;
+    uint32_t particleBudget_ = 100000;
+    // Update で数え直し、Emit で足す
+    uint32_t liveParticleCount_ = 0;
+    // 直近フレームに絞った数（Emit → Update の順に呼ばれるので Update で確定させる）
+    uint32_t throttledCount_ = 0;
+    uint32_t pendingThrottledCount_ = 0;
+    uint32_t culledCount_ = 0;
+    // 既定はカメラのファークリップ（見えない所だけ消す）
+    float lodDistance_ = 1000.0f;
+    float lodMinPixelSize_ = 0.5f;
+
+    // =========================================================
+    // 天候
+    // =========================================================
+    struct WeatherState {
+        std::string groupName;
+        const ParticleEffect* effect = nullptr;
+        float density = 0.0f;
+        uint32_t liveCount = 0;
+    };
+    WeatherState weather_;
+
+    // =========================================================
+    // 並列更新
+    // =========================================================
+    // 1ジョブあたりの粒子数
+    static constexpr uint32_t kParticleChunkSize = 2048;
+    // 全グループ合計がこれ未満なら単一スレッドで回す
+    static constexpr uint32_t kParallelThreshold = 4096;
+
+    std::unique_ptr<ParticleWorkerPool> workerPool_;
+    bool parallelUpdate_ = true;
+
+    std::vector<ActiveGroup> activeGroups_;
+    std::vector<UpdateJob> updateJobs_;
+    // ジョブごとの当たった数（ジョブ同士で書き込み先が重ならないよう分けておく）
+    std::vector<uint32_t> jobCollisionHits_;
+
+    const ParticleCollisionWorld* collisionWorld_ = nullptr;
+
+    // =========================================================
+    // エフェクト定義
+    // =========================================================
+    // 要素のアドレスを ParticleBatch が持つので、SetEffects 以外では追加・削除しない
+    std::unordered_map<std::string, ParticleEffect> effects_;
+    // 乱流（curl ノイズ）の場
+    CurlNoiseField turbulenceField_;
+
+    Random random_;
+    uint64_t fixedSeed_ = 0;
+    bool hasFixedSeed_ = false;
+    // Emit 時の乱数の置き場（毎回確保しないよう使い回す）
+    std::vector<float> randomScratch_;
+    std::vector<Vector3> randomDirections_;
+
+    // =========================================================
+    // 時間
+    // =========================================================
+    // 旧実装は 60Hz で 1 フレーム 0.1 進めていたので、見た目を変えないよう 6 倍
+    float timeScale_ = 6.0f;
+    float fixedTimeStep_ = 0.0f;
+    float accumulator_ = 0.0f;
+    // 1 フレームで進める固定ステップの上限（超えた分は捨てる）
+    static constexpr uint32_t kMaxSubSteps = 8;
+    uint32_t lastStepCount_ = 0;
+};
@@ -0,0 +1,166 @@
+#include "ParticleSort.h"
+#include <cstring>
+
+#pragma region 内部関数
+namespace {
+
+// keys / order を keys の昇順に並べる（LSD 基数ソート・安定）
+// 結果は keys / order に入る
+void RadixSort(std::vector<uint32_t>& keys, std::vector<uint32_t>& order,
+    std::vector<uint32_t>& keysTmp, std::vector<uint32_t>& orderTmp, uint32_t count)
+{
+    constexpr int kPasses = 4;
+    constexpr uint32_t kBuckets = 256;
+
+    keysTmp.resize(count);
+    orderTmp.resize(count);
+
+    // 4 パスぶんのヒストグラムを 1 回の走査で作る
+    uint32_t histogram[kPasses][kBuckets] = {};
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint32_t key = keys[i];
+        ++histogram[0][key & 0xff];
+        ++histogram[1][(key >> 8) & 0xff];
+        ++histogram[2][(key >> 16) & 0xff];
+        ++histogram[3][key >> 24];
+    }
+
+    uint32_t* srcKeys = keys.data();
+    uint32_t* srcOrder = order.data();
+    uint32_t* dstKeys = keysTmp.data();
+    uint32_t* dstOrder = orderTmp.data();
+
+    for (int pass = 0; pass < kPasses; ++pass) {
+        const int shift = pass * 8;
+        uint32_t* counts = histogram[pass];
+
+        // 全要素がこの桁で同じなら並びは変わらない（近い深度ばかりの時は上位桁が飛ばせる）
+        if (counts[(srcKeys[0] >> shift) & 0xff] == count) {
+            continue;
+        }
+
+        // 桁ごとの書き込み開始位置
+        uint32_t offset = 0;
+        for (uint32_t b = 0; b < kBuckets; ++b) {
+            const uint32_t n = counts[b];
+            counts[b] = offset;
+            offset += n;
+        }
+
+        for (uint32_t i = 0; i < count; ++i) {
+            const uint32_t key = srcKeys[i];
+            const uint32_t dst = counts[(key >> shift) & 0xff]++;
+            dstKeys[dst] = key;
+            dstOrder[dst] = srcOrder[i];
+        }
+
+        std::swap(srcKeys, dstKeys);
+        std::swap(srcOrder, dstOrder);
+    }
+
+    // 奇数回入れ替えた場合は作業領域側に結果がある
+    if (srcKeys != keys.data()) {
+        std::memcpy(keys.data(), srcKeys, sizeof(uint32_t) * count);
+        std::memcpy(order.data(), srcOrder, sizeof(uint32_t) * count);
+    }
+}
+
+// 奥→手前にしたいので深度キーを反転して昇順ソートに使う
+inline uint32_t BackToFrontKey(float depth)
+{
+    return ~ParticleSort::FloatToKey(depth);
+}
+
+} // namespace
+#pragma endregion
+
+#pragma region ソート
+uint32_t ParticleSort::FloatToKey(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    // 負数は全ビット反転、正数は符号ビットだけ立てる
+    const uint32_t mask = static_cast<uint32_t>(-static_cast<int32_t>(bits >> 31)) | 0x80000000u;
+    return bits ^ mask;
+}
+
+void ParticleSort::SortBackToFront(const float* depth, uint32_t count, std::vector<uint32_t>& order, Scratch& scratch)
+{
+    order.resize(count);
+    scratch.keys.resize(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        order[i] = i;
+        scratch.keys[i] = BackToFrontKey(depth[i]);
+    }
+    if (count < 2) {
+        return;
+    }
+    RadixSort(scratch.keys, order, scratch.keysTmp, scratch.orderTmp, count);
+}
+
+bool ParticleSort::SortBackToFrontIncremental(const float* depth, uint32_t count, std::vector<uint32_t>& order, Scratch& scratch)
+{
+    // -----------------------------
+    // 前回の並びを今回の添字範囲に合わせる
+    // -----------------------------
+    // 前回の order は [0, 前回の数) の並べ替えなので、
+    // 範囲外を抜けば [0, min) が残り、足りない [min, count) を末尾に足せばよい
+    const uint32_t previous = static_cast<uint32_t>(order.size());
+    const uint32_t kept = (previous < count) ? previous : count;
+    if (previous > count) {
+        uint32_t write = 0;
+        for (uint32_t j = 0; j < previous; ++j) {
+            if (order[j] < count) {
+                order[write++] = order[j];
+            }
+        }
+        order.resize(write);
+    }
+    order.resize(count);
+    for (uint32_t i = kept; i < count; ++i) {
+        order[i] = i;
+    }
+
+    // -----------------------------
+    // 並び順どおりにキーを並べて挿入ソート
+    // -----------------------------
+    scratch.keys.resize(count);
+    uint32_t* keys = scratch.keys.data();
+    uint32_t* indices = order.data();
+    for (uint32_t j = 0; j < count; ++j) {
+        keys[j] = BackToFrontKey(depth[indices[j]]);
+    }
+
+    // 同じキーは添字で比べる（前フレームの並びのままだと、詰め直しで入れ替わった添字の順が残って Radix と食い違う）
+    auto after = [&](uint32_t i, uint32_t key, uint32_t index) {
+        return keys[i] > key || (keys[i] == key && indices[i] > index);
+    };
+
+    const uint64_t budget = static_cast<uint64_t>(count) * kIncrementalMoveBudget;
+    uint64_t moves = 0;
+    for (uint32_t j = 1; j < count; ++j) {
+        const uint32_t key = keys[j];
+        const uint32_t index = indices[j];
+        if (!after(j - 1, key, index)) {
+            continue;
+        }
+
+        uint32_t i = j;
+        while (i > 0 && after(i - 1, key, index)) {
+            keys[i] = keys[i - 1];
+            indices[i] = indices[i - 1];
+            --i;
+        }
+        keys[i] = key;
+        indices[i] = index;
+
+        // 前フレームと大きく変わった（カメラが急に回った等）なら作り直す方が速い
+        moves += j - i;
+        if (moves > budget) {
+            SortBackToFront(depth, count, order, scratch);
+            return true;
+        }
+    }
+    return false;
+}
+#pragma endregion
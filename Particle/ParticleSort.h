@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// ===============================
+// パーティクルの奥→手前ソート
+// ===============================
+// 半透明（Normal ブレンド）は奥から描かないと前後が破綻するので、
+// インスタンスをビュー深度の降順に並べ替えた添字列を作る
+//
+// Radix       : 毎フレーム 32bit キーの基数ソート（8bit × 最大 4 パス）
+// Incremental : 前フレームの並びを初期値に挿入ソート
+//               粒子の前後関係は 1 フレームではほとんど変わらないので O(n) 近くで済む
+//               入れ替えが多すぎたら Radix に切り替える
+enum class ParticleSortMode {
+    None,
+    Radix,
+    Incremental,
+};
+
+class ParticleSort {
+
+public:
+    // 作業領域（グループごとに持って使い回す）
+    struct Scratch {
+        std::vector<uint32_t> keys;
+        std::vector<uint32_t> keysTmp;
+        std::vector<uint32_t> orderTmp;
+    };
+
+    // 挿入ソートで許す移動回数（1 要素あたり）。超えたら基数ソートに切り替える
+    static constexpr uint32_t kIncrementalMoveBudget = 4;
+
+    // float を「符号なし整数として比べると float の大小と一致する」キーにする
+    static uint32_t FloatToKey(float value);
+
+    // order[0..count) を depth の大きい順（奥→手前）の添字列にする
+    // depth が同じものは添字の小さい順
+    static void SortBackToFront(const float* depth, uint32_t count, std::vector<uint32_t>& order, Scratch& scratch);
+
+    // 前回の order を初期値にして並べ直す（count が変わっていても可）
+    // 結果は SortBackToFront と同じ（depth が同じものも添字の小さい順）
+    // 基数ソートに切り替えた場合は true
+    static bool SortBackToFrontIncremental(const float* depth, uint32_t count, std::vector<uint32_t>& order, Scratch& scratch);
+};
@@ -0,0 +1,99 @@
+#include "ParticleWorkerPool.h"
+
+ParticleWorkerPool::ParticleWorkerPool(uint32_t workerCount)
+{
+    threads_.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; ++i) {
+        threads_.emplace_back([this] { WorkerMain(); });
+    }
+}
+
+ParticleWorkerPool::~ParticleWorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        quit_ = true;
+    }
+    wakeCv_.notify_all();
+
+    for (std::thread& thread : threads_) {
+        thread.join();
+    }
+}
+
+uint32_t ParticleWorkerPool::DefaultWorkerCount()
+{
+    const uint32_t hardware = std::thread::hardware_concurrency();
+    return (hardware > 1) ? hardware - 1 : 0;
+}
+
+void ParticleWorkerPool::ParallelFor(uint32_t jobCount, const std::function<void(uint32_t)>& fn)
+{
+    if (jobCount == 0) {
+        return;
+    }
+
+    // ワーカーが居ない・ジョブが 1 個なら起こすだけ損
+    if (threads_.empty() || jobCount == 1) {
+        for (uint32_t i = 0; i < jobCount; ++i) {
+            fn(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = &fn;
+        jobCount_ = jobCount;
+        nextJob_.store(0, std::memory_order_relaxed);
+        busyWorkers_ = static_cast<uint32_t>(threads_.size());
+        ++generation_;
+    }
+    wakeCv_.notify_all();
+
+    // メインスレッドも同じキューから取る
+    RunJobs();
+
+    // 全ワーカーが抜けるまで待つ（fn の寿命はここまで）
+    std::unique_lock<std::mutex> lock(mutex_);
+    doneCv_.wait(lock, [this] { return busyWorkers_ == 0; });
+    task_ = nullptr;
+}
+
+void ParticleWorkerPool::RunJobs()
+{
+    const std::function<void(uint32_t)>& fn = *task_;
+    for (;;) {
+        const uint32_t job = nextJob_.fetch_add(1, std::memory_order_relaxed);
+        if (job >= jobCount_) {
+            break;
+        }
+        fn(job);
+    }
+}
+
+void ParticleWorkerPool::WorkerMain()
+{
+    uint64_t seenGeneration = 0;
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wakeCv_.wait(lock, [&] { return quit_ || generation_ != seenGeneration; });
+            if (quit_) {
+                return;
+            }
+            seenGeneration = generation_;
+        }
+
+        RunJobs();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --busyWorkers_;
+            if (busyWorkers_ == 0) {
+                doneCv_.notify_one();
+            }
+        }
+    }
+}
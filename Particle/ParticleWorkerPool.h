@@ -0,0 +1,56 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ===============================
+// パーティクル更新用のワーカースレッド
+// ===============================
+// スレッドは作りっぱなしにして毎フレーム起こすだけ（生成コストを払わない）
+// ジョブは番号で取り合うので実行順は不定。結果の並びを決めたい場合は
+// ジョブごとに書き込み先を分けておくこと
+class ParticleWorkerPool {
+
+public:
+    // workerCount = 0 なら呼び出しスレッドだけで実行する
+    explicit ParticleWorkerPool(uint32_t workerCount);
+    ~ParticleWorkerPool();
+
+    ParticleWorkerPool(const ParticleWorkerPool&) = delete;
+    ParticleWorkerPool& operator=(const ParticleWorkerPool&) = delete;
+
+    // fn(0) ～ fn(jobCount - 1) を実行する
+    // 呼び出しスレッドも手伝い、全ジョブが終わるまで戻らない
+    void ParallelFor(uint32_t jobCount, const std::function<void(uint32_t)>& fn);
+
+    uint32_t GetWorkerCount() const { return static_cast<uint32_t>(threads_.size()); }
+
+    // ハードウェアスレッド数からメインスレッドぶんを引いた数（最低 0）
+    static uint32_t DefaultWorkerCount();
+
+private:
+    void WorkerMain();
+    // 残っているジョブを取り尽くすまで回す
+    void RunJobs();
+
+private:
+    std::vector<std::thread> threads_;
+
+    std::mutex mutex_;
+    std::condition_variable wakeCv_;
+    std::condition_variable doneCv_;
+
+    const std::function<void(uint32_t)>* task_ = nullptr;
+    uint32_t jobCount_ = 0;
+    std::atomic<uint32_t> nextJob_ { 0 };
+
+    // まだ今回の ParallelFor から抜けていないワーカー数
+    uint32_t busyWorkers_ = 0;
+    // ParallelFor ごとに増やす（起床判定用）
+    uint64_t generation_ = 0;
+    bool quit_ = false;
+};
@@ -0,0 +1,373 @@
+#include "RibbonTrailManager.h"
+#include "MatrixMath.h"
+#include "Quaternion.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+RibbonTrailManager* RibbonTrailManager::instance = nullptr;
+
+RibbonTrailManager* RibbonTrailManager::GetInstance()
+{
+    if (!instance) {
+        instance = new RibbonTrailManager();
+    }
+    return instance;
+}
+
+#pragma region 初期化・終了
+void RibbonTrailManager::Initialize(DirectXCommon* dxCommon, Camera* camera, uint32_t maxTrails, uint32_t maxPointsPerTrail)
+{
+    dxCommon_ = dxCommon;
+    camera_ = camera;
+
+    maxTrails = (std::max)(maxTrails, 1u);
+    maxPointsPerTrail_ = (std::max)(maxPointsPerTrail, 2u);
+
+    // 軌跡・点はここで全部確保する（以降は区画を使い回すだけ）
+    trails_.assign(maxTrails, Trail {});
+    const size_t pointCount = static_cast<size_t>(maxTrails) * maxPointsPerTrail_;
+    pointPosition_.assign(pointCount, { 0.0f, 0.0f, 0.0f });
+    pointRight_.assign(pointCount, { 1.0f, 0.0f, 0.0f });
+    pointTime_.assign(pointCount, 0.0f);
+
+    CreateRootSignature();
+    CreateGraphicsPipeline();
+
+    // 頂点バッファ（1 点 = 2 頂点。Map したまま毎フレーム書く）
+    const UINT vertexBytes = static_cast<UINT>(sizeof(VertexForGPU) * pointCount * 2);
+    vertexResource_ = dxCommon_->CreateBufferResource(vertexBytes);
+    vertexResource_->SetName(L"RibbonTrailManager::VertexBuffer");
+    vertexResource_->Map(0, nullptr, reinterpret_cast<void**>(&vertexData_));
+    vertexBufferView_.BufferLocation = vertexResource_->GetGPUVirtualAddress();
+    vertexBufferView_.SizeInBytes = vertexBytes;
+    vertexBufferView_.StrideInBytes = sizeof(VertexForGPU);
+
+    transformResource_ = dxCommon_->CreateBufferResource(sizeof(TransformForGPU));
+    transformResource_->SetName(L"RibbonTrailManager::TransformCB");
+    transformResource_->Map(0, nullptr, reinterpret_cast<void**>(&transformData_));
+    transformData_->viewProjection = MatrixMath::MakeIdentity4x4();
+}
+
+void RibbonTrailManager::Finalize()
+{
+    if (dxCommon_) {
+        dxCommon_->WaitForGPU();
+    }
+
+    if (vertexResource_ && vertexData_) {
+        vertexResource_->Unmap(0, nullptr);
+        vertexData_ = nullptr;
+    }
+    if (transformResource_ && transformData_) {
+        transformResource_->Unmap(0, nullptr);
+        transformData_ = nullptr;
+    }
+    vertexResource_.Reset();
+    transformResource_.Reset();
+
+    rootSignature_.Reset();
+    for (int i = 0; i < kCountOfBlendMode; i++) {
+        pipelineStates_[i].Reset();
+    }
+
+    trails_.clear();
+    pointPosition_.clear();
+    pointRight_.clear();
+    pointTime_.clear();
+
+    dxCommon_ = nullptr;
+    camera_ = nullptr;
+}
+#pragma endregion
+
+#pragma region 軌跡の管理・記録
+RibbonTrailManager::TrailHandle RibbonTrailManager::CreateTrail(const TrailDesc& desc)
+{
+    for (uint32_t t = 0; t < trails_.size(); ++t) {
+        Trail& trail = trails_[t];
+        if (trail.active) {
+            continue;
+        }
+        trail = Trail {};
+        trail.active = true;
+        trail.desc = desc;
+        trail.desc.capacity = std::clamp(desc.capacity, 2u, maxPointsPerTrail_);
+        trail.desc.lifeTime = (std::max)(desc.lifeTime, 1.0e-3f);
+        return t;
+    }
+    return kInvalidTrail;
+}
+
+void RibbonTrailManager::DestroyTrail(TrailHandle handle)
+{
+    if (IsValid(handle)) {
+        trails_[handle] = Trail {};
+    }
+}
+
+void RibbonTrailManager::ResetTrail(TrailHandle handle)
+{
+    if (IsValid(handle)) {
+        trails_[handle].head = 0;
+        trails_[handle].count = 0;
+        trails_[handle].vertexCount = 0;
+    }
+}
+
+void RibbonTrailManager::Record(TrailHandle handle, const Vector3& position, const Vector3& rotate)
+{
+    if (!IsValid(handle)) {
+        return;
+    }
+    Trail& trail = trails_[handle];
+    const uint32_t capacity = trail.desc.capacity;
+
+    // ほとんど動いていなければ記録しない（古い点は寿命で消えていく）
+    if (trail.count > 0) {
+        const uint32_t newest = PointIndex(handle, (trail.head + capacity - 1) % capacity);
+        const Vector3 d = position - pointPosition_[newest];
+        if (Dot(d, d) < trail.desc.minDistance * trail.desc.minDistance) {
+            return;
+        }
+    }
+
+    // 満杯なら一番古い点に上書きする
+    const uint32_t index = PointIndex(handle, trail.head);
+    pointPosition_[index] = position;
+    Vector3 up, forward;
+    QuaternionMath::ToBasis(QuaternionMath::FromEulerXYZ(rotate), pointRight_[index], up, forward);
+    pointTime_[index] = trail.time;
+
+    trail.head = (trail.head + 1) % capacity;
+    trail.count = (std::min)(trail.count + 1, capacity);
+}
+
+uint32_t RibbonTrailManager::GetActiveTrailCount() const
+{
+    uint32_t count = 0;
+    for (const Trail& trail : trails_) {
+        count += trail.active ? 1u : 0u;
+    }
+    return count;
+}
+
+uint32_t RibbonTrailManager::GetPointCount(TrailHandle handle) const
+{
+    return IsValid(handle) ? trails_[handle].count : 0u;
+}
+#pragma endregion
+
+#pragma region 更新
+void RibbonTrailManager::Update(float deltaTime)
+{
+    if (!camera_) {
+        return;
+    }
+
+    deltaTime = (std::max)(deltaTime, 0.0f);
+    const Matrix4x4& cameraMat = camera_->GetWorldMatrix();
+    const Vector3 cameraPosition { cameraMat.m[3][0], cameraMat.m[3][1], cameraMat.m[3][2] };
+
+    for (TrailHandle t = 0; t < trails_.size(); ++t) {
+        Trail& trail = trails_[t];
+        if (!trail.active) {
+            continue;
+        }
+        trail.time += deltaTime;
+
+        // 寿命切れを古い側から落とす
+        const uint32_t capacity = trail.desc.capacity;
+        while (trail.count > 0) {
+            const uint32_t oldest = PointIndex(t, (trail.head + capacity - trail.count) % capacity);
+            if (trail.time - pointTime_[oldest] < trail.desc.lifeTime) {
+                break;
+            }
+            --trail.count;
+        }
+
+        BuildVertices(t, cameraPosition);
+    }
+
+    transformData_->viewProjection = camera_->GetViewProjectionMatrix();
+}
+
+void RibbonTrailManager::BuildVertices(TrailHandle handle, const Vector3& cameraPosition)
+{
+    Trail& trail = trails_[handle];
+    const TrailDesc& desc = trail.desc;
+    const uint32_t capacity = desc.capacity;
+    const uint32_t count = trail.count;
+    if (count < 2) {
+        trail.vertexCount = 0;
+        return;
+    }
+
+    // 区画の先頭（頂点は古い点から順に並べる）
+    VertexForGPU* out = vertexData_ + static_cast<size_t>(PointIndex(handle, 0)) * 2;
+    const uint32_t first = (trail.head + capacity - count) % capacity;
+    auto point = [&](uint32_t k) { return PointIndex(handle, (first + k) % capacity); };
+
+    const float invLife = 1.0f / desc.lifeTime;
+    Vector3 previousSide { 0.0f, 0.0f, 0.0f };
+
+    for (uint32_t k = 0; k < count; ++k) {
+        const uint32_t index = point(k);
+        const Vector3& p = pointPosition_[index];
+
+        // 帯を広げる向き
+        Vector3 side;
+        if (desc.faceCamera) {
+            // 進行方向と視線の両方に垂直（端は片側の差分）
+            const Vector3 tangent = pointPosition_[point((std::min)(k + 1, count - 1))] - pointPosition_[point(k > 0 ? k - 1 : 0)];
+            side = Normalize(Cross(tangent, cameraPosition - p));
+            // 視線と進行方向が重なった時は前の点の向きを使う
+            if (Dot(side, side) == 0.0f) {
+                side = previousSide;
+            }
+        } else {
+            side = pointRight_[index];
+        }
+        previousSide = side;
+
+        // 新しい側ほど太く・head の色に近い
+        const float age = std::clamp((trail.time - pointTime_[index]) * invLife, 0.0f, 1.0f);
+        const float halfWidth = desc.width * 0.5f * (1.0f + (desc.tailWidthScale - 1.0f) * age);
+        const Vector4 color {
+            desc.headColor.x + (desc.tailColor.x - desc.headColor.x) * age,
+            desc.headColor.y + (desc.tailColor.y - desc.headColor.y) * age,
+            desc.headColor.z + (desc.tailColor.z - desc.headColor.z) * age,
+            desc.headColor.w + (desc.tailColor.w - desc.headColor.w) * age,
+        };
+
+        out[k * 2 + 0] = { p - side * halfWidth, { age, 0.0f }, color };
+        out[k * 2 + 1] = { p + side * halfWidth, { age, 1.0f }, color };
+    }
+    trail.vertexCount = count * 2;
+}
+#pragma endregion
+
+#pragma region 描画
+void RibbonTrailManager::PreDraw()
+{
+    auto* cmd = dxCommon_->GetCommandList();
+    cmd->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+    cmd->SetGraphicsRootSignature(rootSignature_.Get());
+    cmd->SetPipelineState(pipelineStates_[currentBlendMode_].Get());
+    cmd->IASetVertexBuffers(0, 1, &vertexBufferView_);
+}
+
+void RibbonTrailManager::Draw()
+{
+    drawCallCount_ = 0;
+    if (!camera_) {
+        return;
+    }
+
+    auto* cmd = dxCommon_->GetCommandList();
+    cmd->SetGraphicsRootConstantBufferView(0, transformResource_->GetGPUVirtualAddress());
+
+    // 軌跡ごとに自分の区画だけ描く
+    for (TrailHandle t = 0; t < trails_.size(); ++t) {
+        const Trail& trail = trails_[t];
+        if (!trail.active || trail.vertexCount == 0) {
+            continue;
+        }
+        cmd->DrawInstanced(trail.vertexCount, 1, PointIndex(t, 0) * 2, 0);
+        ++drawCallCount_;
+    }
+}
+#pragma endregion
+
+#pragma region GPU リソース
+void RibbonTrailManager::CreateRootSignature()
+{
+    // [0] Transform (b0, VS)
+    D3D12_ROOT_PARAMETER rootParams[1] = {};
+    rootParams[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+    rootParams[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+    rootParams[0].Descriptor.ShaderRegister = 0;
+
+    D3D12_ROOT_SIGNATURE_DESC desc {};
+    desc.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+    desc.NumParameters = _countof(rootParams);
+    desc.pParameters = rootParams;
+
+    Microsoft::WRL::ComPtr<ID3DBlob> sigBlob;
+    Microsoft::WRL::ComPtr<ID3DBlob> errBlob;
+    HRESULT hr = D3D12SerializeRootSignature(&desc, D3D_ROOT_SIGNATURE_VERSION_1, &sigBlob, &errBlob);
+    if (FAILED(hr)) {
+        if (errBlob) {
+            OutputDebugStringA((char*)errBlob->GetBufferPointer());
+        }
+        assert(false);
+    }
+
+    hr = dxCommon_->GetDevice()->CreateRootSignature(
+        0,
+        sigBlob->GetBufferPointer(),
+        sigBlob->GetBufferSize(),
+        IID_PPV_ARGS(&rootSignature_));
+    assert(SUCCEEDED(hr));
+}
+
+void RibbonTrailManager::CreateGraphicsPipeline()
+{
+    // ====== 入力レイアウト（VertexForGPU） ======
+    D3D12_INPUT_ELEMENT_DESC inputElementDescs[3] = {};
+
+    inputElementDescs[0].SemanticName = "POSITION";
+    inputElementDescs[0].Format = DXGI_FORMAT_R32G32B32_FLOAT;
+    inputElementDescs[0].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+
+    inputElementDescs[1].SemanticName = "TEXCOORD";
+    inputElementDescs[1].Format = DXGI_FORMAT_R32G32_FLOAT;
+    inputElementDescs[1].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+
+    inputElementDescs[2].SemanticName = "COLOR";
+    inputElementDescs[2].Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+    inputElementDescs[2].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+
+    D3D12_INPUT_LAYOUT_DESC inputLayoutDesc {};
+    inputLayoutDesc.pInputElementDescs = inputElementDescs;
+    inputLayoutDesc.NumElements = _countof(inputElementDescs);
+
+    // ====== ラスタライザ・デプス（両面・深度は読むだけ） ======
+    D3D12_RASTERIZER_DESC rasterizerDesc {};
+    rasterizerDesc.CullMode = D3D12_CULL_MODE_NONE;
+    rasterizerDesc.FillMode = D3D12_FILL_MODE_SOLID;
+
+    D3D12_DEPTH_STENCIL_DESC depthStencilDesc {};
+    depthStencilDesc.DepthEnable = TRUE;
+    depthStencilDesc.StencilEnable = FALSE;
+    depthStencilDesc.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO;
+    depthStencilDesc.DepthFunc = D3D12_COMPARISON_FUNC_LESS_EQUAL;
+
+    // ====== シェーダーのコンパイル ======
+    Microsoft::WRL::ComPtr<IDxcBlob> vertexShaderBlob = dxCommon_->CompileShader(L"resources/shaders/Ribbon.VS.hlsl", L"vs_6_0");
+    Microsoft::WRL::ComPtr<IDxcBlob> pixelShaderBlob = dxCommon_->CompileShader(L"resources/shaders/Ribbon.PS.hlsl", L"ps_6_0");
+    assert(vertexShaderBlob && pixelShaderBlob);
+
+    D3D12_GRAPHICS_PIPELINE_STATE_DESC base {};
+    base.pRootSignature = rootSignature_.Get();
+    base.InputLayout = inputLayoutDesc;
+    base.VS = { vertexShaderBlob->GetBufferPointer(), vertexShaderBlob->GetBufferSize() };
+    base.PS = { pixelShaderBlob->GetBufferPointer(), pixelShaderBlob->GetBufferSize() };
+    base.RasterizerState = rasterizerDesc;
+    base.DepthStencilState = depthStencilDesc;
+    base.NumRenderTargets = 1;
+    base.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+    base.DSVFormat = DXGI_FORMAT_D24_UNORM_S8_UINT;
+    base.SampleDesc.Count = 1;
+    base.SampleMask = D3D12_DEFAULT_SAMPLE_MASK;
+    base.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+
+    for (int i = 0; i < kCountOfBlendMode; i++) {
+        D3D12_GRAPHICS_PIPELINE_STATE_DESC desc = base;
+        desc.BlendState = CreateBlendDesc(static_cast<BlendMode>(i));
+        HRESULT hr = dxCommon_->GetDevice()->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(&pipelineStates_[i]));
+        assert(SUCCEEDED(hr));
+        (void)hr;
+    }
+}
+#pragma endregion
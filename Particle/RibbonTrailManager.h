@@ -0,0 +1,150 @@
+#pragma once
+#include "Camera.h"
+#include "DirectXCommon.h"
+#include "blendutil.h"
+#include <d3d12.h>
+#include <vector>
+#include <wrl.h>
+
+// ===============================
+// 帯状の軌跡（ドローン・ゴーストの後ろに引く線）
+// ===============================
+// 軌跡ごとに固定長のリングバッファへ位置と向きを記録し、
+// 毎フレーム「1 点 = 左右 2 頂点」の三角形ストリップを Map しっぱなしの頂点バッファへ直接書く
+// 頂点バッファは全軌跡ぶんを Initialize で確保し、軌跡 i は i 番目の区画を使う（以降の確保は無し）
+// 描画は 1 軌跡 1 回
+class RibbonTrailManager {
+public:
+    // =========================================================
+    // Singleton Access
+    // =========================================================
+    static RibbonTrailManager* GetInstance();
+    void Finalize();
+
+    // =========================================================
+    // GPUに送る構造体
+    // =========================================================
+    // Ribbon.hlsli の RibbonVertex と同じ並び
+    struct VertexForGPU {
+        Vector3 position;
+        // x: 先頭からの割合（0 = 新しい側） y: 帯の左右（0 / 1）
+        Vector2 texcoord;
+        Vector4 color;
+    };
+
+    struct TransformForGPU {
+        Matrix4x4 viewProjection;
+    };
+
+    // 軌跡の見た目
+    struct TrailDesc {
+        // 記録する点の数（Initialize の maxPointsPerTrail まで）
+        uint32_t capacity = 64;
+        // 帯の幅（新しい側。古い側は tailWidthScale 倍まで細くなる）
+        float width = 0.25f;
+        float tailWidthScale = 0.0f;
+        // 1 点が残る時間（秒）
+        float lifeTime = 0.6f;
+        // 前の点からこれ以上動いた時だけ記録する（止まっている間に点を使い切らない）
+        float minDistance = 0.05f;
+        Vector4 headColor { 0.6f, 0.9f, 1.0f, 0.8f };
+        Vector4 tailColor { 0.2f, 0.5f, 1.0f, 0.0f };
+        // true: カメラを向く帯 false: 記録した向きの右方向に広げる（翼端の軌跡のような見た目）
+        bool faceCamera = true;
+    };
+
+    // 軌跡の番号（作れなかった時は kInvalidTrail）
+    using TrailHandle = uint32_t;
+    static constexpr TrailHandle kInvalidTrail = 0xFFFFFFFFu;
+
+    // 何も指定しない時の上限
+    static constexpr uint32_t kDefaultMaxTrails = 8;
+    static constexpr uint32_t kDefaultMaxPointsPerTrail = 128;
+
+public:
+    // =========================================================
+    // 基本操作
+    // =========================================================
+    // 軌跡の数・1 本あたりの点数の上限ぶんを確保する
+    void Initialize(DirectXCommon* dxCommon, Camera* camera,
+        uint32_t maxTrails = kDefaultMaxTrails, uint32_t maxPointsPerTrail = kDefaultMaxPointsPerTrail);
+    // 点を寿命で消して頂点を書く（deltaTime は実時間・秒）
+    void Update(float deltaTime);
+    void PreDraw();
+    void Draw();
+
+    // 空いている区画を使う（上限なら kInvalidTrail）
+    TrailHandle CreateTrail(const TrailDesc& desc);
+    void DestroyTrail(TrailHandle handle);
+    // 点を全部消す（ワープ・リスタート時など）
+    void ResetTrail(TrailHandle handle);
+
+    // 位置と向き（Object3d と同じ Euler 角）を記録する。毎 tick 呼ぶ
+    void Record(TrailHandle handle, const Vector3& position, const Vector3& rotate);
+
+    void SetCamera(Camera* camera) { camera_ = camera; }
+    void SetBlendMode(BlendMode mode) { currentBlendMode_ = mode; }
+
+    uint32_t GetActiveTrailCount() const;
+    uint32_t GetPointCount(TrailHandle handle) const;
+    // 直近の Draw で発行した描画コール数
+    uint32_t GetDrawCallCount() const { return drawCallCount_; }
+
+private:
+    // =========================================================
+    // Singleton Safety
+    // =========================================================
+    RibbonTrailManager() = default;
+    ~RibbonTrailManager() = default;
+
+    RibbonTrailManager(const RibbonTrailManager&) = delete;
+    RibbonTrailManager& operator=(const RibbonTrailManager&) = delete;
+    static RibbonTrailManager* instance;
+
+private:
+    struct Trail {
+        bool active = false;
+        TrailDesc desc;
+        // 次に書く位置と記録数（古い点は head - count）
+        uint32_t head = 0;
+        uint32_t count = 0;
+        // この軌跡の経過時間（記録時刻との差で寿命を見る）
+        float time = 0.0f;
+        uint32_t vertexCount = 0;
+    };
+
+    // 軌跡 t の k 番目の点（点の配列は軌跡ごとに maxPointsPerTrail_ ずつ区切ってある）
+    uint32_t PointIndex(TrailHandle t, uint32_t k) const { return t * maxPointsPerTrail_ + k; }
+    bool IsValid(TrailHandle handle) const { return handle < trails_.size() && trails_[handle].active; }
+    // 点から頂点を作って区画に書く
+    void BuildVertices(TrailHandle handle, const Vector3& cameraPosition);
+
+    void CreateRootSignature();
+    void CreateGraphicsPipeline();
+
+private:
+    DirectXCommon* dxCommon_ = nullptr;
+    Camera* camera_ = nullptr;
+
+    uint32_t maxPointsPerTrail_ = 0;
+    std::vector<Trail> trails_;
+
+    // 記録した点（SoA・全軌跡ぶん）
+    std::vector<Vector3> pointPosition_;
+    // 記録時の右方向（faceCamera = false の帯の向き）
+    std::vector<Vector3> pointRight_;
+    std::vector<float> pointTime_;
+
+    Microsoft::WRL::ComPtr<ID3D12RootSignature> rootSignature_;
+    Microsoft::WRL::ComPtr<ID3D12PipelineState> pipelineStates_[kCountOfBlendMode];
+    int currentBlendMode_ = kBlendModeAdd;
+
+    Microsoft::WRL::ComPtr<ID3D12Resource> vertexResource_;
+    VertexForGPU* vertexData_ = nullptr;
+    D3D12_VERTEX_BUFFER_VIEW vertexBufferView_ {};
+
+    Microsoft::WRL::ComPtr<ID3D12Resource> transformResource_;
+    TransformForGPU* transformData_ = nullptr;
+
+    uint32_t drawCallCount_ = 0;
+};
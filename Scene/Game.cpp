@@ -1,4 +1,5 @@
 #include "Game.h"
+#include <algorithm>
 #include <numbers>
 
 void Game::Initialize()
@@ -51,6 +52,17 @@ void Game::Update()
     // ======== ImGui begin ========
     ImGuiManager::GetInstance()->Begin();
 
+    // --- フレーム時間計測 ---
+    const auto now = std::chrono::steady_clock::now();
+    float deltaTime = 1.0f / 60.0f;
+    if (hasLastFrameTime_) {
+        deltaTime = std::chrono::duration<float>(now - lastFrameTime_).count();
+        deltaTime = (std::min)(deltaTime, kMaxDeltaTime);
+    }
+    lastFrameTime_ = now;
+    hasLastFrameTime_ = true;
+    SceneManager::GetInstance()->SetDeltaTime(deltaTime);
+
     // --- ゲーム更新 ---
     Input::GetInstance()->Update();
     // camera_->Update();
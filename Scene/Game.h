@@ -158,6 +158,14 @@ private:
 
     bool endRequest_ = false;
 
+    // ------------------------------
+    // フレーム時間
+    // ------------------------------
+    // ブレークポイントやロード明けの巨大な dt でシミュレーションが飛ばないように切る
+    static constexpr float kMaxDeltaTime = 0.1f;
+    std::chrono::steady_clock::time_point lastFrameTime_ {};
+    bool hasLastFrameTime_ = false;
+
     bool requestCapture_ = false;
     bool hideUIThisFrame_ = false;
 
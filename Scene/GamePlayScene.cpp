@@ -1,7 +1,10 @@
 #include "GamePlayScene.h"
 #include "../Light/LightManager.h"
 #include "ParticleManager.h"
+#include "MeshParticleManager.h"
+#include "RibbonTrailManager.h"
 #include "SphereObject.h"
+#include "ProjectionMath.h"
 #include <numbers>
 
 #include "../externals/nlohmann/json.hpp"
@@ -19,27 +22,6 @@ static inline Vector3 FromJsonVec3(const json& j) {
 	return Vector3{ j.at("x").get<float>(), j.at("y").get<float>(), j.at("z").get<float>() };
 }
 
-// ===== World -> Screen (row-vector行列想定) =====
-static Vector4 MulRowVec4Mat4(const Vector4& v, const Matrix4x4& m) {
-	Vector4 o{};
-	o.x = v.x * m.m[0][0] + v.y * m.m[1][0] + v.z * m.m[2][0] + v.w * m.m[3][0];
-	o.y = v.x * m.m[0][1] + v.y * m.m[1][1] + v.z * m.m[2][1] + v.w * m.m[3][1];
-	o.z = v.x * m.m[0][2] + v.y * m.m[1][2] + v.z * m.m[2][2] + v.w * m.m[3][2];
-	o.w = v.x * m.m[0][3] + v.y * m.m[1][3] + v.z * m.m[2][3] + v.w * m.m[3][3];
-	return o;
-}
-
-// ===== RowVec * Mat4 で w除算して Vector3 にする =====
-static Vector3 TransformCoord_RowVector4(const Vector4& v, const Matrix4x4& m) {
-	Vector4 o = MulRowVec4Mat4(v, m);
-	if (std::abs(o.w) > 1e-6f) {
-		o.x /= o.w;
-		o.y /= o.w;
-		o.z /= o.w;
-	}
-	return { o.x, o.y, o.z };
-}
-
 // ===== Screen -> World のレイ（y=0平面に当てる用）=====
 // D3DのNDC: x,y = [-1..1], z = [0..1] 想定
 static bool ScreenRayToPlaneY0_RowVector(
@@ -55,8 +37,8 @@ static bool ScreenRayToPlaneY0_RowVector(
 	float ndcY = 1.0f - ((float)mouseY / screenH) * 2.0f;
 
 	// near(z=0) と far(z=1) を unproject
-	Vector3 pNear = TransformCoord_RowVector4({ ndcX, ndcY, 0.0f, 1.0f }, invVP);
-	Vector3 pFar = TransformCoord_RowVector4({ ndcX, ndcY, 1.0f, 1.0f }, invVP);
+	Vector3 pNear = ProjectionMath::TransformCoord(Vector4{ ndcX, ndcY, 0.0f, 1.0f }, invVP);
+	Vector3 pFar = ProjectionMath::TransformCoord(Vector4{ ndcX, ndcY, 1.0f, 1.0f }, invVP);
 
 	// ray
 	Vector3 dir{ pFar.x - pNear.x, pFar.y - pNear.y, pFar.z - pNear.z };
@@ -78,50 +60,6 @@ static bool ScreenRayToPlaneY0_RowVector(
 	return true;
 }
 
-static bool WorldToScreen_RowVector(
-	const Vector3& worldPos,
-	const Matrix4x4& viewProj,
-	float screenW, float screenH,
-	ImVec2& outScreen) {
-	Vector4 clip = MulRowVec4Mat4({ worldPos.x, worldPos.y, worldPos.z, 1.0f }, viewProj);
-
-	// カメラ後ろ(またはwが小さい)は描かない
-	if (clip.w <= 1e-6f)
-		return false;
-
-	// NDC化
-	const float ndcX = clip.x / clip.w;
-	const float ndcY = clip.y / clip.w;
-
-	// 画面座標へ（左上原点）
-	outScreen.x = (ndcX * 0.5f + 0.5f) * screenW;
-	outScreen.y = (-ndcY * 0.5f + 0.5f) * screenH;
-
-	return true;
-}
-
-static bool WorldToScreen_RowVector(
-	const Vector3& worldPos,
-	const Matrix4x4& viewProj,
-	float screenW, float screenH,
-	Vector2& outScreen) {
-	Vector4 clip = MulRowVec4Mat4({ worldPos.x, worldPos.y, worldPos.z, 1.0f }, viewProj);
-
-	// カメラ後ろ(またはwが小さい)は描かない
-	if (clip.w <= 1e-6f)
-		return false;
-
-	// NDC化
-	const float ndcX = clip.x / clip.w;
-	const float ndcY = clip.y / clip.w;
-
-	// 画面座標へ（左上原点）
-	outScreen.x = (ndcX * 0.5f + 0.5f) * screenW;
-	outScreen.y = (-ndcY * 0.5f + 0.5f) * screenH;
-
-	return true;
-}
-
 void GamePlayScene::Initialize() {
 	camera_ = new Camera();
 	camera_->Initialize();
@@ -130,6 +68,9 @@ void GamePlayScene::Initialize() {
 	Object3dManager::GetInstance()->SetDefaultCamera(camera_);
 
 	ParticleManager::GetInstance()->Initialize(DirectXCommon::GetInstance(), SrvManager::GetInstance(), camera_);
+	MeshParticleManager::GetInstance()->Initialize(DirectXCommon::GetInstance(), SrvManager::GetInstance(), camera_);
+	RibbonTrailManager::GetInstance()->Initialize(DirectXCommon::GetInstance(), camera_);
+	droneTrail_ = RibbonTrailManager::GetInstance()->CreateTrail(RibbonTrailManager::TrailDesc{});
 
 	Object3dManager::GetInstance()->SetDefaultCamera(camera_);
 
@@ -150,12 +91,21 @@ void GamePlayScene::Initialize() {
 	player2_->SetTranslate({ 3.0f, 0.0f, 0.0f });
 	// player2_->SetRotate({ std::numbers::pi_v<float> / 2.0f, std::numbers::pi_v<float>, 0.0f });
 
-	ParticleManager::GetInstance()->CreateParticleGroup("circle", "resources/circle.png");
+	ParticleManager::GetInstance()->CreateParticleGroup("circle");
 	Transform t{};
 	t.translate = { 0.0f, 0.0f, 0.0f };
 
 	emitter_.Init("circle", t, 30, 0.1f);
 
+	ParticleCollisionResponse sparkCollision;
+	sparkCollision.mode = ParticleCollisionMode::Bounce;
+	sparkCollision.restitution = 0.5f;
+	ParticleManager::GetInstance()->SetCollision("circle", sparkCollision);
+
+	// 天候（カメラの周りだけで回すのでコースの広さに関係なく一定数）
+	ParticleManager::GetInstance()->CreateParticleGroup("weather");
+	ParticleManager::GetInstance()->SetWeather("weather", "dust", 0.02f);
+
 	sphere_ = new SphereObject();
 	sphere_->Initialize(DirectXCommon::GetInstance(), 16, 1.0f);
 
@@ -252,6 +202,14 @@ void GamePlayScene::Initialize() {
 			wallSys_.AddOBB(w.center, w.half, w.rot);
 		}
 	}
+	// ドローンの当たり判定で近くの壁だけ引けるように
+	wallSys_.CompileWalls();
+
+	// 火花・着地の破片が壁と地面で跳ねるように
+	particleCollision_.SetGround(drone_.GetMinY() - droneHalf_.y);
+	wallSys_.BuildParticleCollision(particleCollision_);
+	ParticleManager::GetInstance()->SetCollisionWorld(&particleCollision_);
+	MeshParticleManager::GetInstance()->SetCollisionWorld(&particleCollision_);
 
 	goalSys_.Initialize(Object3dManager::GetInstance(), camera_);
 	goalSys_.Reset();
@@ -280,12 +238,12 @@ void GamePlayScene::Initialize() {
 	ground_->SetEnableLighting(false);
 	ground_->SetTranslate({ 0.0f, -5.5f, 0.0f });
 
-	landingEffect_.Initialize(Object3dManager::GetInstance(), camera_);
+	landingEffect_.Initialize();
 
 
 	skydome_->SetTranslate({ 0.0f,0.01f,0.0f });
 
-	particleGate_.Initialize(Object3dManager::GetInstance(), camera_);
+	particleGate_.Initialize();
 	//===========
 	//マーカー
 	//===========
@@ -314,7 +272,8 @@ void GamePlayScene::Initialize() {
 
 void GamePlayScene::Update() {
 
-	float dt = 1.0f / 60.0f;
+	// 実測のフレーム時間（高リフレッシュレートや処理落ちでも見た目の速さを揃える）
+	const float dt = SceneManager::GetInstance()->GetDeltaTime();
 
 	//入出力取得
 	Input& input = *Input::GetInstance();
@@ -377,7 +336,6 @@ void GamePlayScene::Update() {
 		landingEffect_.Play(drone_.GetPos());
 
 	}
-	landingEffect_.Update(dt);
 
 	// ドローン実体 → 描画Object3dへ反映（毎フレーム必須）
 	if (droneObj_) {
@@ -385,6 +343,8 @@ void GamePlayScene::Update() {
 		droneObj_->SetRotate({ drone_.GetPitch(), drone_.GetYaw() + droneYawOffset, drone_.GetRoll() });
 		droneObj_->Update();
 	}
+	RibbonTrailManager::GetInstance()->Record(droneTrail_, drone_.GetPos(),
+		{ drone_.GetPitch(), drone_.GetYaw() + droneYawOffset, drone_.GetRoll() });
 
 	// これを毎フレーム呼ぶ
 	camera_->FollowDroneRigid(drone_, 7.5f, 1.8f, -0.18f, droneYawOffset);
@@ -392,8 +352,10 @@ void GamePlayScene::Update() {
 
 
 	// 更新系
-	emitter_.Update();
-	ParticleManager::GetInstance()->Update();
+	emitter_.Update(dt);
+	ParticleManager::GetInstance()->Update(dt);
+	MeshParticleManager::GetInstance()->Update(dt);
+	RibbonTrailManager::GetInstance()->Update(dt);
 	player2_->Update();
 	sprite_->Update();
 	UpdateCompass_();
@@ -412,8 +374,6 @@ void GamePlayScene::Update() {
 	//  camera_->DebugUpdate();
 
 
-	particleGate_.Update(dt);
-
 	camera_->Update();
 
 	// ゲート
@@ -582,6 +542,8 @@ void GamePlayScene::Update() {
 
 	ImGui::End();
 
+	ParticleManager::GetInstance()->ImGui();
+
 	ImGui::Begin("Drone Tuning");
 	ImGui::SliderAngle("Yaw Offset", &droneYawOffset); // -pi～+pi を度で触れる
 
@@ -741,10 +703,16 @@ void GamePlayScene::Draw3D() {
 	if (drawWallDebug_) {
 		wallSys_.DrawDebug();
 	}
-	landingEffect_.Draw();
 
+	// ゲート通過・着地の破片（モデルごとに 1 回のインスタンス描画）
+	MeshParticleManager::GetInstance()->PreDraw();
+	LightManager::GetInstance()->Bind(DirectXCommon::GetInstance()->GetCommandList());
+	MeshParticleManager::GetInstance()->Draw();
+
+	// 軌跡（1 本 1 回）
+	RibbonTrailManager::GetInstance()->PreDraw();
+	RibbonTrailManager::GetInstance()->Draw();
 
-	particleGate_.Draw();
 	//sphere_->Draw(DirectXCommon::GetInstance()->GetCommandList());
 	ParticleManager::GetInstance()->PreDraw();
 	ParticleManager::GetInstance()->Draw();
@@ -783,7 +751,12 @@ void GamePlayScene::DrawImGui() {
 }
 
 void GamePlayScene::Finalize() {
+	ParticleManager::GetInstance()->SetCollisionWorld(nullptr);
 	ParticleManager::GetInstance()->Finalize();
+	MeshParticleManager::GetInstance()->SetCollisionWorld(nullptr);
+	MeshParticleManager::GetInstance()->Finalize();
+	RibbonTrailManager::GetInstance()->Finalize();
+	droneTrail_ = RibbonTrailManager::kInvalidTrail;
 
 	LightManager::GetInstance()->Finalize();
 
@@ -1093,14 +1066,19 @@ void GamePlayScene::DrawGateIndices2D_()
 	gateNum_.SetColor({ 1,0,0,1 });
 	gateNum_.DrawString(100, 100, "TEST", 2.0f);
 
-	for (int i = 0; i < (int)gates_.size(); ++i) {
+	// 全ゲート中心をまとめて投影
+	gateScreen_.resize(gates_.size());
+	if (!gates_.empty()) {
+		ProjectionMath::ProjectToScreen(&gates_[0].gate.pos, gateScreen_.data(), gates_.size(), vp, W, H, sizeof(GateVisual));
+	}
 
-		Vector3 labelPos = gates_[i].gate.pos;
+	for (int i = 0; i < (int)gates_.size(); ++i) {
 
-		Vector2 screen{};
-		if (!WorldToScreen_RowVector(labelPos, vp, W, H, screen)) {
+		// カメラ後ろだけ弾く（画面外は描いても見えないだけなのでそのまま）
+		if (gateScreen_[i].flags & ProjectionMath::kBehind) {
 			continue;
 		}
+		const Vector2& screen = gateScreen_[i].position;
 
 		// ★ここで「そのゲートの色」を決めて
 		if (i == nextGate_) gateNum_.SetColor({ 1,1,0,1 });
@@ -6,6 +6,7 @@
 #include "Object3dManager.h"
 #include "ParticleEmitter.h"
 #include "ParticleManager.h"
+#include "RibbonTrailManager.h"
 #include "SoundManager.h"
 #include "Sprite.h"
 #include "SpriteManager.h"
@@ -24,6 +25,7 @@
 #include"../Game/LandingEffect/LandingEffect.h"
 #include "../Game/Particle/ParticleGate.h"
 #include "BitmapFont.h"
+#include "ProjectionMath.h"
 class SphereObject;
 class GamePlayScene : public BaseScene {
 public:
@@ -76,6 +78,8 @@ private:
 	// --- Drone ---
 	Object3d* droneObj_ = nullptr;
 	Drone drone_;
+	// 機体の後ろに引く軌跡
+	RibbonTrailManager::TrailHandle droneTrail_ = RibbonTrailManager::kInvalidTrail;
 
 	// --- 追従カメラ（後ろから見る） ---
 	float camDist_ = 8.0f;
@@ -94,11 +98,14 @@ private:
 	int goodCount_ = 0;
 
 	BitmapFont gateNum_;  // ゲート番号描画用
+	std::vector<ScreenPoint> gateScreen_; // ゲート番号の投影結果（毎フレーム再利用）
 
 	void DrawGateIndices2D_();
 
 	//壁
 	WallSystem wallSys_;
+	// パーティクル用の壁・地面（wallSys_ から作る）
+	ParticleCollisionWorld particleCollision_;
 	Vector3 droneHalf_ = { 0.1f, 0.1f, 0.1f }; // ドローン当たり判定（半サイズ）
 	bool drawWallDebug_ = true;
 
@@ -48,6 +48,10 @@ public:
 
     void DrawImGui();
 
+    // 前フレームからの経過秒（Game が毎フレーム計測してセットする）
+    void SetDeltaTime(float deltaTime) { deltaTime_ = deltaTime; }
+    float GetDeltaTime() const { return deltaTime_; }
+
     void SetSelectedStageFile(const std::string& file) { selectedStageFile_ = file; }
     const std::string& GetSelectedStageFile() const { return selectedStageFile_; }
 
@@ -64,5 +68,6 @@ private:
     BaseScene* nextScene_ = nullptr;
     std::string selectedStageFile_;
     ThumbnailRequest thumb_;
+    float deltaTime_ = 1.0f / 60.0f;
 
 };
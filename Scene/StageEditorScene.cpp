@@ -1,5 +1,6 @@
 ﻿#include "StageEditorScene.h"
 #include "../Light/LightManager.h"
+#include "ProjectionMath.h"
 
 #include "../externals/nlohmann/json.hpp"
 #include <fstream>
@@ -18,17 +19,6 @@ static inline Vector3 FromJsonVec3(const json& j) {
     return Vector3{ j.at("x").get<float>(), j.at("y").get<float>(), j.at("z").get<float>() };
 }
 
-// ===== World -> Screen (row-vector行列想定) =====
-static Vector4 MulRowVec4Mat4(const Vector4& v, const Matrix4x4& m)
-{
-    Vector4 o{};
-    o.x = v.x * m.m[0][0] + v.y * m.m[1][0] + v.z * m.m[2][0] + v.w * m.m[3][0];
-    o.y = v.x * m.m[0][1] + v.y * m.m[1][1] + v.z * m.m[2][1] + v.w * m.m[3][1];
-    o.z = v.x * m.m[0][2] + v.y * m.m[1][2] + v.z * m.m[2][2] + v.w * m.m[3][2];
-    o.w = v.x * m.m[0][3] + v.y * m.m[1][3] + v.z * m.m[2][3] + v.w * m.m[3][3];
-    return o;
-}
-
 static std::string Vec3Str(const Vector3& v)
 {
     char buf[128];
@@ -36,15 +26,6 @@ static std::string Vec3Str(const Vector3& v)
     return std::string(buf);
 }
 
-static Vector3 TransformCoord_RowVector4(const Vector4& v, const Matrix4x4& m)
-{
-    Vector4 o = MulRowVec4Mat4(v, m);
-    if (std::abs(o.w) > 1e-6f) {
-        o.x /= o.w; o.y /= o.w; o.z /= o.w;
-    }
-    return { o.x, o.y, o.z };
-}
-
 static float DistSq3(const Vector3& a, const Vector3& b)
 {
     const float dx = a.x - b.x;
@@ -105,8 +86,8 @@ static bool ScreenRayToPlaneY0_RowVector(
     float ndcX = ((float)mouseX / screenW) * 2.0f - 1.0f;
     float ndcY = 1.0f - ((float)mouseY / screenH) * 2.0f;
 
-    Vector3 pNear = TransformCoord_RowVector4({ ndcX, ndcY, 0.0f, 1.0f }, invVP);
-    Vector3 pFar = TransformCoord_RowVector4({ ndcX, ndcY, 1.0f, 1.0f }, invVP);
+    Vector3 pNear = ProjectionMath::TransformCoord(Vector4{ ndcX, ndcY, 0.0f, 1.0f }, invVP);
+    Vector3 pFar = ProjectionMath::TransformCoord(Vector4{ ndcX, ndcY, 1.0f, 1.0f }, invVP);
 
     Vector3 dir{ pFar.x - pNear.x, pFar.y - pNear.y, pFar.z - pNear.z };
     float len = std::sqrt(dir.x * dir.x + dir.y * dir.y + dir.z * dir.z);
@@ -121,36 +102,6 @@ static bool ScreenRayToPlaneY0_RowVector(
     return true;
 }
 
-static bool WorldToScreen_RowVector(
-    const Vector3& worldPos,
-    const Matrix4x4& viewProj,
-    float screenW, float screenH,
-    Vector2& outScreen
-)
-{
-    // world -> clip
-    Vector4 clip = MulRowVec4Mat4({ worldPos.x, worldPos.y, worldPos.z, 1.0f }, viewProj);
-
-    // カメラ後ろ（w<=0）は弾く（ここ重要）
-    if (clip.w <= 1e-6f) return false;
-
-    // clip -> ndc
-    const float ndcX = clip.x / clip.w;
-    const float ndcY = clip.y / clip.w;
-    const float ndcZ = clip.z / clip.w; // D3Dなら 0..1 期待
-
-    // 画面外を弾きたいなら
-    if (ndcX < -1.0f || ndcX > 1.0f) return false;
-    if (ndcY < -1.0f || ndcY > 1.0f) return false;
-    if (ndcZ < 0.0f || ndcZ > 1.0f) return false;
-
-    // ndc -> screen
-    outScreen.x = (ndcX * 0.5f + 0.5f) * screenW;
-    outScreen.y = (1.0f - (ndcY * 0.5f + 0.5f)) * screenH; // 上が0
-
-    return true;
-}
-
 static std::string WideToUtf8(const std::wstring& ws)
 {
     if (ws.empty()) return {};
@@ -334,6 +285,7 @@ void StageEditorScene::Initialize()
     wallSys_.AddAABB({ 0.0f, 2.0f, 12.0f }, { 6.0f, 2.0f, 0.5f });
     wallSys_.AddAABB({ 8.0f, 2.0f, 10.0f }, { 0.5f, 2.0f, 6.0f });
     wallSys_.AddOBB({ -4.0f, 2.0f, 18.0f }, { 4.0f, 2.0f, 0.5f }, { 0.0f, 0.6f, 0.0f });
+    wallSys_.CompileWalls();
 
     // -------------------------
     // Goal
@@ -412,7 +364,7 @@ void StageEditorScene::Finalize()
 
 void StageEditorScene::Update()
 {
-    float dt = 1.0f / 60.0f;
+    const float dt = SceneManager::GetInstance()->GetDeltaTime();
     Input& input = *Input::GetInstance();
 
     // =========================
@@ -1014,6 +966,7 @@ bool StageEditorScene::LoadStageJson(const std::string& fileName) {
     }
 
     wallSys_.Walls() = data.walls;
+    wallSys_.CompileWalls();
 
     goalSys_.Reset();
     stageCleared_ = false;
@@ -1531,17 +1484,18 @@ void StageEditorScene::DrawGateIndices_()
 
   
 
-    for (int i = 0; i < (int)gates_.size(); ++i) {
-        const Vector3 p = gates_[i].gate.pos;
-
-        // 少し上に出す（ゲート中心に被るのが嫌なら）
-        Vector3 labelPos = p;
-        labelPos.y += 0.0f;
+    // 全ゲート中心をまとめて投影
+    gateScreen_.resize(gates_.size());
+    if (!gates_.empty()) {
+        ProjectionMath::ProjectToScreen(&gates_[0].gate.pos, gateScreen_.data(), gates_.size(), vp, W, H, sizeof(GateVisual));
+    }
 
-        Vector2 screen{};
-        if (!WorldToScreen_RowVector(labelPos, vp, W, H, screen)) {
+    for (int i = 0; i < (int)gates_.size(); ++i) {
+        // カメラ後ろ・画面外・深度範囲外は弾く
+        if (gateScreen_[i].flags != 0) {
             continue;
         }
+        const Vector2& screen = gateScreen_[i].position;
 
         // 文字列は "0", "1", ...
         const std::string txt = std::to_string(i);
@@ -21,6 +21,7 @@
 #include "../Game/Gate/GateVisual.h"
 #include "../Game/Drone/Walls.h"
 #include "../Game/Goal/GoalSystem.h"
+#include "ProjectionMath.h"
 
 #include <vector>
 #include <string>
@@ -82,6 +83,7 @@ private:
     void DrawEditorParamHud_();
 
     void DrawGateIndices_();
+    std::vector<ScreenPoint> gateScreen_; // ゲート番号の投影結果（毎フレーム再利用）
 
     Vector3 camPosInit_{ 0.0f, 3.0f, -10.0f };
     float camYawInit_ = 0.0f;
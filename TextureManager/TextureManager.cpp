@@ -58,11 +58,31 @@ void TextureManager::LoadTexture(const std::string& filePath)
     HRESULT hr = DirectX::LoadFromWICFile(filePathW.c_str(), DirectX::WIC_FLAGS_FORCE_SRGB, nullptr, image);
     assert(SUCCEEDED(hr));
 
-    // ミップマップ生成
-    DirectX::ScratchImage mipImages {};
-    hr = DirectX::GenerateMipMaps(image.GetImages(), image.GetImageCount(), image.GetMetadata(),
-        DirectX::TEX_FILTER_SRGB, 0, mipImages);
-    assert(SUCCEEDED(hr));
+    LoadTextureFromImage(filePath, image);
+}
+
+//=================================================================
+// メモリ上の画像の登録
+//=================================================================
+void TextureManager::LoadTextureFromImage(const std::string& filePath, const DirectX::ScratchImage& image, size_t mipLevels)
+{
+    //読み込み済みテクスチャを検索
+    if (textureDatas.contains(filePath)) {
+        return;
+    }
+
+    // テクスチャ上限チェック
+    assert(srvManager_->CanAllocate());
+
+    // ミップマップ生成（1 段だけなら元の画像をそのまま使う。GenerateMipMaps は 2 段以上しか作れない）
+    DirectX::ScratchImage generated {};
+    if (mipLevels != 1) {
+        HRESULT hr = DirectX::GenerateMipMaps(image.GetImages(), image.GetImageCount(), image.GetMetadata(),
+            DirectX::TEX_FILTER_SRGB, mipLevels, generated);
+        assert(SUCCEEDED(hr));
+        (void)hr;
+    }
+    const DirectX::ScratchImage& mipImages = (mipLevels != 1) ? generated : image;
 
 // テクスチャデータを追加して書き込む
     TextureData& textureData = textureDatas[filePath];
@@ -30,6 +30,9 @@ public:
     void Initialize(DirectXCommon* dxCommon, SrvManager* srvManager);
     // テクスチャ読み込み（同名ファイルは二重読み込みしない）
     void LoadTexture(const std::string& filePath);
+    // メモリ上の画像を key の名前で登録する（同名は二重登録しない）
+    // mipLevels: 作るミップの段数（0 なら LoadTexture と同じく 1x1 まで全部、1 ならミップなし）
+    void LoadTextureFromImage(const std::string& key, const DirectX::ScratchImage& image, size_t mipLevels = 0);
 
     //==================================================================
     //  情報取得系
@@ -0,0 +1,230 @@
+#include "AffineMatrix.h"
+#include "SinCos.h"
+#include <cmath>
+
+#pragma region アフィン行列関数
+// 単位行列
+AffineMatrix AffineMath::MakeIdentity()
+{
+    AffineMatrix result {};
+    result.m[0][0] = 1.0f;
+    result.m[1][1] = 1.0f;
+    result.m[2][2] = 1.0f;
+    return result;
+}
+
+// S*Rx*Ry*Rz*T を展開済みの式で作る
+// 行列を S*Rx*Ry*Rz*T の順に掛けた結果とビット一致する（MatrixMath::MakeAffineMatrix もこれを使う）
+AffineMatrix AffineMath::MakeAffine(const Vector3& scale, const Vector3& rotate, const Vector3& translate, SinCosMode mode)
+{
+    float s[4], c[4];
+    SinCosMath::SinCos3(rotate.x, rotate.y, rotate.z, s, c, mode);
+    const float cx = c[0], sx = s[0];
+    const float cy = c[1], sy = s[1];
+    const float cz = c[2], sz = s[2];
+
+    AffineMatrix result;
+
+    // Rx*Ry の各行 (a, b, c) に Rz を掛けると (a*cz + b*sz, -a*sz + b*cz, c)
+    const float a0 = cy, b0 = 0.0f, c0 = sy;
+    const float a1 = -sx * sy, b1 = cx, c1 = sx * cy;
+    const float a2 = -cx * sy, b2 = -sx, c2 = cx * cy;
+
+    result.m[0][0] = scale.x * (a0 * cz + b0 * sz);
+    result.m[0][1] = scale.x * (-a0 * sz + b0 * cz);
+    result.m[0][2] = scale.x * c0;
+
+    result.m[1][0] = scale.y * (a1 * cz + b1 * sz);
+    result.m[1][1] = scale.y * (-a1 * sz + b1 * cz);
+    result.m[1][2] = scale.y * c1;
+
+    result.m[2][0] = scale.z * (a2 * cz + b2 * sz);
+    result.m[2][1] = scale.z * (-a2 * sz + b2 * cz);
+    result.m[2][2] = scale.z * c2;
+
+    result.m[3][0] = translate.x;
+    result.m[3][1] = translate.y;
+    result.m[3][2] = translate.z;
+
+    return result;
+}
+
+AffineMatrix AffineMath::MakeAffineFromBasis(const Vector3& scale, const Vector3 (&axis)[3], const Vector3& translate)
+{
+    AffineMatrix result;
+    result.m[0][0] = scale.x * axis[0].x;
+    result.m[0][1] = scale.x * axis[0].y;
+    result.m[0][2] = scale.x * axis[0].z;
+    result.m[1][0] = scale.y * axis[1].x;
+    result.m[1][1] = scale.y * axis[1].y;
+    result.m[1][2] = scale.y * axis[1].z;
+    result.m[2][0] = scale.z * axis[2].x;
+    result.m[2][1] = scale.z * axis[2].y;
+    result.m[2][2] = scale.z * axis[2].z;
+    result.m[3][0] = translate.x;
+    result.m[3][1] = translate.y;
+    result.m[3][2] = translate.z;
+    return result;
+}
+
+AffineMatrix AffineMath::FromMatrix4x4(const Matrix4x4& m)
+{
+    AffineMatrix result;
+    for (int i = 0; i < 4; ++i)
+        for (int j = 0; j < 3; ++j)
+            result.m[i][j] = m.m[i][j];
+    return result;
+}
+
+Matrix4x4 AffineMath::ToMatrix4x4(const AffineMatrix& a)
+{
+    Matrix4x4 result;
+    for (int i = 0; i < 4; ++i) {
+        result.m[i][0] = a.m[i][0];
+        result.m[i][1] = a.m[i][1];
+        result.m[i][2] = a.m[i][2];
+        result.m[i][3] = 0.0f;
+    }
+    result.m[3][3] = 1.0f;
+    return result;
+}
+
+// a*b（row-vector なので a が先に適用される）
+AffineMatrix AffineMath::Multiply(const AffineMatrix& a, const AffineMatrix& b)
+{
+    AffineMatrix result;
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            result.m[i][j] = a.m[i][0] * b.m[0][j] + a.m[i][1] * b.m[1][j] + a.m[i][2] * b.m[2][j];
+        }
+    }
+    // 平行移動行は b の平行移動を足す
+    result.m[3][0] += b.m[3][0];
+    result.m[3][1] += b.m[3][1];
+    result.m[3][2] += b.m[3][2];
+    return result;
+}
+
+// 一般のアフィン逆行列
+AffineMatrix AffineMath::Inverse(const AffineMatrix& a)
+{
+    const auto& m = a.m;
+
+    // 3x3 の余因子（転置済み = 随伴行列）
+    AffineMatrix result;
+    result.m[0][0] = m[1][1] * m[2][2] - m[1][2] * m[2][1];
+    result.m[0][1] = m[0][2] * m[2][1] - m[0][1] * m[2][2];
+    result.m[0][2] = m[0][1] * m[1][2] - m[0][2] * m[1][1];
+    result.m[1][0] = m[1][2] * m[2][0] - m[1][0] * m[2][2];
+    result.m[1][1] = m[0][0] * m[2][2] - m[0][2] * m[2][0];
+    result.m[1][2] = m[0][2] * m[1][0] - m[0][0] * m[1][2];
+    result.m[2][0] = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+    result.m[2][1] = m[0][1] * m[2][0] - m[0][0] * m[2][1];
+    result.m[2][2] = m[0][0] * m[1][1] - m[0][1] * m[1][0];
+
+    const float det = m[0][0] * result.m[0][0] + m[0][1] * result.m[1][0] + m[0][2] * result.m[2][0];
+    if (det == 0.0f) {
+        return AffineMatrix {}; // MatrixMath::Inverse と同じく零行列
+    }
+
+    const float invDet = 1.0f / det;
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            result.m[i][j] *= invDet;
+
+    // t' = -t * L^-1
+    for (int j = 0; j < 3; ++j) {
+        result.m[3][j] = -(m[3][0] * result.m[0][j] + m[3][1] * result.m[1][j] + m[3][2] * result.m[2][j]);
+    }
+    return result;
+}
+
+// (S*R)^-1 = R^T * S^-1
+// 行 i の長さ² を s_i² とすると inv[i][j] = L[j][i] / s_j²
+AffineMatrix AffineMath::InverseScaleRotate(const AffineMatrix& a)
+{
+    const auto& m = a.m;
+
+    float invSq[3];
+    for (int i = 0; i < 3; ++i) {
+        const float sq = m[i][0] * m[i][0] + m[i][1] * m[i][1] + m[i][2] * m[i][2];
+        invSq[i] = (sq != 0.0f) ? 1.0f / sq : 0.0f;
+    }
+
+    AffineMatrix result;
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            result.m[i][j] = m[j][i] * invSq[j];
+
+    for (int j = 0; j < 3; ++j) {
+        result.m[3][j] = -(m[3][0] * result.m[0][j] + m[3][1] * result.m[1][j] + m[3][2] * result.m[2][j]);
+    }
+    return result;
+}
+
+// (L^-1)^T = 余因子行列 / det
+Matrix4x4 AffineMath::NormalMatrix(const AffineMatrix& a)
+{
+    const auto& m = a.m;
+
+    Matrix4x4 result {};
+    result.m[0][0] = m[1][1] * m[2][2] - m[1][2] * m[2][1];
+    result.m[0][1] = m[1][2] * m[2][0] - m[1][0] * m[2][2];
+    result.m[0][2] = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+    result.m[1][0] = m[0][2] * m[2][1] - m[0][1] * m[2][2];
+    result.m[1][1] = m[0][0] * m[2][2] - m[0][2] * m[2][0];
+    result.m[1][2] = m[0][1] * m[2][0] - m[0][0] * m[2][1];
+    result.m[2][0] = m[0][1] * m[1][2] - m[0][2] * m[1][1];
+    result.m[2][1] = m[0][2] * m[1][0] - m[0][0] * m[1][2];
+    result.m[2][2] = m[0][0] * m[1][1] - m[0][1] * m[1][0];
+    result.m[3][3] = 1.0f;
+
+    const float det = m[0][0] * result.m[0][0] + m[0][1] * result.m[0][1] + m[0][2] * result.m[0][2];
+    if (det == 0.0f) {
+        return result; // 潰れた行列は向きだけ残す（シェーダー側で normalize される）
+    }
+
+    const float invDet = 1.0f / det;
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            result.m[i][j] *= invDet;
+    return result;
+}
+
+// 直交行の場合、逆転置は「各行を s_i² で割る」だけ
+Matrix4x4 AffineMath::NormalMatrixScaleRotate(const AffineMatrix& a)
+{
+    const auto& m = a.m;
+
+    Matrix4x4 result {};
+    for (int i = 0; i < 3; ++i) {
+        const float sq = m[i][0] * m[i][0] + m[i][1] * m[i][1] + m[i][2] * m[i][2];
+        const float inv = (sq != 0.0f) ? 1.0f / sq : 0.0f;
+        result.m[i][0] = m[i][0] * inv;
+        result.m[i][1] = m[i][1] * inv;
+        result.m[i][2] = m[i][2] * inv;
+    }
+    result.m[3][3] = 1.0f;
+    return result;
+}
+
+Vector3 AffineMath::TransformPoint(const Vector3& v, const AffineMatrix& a)
+{
+    const auto& m = a.m;
+    return {
+        v.x * m[0][0] + v.y * m[1][0] + v.z * m[2][0] + m[3][0],
+        v.x * m[0][1] + v.y * m[1][1] + v.z * m[2][1] + m[3][1],
+        v.x * m[0][2] + v.y * m[1][2] + v.z * m[2][2] + m[3][2]
+    };
+}
+
+Vector3 AffineMath::TransformVector(const Vector3& v, const AffineMatrix& a)
+{
+    const auto& m = a.m;
+    return {
+        v.x * m[0][0] + v.y * m[1][0] + v.z * m[2][0],
+        v.x * m[0][1] + v.y * m[1][1] + v.z * m[2][1],
+        v.x * m[0][2] + v.y * m[1][2] + v.z * m[2][2]
+    };
+}
+#pragma endregion
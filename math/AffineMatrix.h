@@ -0,0 +1,43 @@
+#pragma once
+#include "MathStruct.h"
+#include "SinCos.h"
+
+// ===============================
+// アフィン行列（row-vector 運用）
+// ===============================
+// m[0..2] : 線形部分（各行 = ローカル軸 × スケール）
+// m[3]    : 平行移動
+// 4列目は常に (0,0,0,1) なので持たない
+struct AffineMatrix {
+    float m[4][3];
+};
+
+class AffineMath {
+
+public:
+    static AffineMatrix MakeIdentity();
+    // MatrixMath::MakeAffineMatrix と同じ S*Rx*Ry*Rz*T
+    static AffineMatrix MakeAffine(const Vector3& scale, const Vector3& rotate, const Vector3& translate,
+        SinCosMode mode = SinCosMode::Exact);
+    // 回転済みのローカル軸（CachedOrientation::axis など）から作る
+    static AffineMatrix MakeAffineFromBasis(const Vector3& scale, const Vector3 (&axis)[3], const Vector3& translate);
+    // 4列目は (0,0,0,1) とみなして捨てる
+    static AffineMatrix FromMatrix4x4(const Matrix4x4& m);
+    static Matrix4x4 ToMatrix4x4(const AffineMatrix& a);
+
+    static AffineMatrix Multiply(const AffineMatrix& a, const AffineMatrix& b);
+
+    // 一般のアフィン逆行列（3x3 余因子 + 平行移動）
+    static AffineMatrix Inverse(const AffineMatrix& a);
+    // 線形部分の行が直交している（S*R の形、せん断なし）前提の高速逆行列
+    // 回転のみならただの転置になる
+    static AffineMatrix InverseScaleRotate(const AffineMatrix& a);
+
+    // 法線変換用の逆転置 3x3（4x4 の左上に入れて返す）
+    static Matrix4x4 NormalMatrix(const AffineMatrix& a);
+    // InverseScaleRotate と同じ前提の高速版
+    static Matrix4x4 NormalMatrixScaleRotate(const AffineMatrix& a);
+
+    static Vector3 TransformPoint(const Vector3& v, const AffineMatrix& a);
+    static Vector3 TransformVector(const Vector3& v, const AffineMatrix& a);
+};
@@ -25,23 +25,38 @@ struct Transform {
 // Vector3 演算関数
 // ===============================
 
-inline Vector3 operator+(const Vector3& a, const Vector3& b) { return { a.x + b.x, a.y + b.y, a.z + b.z }; }
-inline Vector3 operator-(const Vector3& a, const Vector3& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
-inline Vector3 operator*(const Vector3& a, float s) { return { a.x * s, a.y * s, a.z * s }; }
-inline Vector3& operator+=(Vector3& a, const Vector3& b)
+constexpr Vector3 operator+(const Vector3& a, const Vector3& b) { return { a.x + b.x, a.y + b.y, a.z + b.z }; }
+constexpr Vector3 operator-(const Vector3& a, const Vector3& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+constexpr Vector3 operator-(const Vector3& v) { return { -v.x, -v.y, -v.z }; }
+constexpr Vector3 operator*(const Vector3& a, float s) { return { a.x * s, a.y * s, a.z * s }; }
+constexpr Vector3 operator*(float s, const Vector3& a) { return { a.x * s, a.y * s, a.z * s }; }
+constexpr Vector3 operator/(const Vector3& a, float s) { return { a.x / s, a.y / s, a.z / s }; }
+constexpr Vector3& operator+=(Vector3& a, const Vector3& b)
 {
     a.x += b.x;
     a.y += b.y;
     a.z += b.z;
     return a;
 }
-inline Vector3& operator-=(Vector3& a, const Vector3& b)
+constexpr Vector3& operator-=(Vector3& a, const Vector3& b)
 {
     a.x -= b.x;
     a.y -= b.y;
     a.z -= b.z;
     return a;
 }
+constexpr Vector3& operator*=(Vector3& a, float s)
+{
+    a.x *= s;
+    a.y *= s;
+    a.z *= s;
+    return a;
+}
+constexpr float Dot(const Vector3& a, const Vector3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+constexpr Vector3 Cross(const Vector3& a, const Vector3& b)
+{
+    return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+}
 inline Vector3 Normalize(const Vector3& v)
 {
     float len = std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
@@ -1,109 +1,237 @@
 #include "MatrixMath.h"
+#include "SimdConfig.h"
+#include "AffineMatrix.h"
+#include "SinCos.h"
 #include <cmath>
-#pragma region 行列関数
-// 単位行列の作成
-Matrix4x4 MatrixMath::MakeIdentity4x4()
+#include <cstdint>
+
+#pragma region SIMD補助
+#if defined(MATH_USE_SSE)
+namespace {
+
+#define MM_SHUFFLE_MASK(x, y, z, w) ((x) | ((y) << 2) | ((z) << 4) | ((w) << 6))
+#define MM_SWIZZLE(v, x, y, z, w) _mm_shuffle_ps((v), (v), MM_SHUFFLE_MASK(x, y, z, w))
+#define MM_SHUFFLE(a, b, x, y, z, w) _mm_shuffle_ps((a), (b), MM_SHUFFLE_MASK(x, y, z, w))
+
+struct Rows4 {
+    __m128 r[4];
+};
+
+inline Rows4 LoadRows(const Matrix4x4& m)
 {
-    Matrix4x4 result {};
-    for (int i = 0; i < 4; ++i)
-        result.m[i][i] = 1.0f;
-    return result;
+    return { { _mm_loadu_ps(m.m[0]), _mm_loadu_ps(m.m[1]), _mm_loadu_ps(m.m[2]), _mm_loadu_ps(m.m[3]) } };
 }
-// 拡大縮小行列S
-Matrix4x4 MatrixMath::Matrix4x4MakeScaleMatrix(const Vector3& s)
+
+inline void StoreRows(const Rows4& rows, Matrix4x4& out)
 {
-    Matrix4x4 result = {};
-    result.m[0][0] = s.x;
-    result.m[1][1] = s.y;
-    result.m[2][2] = s.z;
-    result.m[3][3] = 1.0f;
-    return result;
+    _mm_storeu_ps(out.m[0], rows.r[0]);
+    _mm_storeu_ps(out.m[1], rows.r[1]);
+    _mm_storeu_ps(out.m[2], rows.r[2]);
+    _mm_storeu_ps(out.m[3], rows.r[3]);
 }
 
+// row(1x4) * m(4x4)
+// スカラー版と同じ k=0→3 の順で加算するので結果はビット一致する（FMA縮約が無い限り）
+inline __m128 MulRow(const float* row, const Rows4& m)
+{
+    __m128 r = _mm_mul_ps(_mm_set1_ps(row[0]), m.r[0]);
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(row[1]), m.r[1]));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(row[2]), m.r[2]));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(row[3]), m.r[3]));
+    return r;
+}
+
+// 2x2 行列（x y / z w）の積 A*B
+inline __m128 Mat2Mul(__m128 a, __m128 b)
+{
+    return _mm_add_ps(_mm_mul_ps(a, MM_SWIZZLE(b, 0, 3, 0, 3)),
+        _mm_mul_ps(MM_SWIZZLE(a, 1, 0, 3, 2), MM_SWIZZLE(b, 2, 1, 2, 1)));
+}
+// adj(A)*B
+inline __m128 Mat2AdjMul(__m128 a, __m128 b)
+{
+    return _mm_sub_ps(_mm_mul_ps(MM_SWIZZLE(a, 3, 3, 0, 0), b),
+        _mm_mul_ps(MM_SWIZZLE(a, 1, 1, 2, 2), MM_SWIZZLE(b, 2, 3, 0, 1)));
+}
+// A*adj(B)
+inline __m128 Mat2MulAdj(__m128 a, __m128 b)
+{
+    return _mm_sub_ps(_mm_mul_ps(a, MM_SWIZZLE(b, 3, 0, 3, 0)),
+        _mm_mul_ps(MM_SWIZZLE(a, 1, 0, 3, 2), MM_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+} // namespace
+#endif
+#pragma endregion
+
+#pragma region 行列関数
 // X軸回転行列R
-Matrix4x4 MatrixMath::MakeRotateXMatrix(float radian)
+Matrix4x4 MatrixMath::MakeRotateXMatrix(float radian, SinCosMode mode)
 {
     Matrix4x4 result = {};
+    float s, c;
+    SinCosMath::SinCos(radian, s, c, mode);
 
     result.m[0][0] = 1.0f;
-    result.m[1][1] = std::cos(radian);
-    result.m[1][2] = std::sin(radian);
-    result.m[2][1] = -std::sin(radian);
-    result.m[2][2] = std::cos(radian);
+    result.m[1][1] = c;
+    result.m[1][2] = s;
+    result.m[2][1] = -s;
+    result.m[2][2] = c;
     result.m[3][3] = 1.0f;
 
     return result;
 }
 // Y軸回転行列R
-Matrix4x4 MatrixMath::MakeRotateYMatrix(float radian)
+Matrix4x4 MatrixMath::MakeRotateYMatrix(float radian, SinCosMode mode)
 {
     Matrix4x4 result = {};
+    float s, c;
+    SinCosMath::SinCos(radian, s, c, mode);
 
-    result.m[0][0] = std::cos(radian);
-    result.m[0][2] = std::sin(radian);
+    result.m[0][0] = c;
+    result.m[0][2] = s;
     result.m[1][1] = 1.0f;
-    result.m[2][0] = -std::sin(radian);
-    result.m[2][2] = std::cos(radian);
+    result.m[2][0] = -s;
+    result.m[2][2] = c;
     result.m[3][3] = 1.0f;
 
     return result;
 }
 // Z軸回転行列R
-Matrix4x4 MatrixMath::MakeRotateZMatrix(float radian)
+Matrix4x4 MatrixMath::MakeRotateZMatrix(float radian, SinCosMode mode)
 {
     Matrix4x4 result = {};
+    float s, c;
+    SinCosMath::SinCos(radian, s, c, mode);
 
-    result.m[0][0] = std::cos(radian);
-    result.m[0][1] = -std::sin(radian);
-    result.m[1][0] = std::sin(radian);
-    result.m[1][1] = std::cos(radian);
+    result.m[0][0] = c;
+    result.m[0][1] = -s;
+    result.m[1][0] = s;
+    result.m[1][1] = c;
     result.m[2][2] = 1.0f;
     result.m[3][3] = 1.0f;
 
     return result;
 }
 
-// 平行移動行列T
-Matrix4x4 MatrixMath::MakeTranslateMatrix(const Vector3& tlanslate)
-{
-    Matrix4x4 result = {};
-    result.m[0][0] = 1.0f;
-    result.m[1][1] = 1.0f;
-    result.m[2][2] = 1.0f;
-    result.m[3][3] = 1.0f;
-    result.m[3][0] = tlanslate.x;
-    result.m[3][1] = tlanslate.y;
-    result.m[3][2] = tlanslate.z;
-
-    return result;
-}
-// 行列の積
-Matrix4x4 MatrixMath::Multiply(const Matrix4x4& m1, const Matrix4x4& m2)
+// 行列の積（実行時用）
+Matrix4x4 MatrixMath::MultiplyRuntime_(const Matrix4x4& m1, const Matrix4x4& m2)
 {
     Matrix4x4 result {};
+#if defined(MATH_USE_SSE)
+    const Rows4 b = LoadRows(m2);
+    _mm_storeu_ps(result.m[0], MulRow(m1.m[0], b));
+    _mm_storeu_ps(result.m[1], MulRow(m1.m[1], b));
+    _mm_storeu_ps(result.m[2], MulRow(m1.m[2], b));
+    _mm_storeu_ps(result.m[3], MulRow(m1.m[3], b));
+#else
     for (int i = 0; i < 4; ++i)
         for (int j = 0; j < 4; ++j)
-            for (int k = 0; k < 4; ++k)
-                result.m[i][j] += m1.m[i][k] * m2.m[k][j];
+            result.m[i][j] = m1.m[i][0] * m2.m[0][j] + m1.m[i][1] * m2.m[1][j] + m1.m[i][2] * m2.m[2][j] + m1.m[i][3] * m2.m[3][j];
+#endif
     return result;
 }
+// まとめて worlds[i] * viewProjection（パーティクル等の大量行列向け）
+void MatrixMath::MultiplyBatch(const Matrix4x4* worlds, const Matrix4x4& viewProjection, Matrix4x4* out, size_t count, size_t outStride)
+{
+    uint8_t* dst = reinterpret_cast<uint8_t*>(out);
+
+#if defined(MATH_USE_AVX)
+    // 2行ずつ 256bit で処理（下位128bit = 偶数行、上位128bit = 奇数行）
+    const __m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(viewProjection.m[0]));
+    const __m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(viewProjection.m[1]));
+    const __m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(viewProjection.m[2]));
+    const __m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(viewProjection.m[3]));
+
+    for (size_t i = 0; i < count; ++i) {
+        Matrix4x4* o = reinterpret_cast<Matrix4x4*>(dst + i * outStride);
+        for (int row = 0; row < 4; row += 2) {
+            const __m256 a = _mm256_loadu_ps(worlds[i].m[row]);
+            __m256 r = _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0x00), b0);
+            r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0x55), b1));
+            r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0xAA), b2));
+            r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0xFF), b3));
+            _mm256_storeu_ps(o->m[row], r);
+        }
+    }
+#elif defined(MATH_USE_SSE)
+    const Rows4 b = LoadRows(viewProjection);
+    for (size_t i = 0; i < count; ++i) {
+        Matrix4x4* o = reinterpret_cast<Matrix4x4*>(dst + i * outStride);
+        _mm_storeu_ps(o->m[0], MulRow(worlds[i].m[0], b));
+        _mm_storeu_ps(o->m[1], MulRow(worlds[i].m[1], b));
+        _mm_storeu_ps(o->m[2], MulRow(worlds[i].m[2], b));
+        _mm_storeu_ps(o->m[3], MulRow(worlds[i].m[3], b));
+    }
+#else
+    for (size_t i = 0; i < count; ++i) {
+        *reinterpret_cast<Matrix4x4*>(dst + i * outStride) = Multiply(worlds[i], viewProjection);
+    }
+#endif
+}
 // ワールドマトリックス、メイクアフィン
+// S*Rx*Ry*Rz*T の積を展開した式で作る（3軸の sin/cos は SinCos4 で一度に求める）
+// Exact モードでは行列を掛け合わせていた頃と結果がビット一致する
 Matrix4x4 MatrixMath::MakeAffineMatrix(const Vector3& scale, const Vector3& rotate,
-    const Vector3& translate)
+    const Vector3& translate, SinCosMode mode)
 {
-    Matrix4x4 scaleMatrix = Matrix4x4MakeScaleMatrix(scale);
-    Matrix4x4 rotateX = MakeRotateXMatrix(rotate.x);
-    Matrix4x4 rotateY = MakeRotateYMatrix(rotate.y);
-    Matrix4x4 rotateZ = MakeRotateZMatrix(rotate.z);
-    Matrix4x4 rotateMatrix = Multiply(Multiply(rotateX, rotateY), rotateZ);
-    Matrix4x4 translateMatrix = MakeTranslateMatrix(translate);
-
-    Matrix4x4 worldMatrix = Multiply(Multiply(scaleMatrix, rotateMatrix), translateMatrix);
-    return worldMatrix;
+    return AffineMath::ToMatrix4x4(AffineMath::MakeAffine(scale, rotate, translate, mode));
 }
 // 4x4 行列の逆行列を計算する関数
 Matrix4x4 MatrixMath::Inverse(Matrix4x4 m)
 {
+#if defined(MATH_USE_SSE)
+    // 2x2 ブロック分割による逆行列
+    //   M = | A B |
+    //       | C D |
+    const Rows4 in = LoadRows(m);
+    const __m128 A = _mm_movelh_ps(in.r[0], in.r[1]);
+    const __m128 B = _mm_movehl_ps(in.r[1], in.r[0]);
+    const __m128 C = _mm_movelh_ps(in.r[2], in.r[3]);
+    const __m128 D = _mm_movehl_ps(in.r[3], in.r[2]);
+
+    // (|A| |B| |C| |D|)
+    const __m128 detSub = _mm_sub_ps(
+        _mm_mul_ps(MM_SHUFFLE(in.r[0], in.r[2], 0, 2, 0, 2), MM_SHUFFLE(in.r[1], in.r[3], 1, 3, 1, 3)),
+        _mm_mul_ps(MM_SHUFFLE(in.r[0], in.r[2], 1, 3, 1, 3), MM_SHUFFLE(in.r[1], in.r[3], 0, 2, 0, 2)));
+    const __m128 detA = MM_SWIZZLE(detSub, 0, 0, 0, 0);
+    const __m128 detB = MM_SWIZZLE(detSub, 1, 1, 1, 1);
+    const __m128 detC = MM_SWIZZLE(detSub, 2, 2, 2, 2);
+    const __m128 detD = MM_SWIZZLE(detSub, 3, 3, 3, 3);
+
+    const __m128 D_C = Mat2AdjMul(D, C);
+    const __m128 A_B = Mat2AdjMul(A, B);
+    __m128 X_ = _mm_sub_ps(_mm_mul_ps(detD, A), Mat2Mul(B, D_C));
+    __m128 W_ = _mm_sub_ps(_mm_mul_ps(detA, D), Mat2Mul(C, A_B));
+    __m128 Y_ = _mm_sub_ps(_mm_mul_ps(detB, C), Mat2MulAdj(D, A_B));
+    __m128 Z_ = _mm_sub_ps(_mm_mul_ps(detC, B), Mat2MulAdj(A, D_C));
+
+    // |M| = |A||D| + |B||C| - tr((A#B)(D#C))
+    __m128 detM = _mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC));
+    __m128 tr = _mm_mul_ps(A_B, MM_SWIZZLE(D_C, 0, 2, 1, 3));
+    tr = _mm_add_ps(tr, MM_SWIZZLE(tr, 2, 3, 0, 1));
+    tr = _mm_add_ps(tr, MM_SWIZZLE(tr, 1, 0, 3, 2));
+    detM = _mm_sub_ps(detM, tr);
+
+    if (_mm_cvtss_f32(detM) == 0.0f)
+        return Matrix4x4 {}; // スカラー版と同じく零行列
+
+    const __m128 rDetM = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), detM);
+    X_ = _mm_mul_ps(X_, rDetM);
+    Y_ = _mm_mul_ps(Y_, rDetM);
+    Z_ = _mm_mul_ps(Z_, rDetM);
+    W_ = _mm_mul_ps(W_, rDetM);
+
+    Rows4 out;
+    out.r[0] = MM_SHUFFLE(X_, Y_, 3, 1, 3, 1);
+    out.r[1] = MM_SHUFFLE(X_, Y_, 2, 0, 2, 0);
+    out.r[2] = MM_SHUFFLE(Z_, W_, 3, 1, 3, 1);
+    out.r[3] = MM_SHUFFLE(Z_, W_, 2, 0, 2, 0);
+
+    Matrix4x4 result;
+    StoreRows(out, result);
+    return result;
+#else
     Matrix4x4 result;
     float det;
     int i;
@@ -152,54 +280,7 @@ Matrix4x4 MatrixMath::Inverse(Matrix4x4 m)
             result.m[i][j] = result.m[i][j] * det;
 
     return result;
-}
-// 透視投影行列
-Matrix4x4 MatrixMath::MakePerspectiveFovMatrix(float fovY, float aspectRatio,
-    float nearClip, float farClip)
-{
-    Matrix4x4 result = {};
-
-    float f = 1.0f / std::tan(fovY / 2.0f);
-
-    result.m[0][0] = f / aspectRatio;
-    result.m[1][1] = f;
-    result.m[2][2] = farClip / (farClip - nearClip);
-    result.m[2][3] = 1.0f;
-    result.m[3][2] = -(nearClip * farClip) / (farClip - nearClip);
-    return result;
-}
-// 正射影行列
-Matrix4x4 MatrixMath::MakeOrthographicMatrix(float left, float top, float right,
-    float bottom, float nearClip, float farClip)
-{
-    Matrix4x4 m = {};
-
-    m.m[0][0] = 2.0f / (right - left);
-    m.m[1][1] = 2.0f / (top - bottom);
-    m.m[2][2] = 1.0f / (farClip - nearClip);
-    m.m[3][0] = -(right + left) / (right - left);
-    m.m[3][1] = -(top + bottom) / (top - bottom);
-    m.m[3][2] = -nearClip / (farClip - nearClip);
-    m.m[3][3] = 1.0f;
-
-    return m;
-}
-// ビューポート変換行列
-Matrix4x4 MatrixMath::MakeViewportMatrix(float left, float top, float width, float height,
-    float minDepth, float maxDepth)
-{
-    Matrix4x4 m = {};
-
-    // 行0：X方向スケーリングと移動
-    m.m[0][0] = width / 2.0f;
-    m.m[1][1] = -height / 2.0f;
-    m.m[2][2] = maxDepth - minDepth;
-    m.m[3][0] = left + width / 2.0f;
-    m.m[3][1] = top + height / 2.0f;
-    m.m[3][2] = minDepth;
-    m.m[3][3] = 1.0f;
-
-    return m;
+#endif
 }
 // 正規化関数
 Vector3 MatrixMath::Normalize(const Vector3& v)
@@ -209,43 +290,43 @@ Vector3 MatrixMath::Normalize(const Vector3& v)
         return { 0.0f, 0.0f, 0.0f };
     return { v.x / length, v.y / length, v.z / length };
 }
-Matrix4x4 MatrixMath::Transpose(const Matrix4x4& m)
+// 転置（実行時用）
+Matrix4x4 MatrixMath::TransposeRuntime_(const Matrix4x4& m)
 {
     Matrix4x4 result {};
 
+#if defined(MATH_USE_SSE)
+    Rows4 rows = LoadRows(m);
+    _MM_TRANSPOSE4_PS(rows.r[0], rows.r[1], rows.r[2], rows.r[3]);
+    StoreRows(rows, result);
+#else
     for (int i = 0; i < 4; ++i) {
         for (int j = 0; j < 4; ++j) {
             result.m[i][j] = m.m[j][i];
         }
     }
+#endif
 
     return result;
 }
 
-static float Dot3(const Vector3& a, const Vector3& b) {
-    return a.x * b.x + a.y * b.y + a.z * b.z;
-}
-static Vector3 Cross3(const Vector3& a, const Vector3& b) {
-    return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
-}
-
 Matrix4x4 MatrixMath::MakeLookAtMatrix(const Vector3& eye, const Vector3& target, const Vector3& up)
 {
     // LH想定：前方向 = target - eye
     Vector3 z = { target.x - eye.x, target.y - eye.y, target.z - eye.z };
     z = Normalize(z);
 
-    Vector3 x = Cross3(up, z);
+    Vector3 x = Cross(up, z);
     x = Normalize(x);
 
-    Vector3 y = Cross3(z, x);
+    Vector3 y = Cross(z, x);
 
     Matrix4x4 m = MakeIdentity4x4();
 
     // row-vector形式：平行移動は最下段
-    m.m[0][0] = x.x; m.m[1][0] = x.y; m.m[2][0] = x.z; m.m[3][0] = -Dot3(x, eye);
-    m.m[0][1] = y.x; m.m[1][1] = y.y; m.m[2][1] = y.z; m.m[3][1] = -Dot3(y, eye);
-    m.m[0][2] = z.x; m.m[1][2] = z.y; m.m[2][2] = z.z; m.m[3][2] = -Dot3(z, eye);
+    m.m[0][0] = x.x; m.m[1][0] = x.y; m.m[2][0] = x.z; m.m[3][0] = -Dot(x, eye);
+    m.m[0][1] = y.x; m.m[1][1] = y.y; m.m[2][1] = y.z; m.m[3][1] = -Dot(y, eye);
+    m.m[0][2] = z.x; m.m[1][2] = z.y; m.m[2][2] = z.z; m.m[3][2] = -Dot(z, eye);
 
     return m;
 }
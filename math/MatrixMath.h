@@ -1,24 +1,166 @@
 // MatrixMath.h
 #pragma once
 #include "MathStruct.h"
+#include "SinCos.h"
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
 
 class MatrixMath {
 
 public:
-    static Matrix4x4 MakeIdentity4x4();
-    static Matrix4x4 Matrix4x4MakeScaleMatrix(const Vector3& s);
-    static Matrix4x4 MakeRotateXMatrix(float radian);
-    static Matrix4x4 MakeRotateYMatrix(float radian);
-    static Matrix4x4 MakeRotateZMatrix(float radian);
-    static Matrix4x4 MakeTranslateMatrix(const Vector3& t);
-    static Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2);
-    static Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Vector3& rotate, const Vector3& translate);
+    // constexpr のものは定数式でも使える（静的なテーブル・固定の射影行列を事前計算する用）
+    static constexpr Matrix4x4 MakeIdentity4x4();
+    static constexpr Matrix4x4 Matrix4x4MakeScaleMatrix(const Vector3& s);
+    // 回転生成の sin/cos は mode で選ぶ（Fast は SinCos.h の誤差で良い描画専用の呼び出し向け）
+    static Matrix4x4 MakeRotateXMatrix(float radian, SinCosMode mode = SinCosMode::Exact);
+    static Matrix4x4 MakeRotateYMatrix(float radian, SinCosMode mode = SinCosMode::Exact);
+    static Matrix4x4 MakeRotateZMatrix(float radian, SinCosMode mode = SinCosMode::Exact);
+    static constexpr Matrix4x4 MakeTranslateMatrix(const Vector3& t);
+    static constexpr Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2);
+    // worlds[i] * viewProjection を count 個まとめて計算する
+    // outStride で出力先の間隔（バイト）を指定できる（GPU用構造体へ直接書き込む用）
+    static void MultiplyBatch(const Matrix4x4* worlds, const Matrix4x4& viewProjection, Matrix4x4* out, size_t count, size_t outStride = sizeof(Matrix4x4));
+    static Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Vector3& rotate, const Vector3& translate,
+        SinCosMode mode = SinCosMode::Exact);
     static Matrix4x4 Inverse(Matrix4x4 m);
-    static Matrix4x4 MakePerspectiveFovMatrix(float fovY, float aspectRatio, float nearClip, float farClip);
-    static Matrix4x4 MakeOrthographicMatrix(float left, float top, float right, float bottom, float nearClip, float farClip);
-    static Matrix4x4 MakeViewportMatrix(float left, float top, float width, float height, float minDepth, float maxDepth);
-    static Matrix4x4 Transpose(const Matrix4x4& m);
+    // 定数式で評価した場合の tan は級数展開なので std::tan と最下位ビットが違うことがある
+    static constexpr Matrix4x4 MakePerspectiveFovMatrix(float fovY, float aspectRatio, float nearClip, float farClip);
+    static constexpr Matrix4x4 MakeOrthographicMatrix(float left, float top, float right, float bottom, float nearClip, float farClip);
+    static constexpr Matrix4x4 MakeViewportMatrix(float left, float top, float width, float height, float minDepth, float maxDepth);
+    static constexpr Matrix4x4 Transpose(const Matrix4x4& m);
     static Vector3 Normalize(const Vector3& v);
     static Matrix4x4 MakeLookAtMatrix(const Vector3& eye, const Vector3& target, const Vector3& up);
 
+private:
+    // 実行時は SIMD 版（MatrixMath.cpp）を使う
+    static Matrix4x4 MultiplyRuntime_(const Matrix4x4& m1, const Matrix4x4& m2);
+    static Matrix4x4 TransposeRuntime_(const Matrix4x4& m);
+    static constexpr float ConstexprTan_(float x);
 };
+
+#pragma region constexpr 行列関数
+// 単位行列の作成
+constexpr Matrix4x4 MatrixMath::MakeIdentity4x4()
+{
+    Matrix4x4 result {};
+    for (int i = 0; i < 4; ++i)
+        result.m[i][i] = 1.0f;
+    return result;
+}
+// 拡大縮小行列S
+constexpr Matrix4x4 MatrixMath::Matrix4x4MakeScaleMatrix(const Vector3& s)
+{
+    Matrix4x4 result = {};
+    result.m[0][0] = s.x;
+    result.m[1][1] = s.y;
+    result.m[2][2] = s.z;
+    result.m[3][3] = 1.0f;
+    return result;
+}
+// 平行移動行列T
+constexpr Matrix4x4 MatrixMath::MakeTranslateMatrix(const Vector3& tlanslate)
+{
+    Matrix4x4 result = {};
+    result.m[0][0] = 1.0f;
+    result.m[1][1] = 1.0f;
+    result.m[2][2] = 1.0f;
+    result.m[3][3] = 1.0f;
+    result.m[3][0] = tlanslate.x;
+    result.m[3][1] = tlanslate.y;
+    result.m[3][2] = tlanslate.z;
+
+    return result;
+}
+// 行列の積
+// 定数式では SIMD 版と同じ k=0→3 の加算順で計算するので、どちらで評価しても結果は一致する
+constexpr Matrix4x4 MatrixMath::Multiply(const Matrix4x4& m1, const Matrix4x4& m2)
+{
+    if (!std::is_constant_evaluated()) {
+        return MultiplyRuntime_(m1, m2);
+    }
+    Matrix4x4 result {};
+    for (int i = 0; i < 4; ++i)
+        for (int j = 0; j < 4; ++j)
+            result.m[i][j] = m1.m[i][0] * m2.m[0][j] + m1.m[i][1] * m2.m[1][j] + m1.m[i][2] * m2.m[2][j] + m1.m[i][3] * m2.m[3][j];
+    return result;
+}
+// 透視投影行列
+constexpr Matrix4x4 MatrixMath::MakePerspectiveFovMatrix(float fovY, float aspectRatio,
+    float nearClip, float farClip)
+{
+    Matrix4x4 result = {};
+
+    const float t = std::is_constant_evaluated() ? ConstexprTan_(fovY / 2.0f) : std::tan(fovY / 2.0f);
+    float f = 1.0f / t;
+
+    result.m[0][0] = f / aspectRatio;
+    result.m[1][1] = f;
+    result.m[2][2] = farClip / (farClip - nearClip);
+    result.m[2][3] = 1.0f;
+    result.m[3][2] = -(nearClip * farClip) / (farClip - nearClip);
+    return result;
+}
+// 正射影行列
+constexpr Matrix4x4 MatrixMath::MakeOrthographicMatrix(float left, float top, float right,
+    float bottom, float nearClip, float farClip)
+{
+    Matrix4x4 m = {};
+
+    m.m[0][0] = 2.0f / (right - left);
+    m.m[1][1] = 2.0f / (top - bottom);
+    m.m[2][2] = 1.0f / (farClip - nearClip);
+    m.m[3][0] = -(right + left) / (right - left);
+    m.m[3][1] = -(top + bottom) / (top - bottom);
+    m.m[3][2] = -nearClip / (farClip - nearClip);
+    m.m[3][3] = 1.0f;
+
+    return m;
+}
+// ビューポート変換行列
+constexpr Matrix4x4 MatrixMath::MakeViewportMatrix(float left, float top, float width, float height,
+    float minDepth, float maxDepth)
+{
+    Matrix4x4 m = {};
+
+    // 行0：X方向スケーリングと移動
+    m.m[0][0] = width / 2.0f;
+    m.m[1][1] = -height / 2.0f;
+    m.m[2][2] = maxDepth - minDepth;
+    m.m[3][0] = left + width / 2.0f;
+    m.m[3][1] = top + height / 2.0f;
+    m.m[3][2] = minDepth;
+    m.m[3][3] = 1.0f;
+
+    return m;
+}
+// 転置
+constexpr Matrix4x4 MatrixMath::Transpose(const Matrix4x4& m)
+{
+    if (!std::is_constant_evaluated()) {
+        return TransposeRuntime_(m);
+    }
+    Matrix4x4 result {};
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            result.m[i][j] = m.m[j][i];
+        }
+    }
+    return result;
+}
+// 定数式用の tan（|x| < π/2 を想定、double の Taylor 展開で sin/cos を求めて割る）
+constexpr float MatrixMath::ConstexprTan_(float x)
+{
+    const double xd = x;
+    const double x2 = xd * xd;
+    double s = 0.0, c = 0.0;
+    double termS = xd, termC = 1.0;
+    for (int n = 0; n < 20; ++n) {
+        s += termS;
+        c += termC;
+        termS *= -x2 / ((2.0 * n + 2.0) * (2.0 * n + 3.0));
+        termC *= -x2 / ((2.0 * n + 1.0) * (2.0 * n + 2.0));
+    }
+    return static_cast<float>(s / c);
+}
+#pragma endregion
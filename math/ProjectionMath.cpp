@@ -0,0 +1,205 @@
+#include "ProjectionMath.h"
+#include "SimdConfig.h"
+#include <cmath>
+
+namespace {
+
+constexpr float kMinW = 1e-6f;
+
+// 4bit マスクの立っているビット数
+constexpr uint8_t kBitCount4[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+
+inline const Vector3& PointAt(const Vector3* base, size_t index, size_t stride)
+{
+    return *reinterpret_cast<const Vector3*>(reinterpret_cast<const uint8_t*>(base) + index * stride);
+}
+
+// スカラー版の 1 点投影（SIMD 版と同じ演算順）
+inline ScreenPoint ProjectOne(const Vector3& p, const Matrix4x4& m, float screenW, float screenH)
+{
+    ScreenPoint result {};
+    const float w = p.x * m.m[0][3] + p.y * m.m[1][3] + p.z * m.m[2][3] + m.m[3][3];
+    if (w <= kMinW) {
+        result.flags = ProjectionMath::kBehind;
+        return result;
+    }
+
+    const float ndcX = (p.x * m.m[0][0] + p.y * m.m[1][0] + p.z * m.m[2][0] + m.m[3][0]) / w;
+    const float ndcY = (p.x * m.m[0][1] + p.y * m.m[1][1] + p.z * m.m[2][1] + m.m[3][1]) / w;
+    const float ndcZ = (p.x * m.m[0][2] + p.y * m.m[1][2] + p.z * m.m[2][2] + m.m[3][2]) / w;
+
+    result.position.x = (ndcX * 0.5f + 0.5f) * screenW;
+    result.position.y = (-ndcY * 0.5f + 0.5f) * screenH;
+    result.depth = ndcZ;
+    if (ndcX < -1.0f || ndcX > 1.0f || ndcY < -1.0f || ndcY > 1.0f) {
+        result.flags |= ProjectionMath::kOutsideXY;
+    }
+    if (ndcZ < 0.0f || ndcZ > 1.0f) {
+        result.flags |= ProjectionMath::kOutsideDepth;
+    }
+    return result;
+}
+
+#if defined(MATH_USE_SSE)
+// 行列の 1 列分を 4 点まとめて計算（x*m0j + y*m1j + z*m2j + m3j）
+inline __m128 MulColumn(__m128 x, __m128 y, __m128 z, const Matrix4x4& m, int j)
+{
+    __m128 r = _mm_mul_ps(x, _mm_set1_ps(m.m[0][j]));
+    r = _mm_add_ps(r, _mm_mul_ps(y, _mm_set1_ps(m.m[1][j])));
+    r = _mm_add_ps(r, _mm_mul_ps(z, _mm_set1_ps(m.m[2][j])));
+    return _mm_add_ps(r, _mm_set1_ps(m.m[3][j]));
+}
+#endif
+
+} // namespace
+
+#pragma region 座標変換
+Vector3 ProjectionMath::TransformCoord(const Vector3& v, const Matrix4x4& m)
+{
+    Vector3 out;
+    out.x = v.x * m.m[0][0] + v.y * m.m[1][0] + v.z * m.m[2][0] + m.m[3][0];
+    out.y = v.x * m.m[0][1] + v.y * m.m[1][1] + v.z * m.m[2][1] + m.m[3][1];
+    out.z = v.x * m.m[0][2] + v.y * m.m[1][2] + v.z * m.m[2][2] + m.m[3][2];
+
+    const float w = v.x * m.m[0][3] + v.y * m.m[1][3] + v.z * m.m[2][3] + m.m[3][3];
+    if (std::abs(w) > kMinW) {
+        out.x /= w;
+        out.y /= w;
+        out.z /= w;
+    }
+    return out;
+}
+
+Vector3 ProjectionMath::TransformCoord(const Vector4& v, const Matrix4x4& m)
+{
+    Vector3 out;
+    out.x = v.x * m.m[0][0] + v.y * m.m[1][0] + v.z * m.m[2][0] + v.w * m.m[3][0];
+    out.y = v.x * m.m[0][1] + v.y * m.m[1][1] + v.z * m.m[2][1] + v.w * m.m[3][1];
+    out.z = v.x * m.m[0][2] + v.y * m.m[1][2] + v.z * m.m[2][2] + v.w * m.m[3][2];
+
+    const float w = v.x * m.m[0][3] + v.y * m.m[1][3] + v.z * m.m[2][3] + v.w * m.m[3][3];
+    if (std::abs(w) > kMinW) {
+        out.x /= w;
+        out.y /= w;
+        out.z /= w;
+    }
+    return out;
+}
+
+void ProjectionMath::TransformCoords(const Vector3* in, Vector3* out, size_t count, const Matrix4x4& m, size_t inStride)
+{
+    size_t i = 0;
+#if defined(MATH_USE_SSE)
+    const __m128 minW = _mm_set1_ps(kMinW);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    for (; i + 4 <= count; i += 4) {
+        const Vector3& p0 = PointAt(in, i + 0, inStride);
+        const Vector3& p1 = PointAt(in, i + 1, inStride);
+        const Vector3& p2 = PointAt(in, i + 2, inStride);
+        const Vector3& p3 = PointAt(in, i + 3, inStride);
+        const __m128 x = _mm_setr_ps(p0.x, p1.x, p2.x, p3.x);
+        const __m128 y = _mm_setr_ps(p0.y, p1.y, p2.y, p3.y);
+        const __m128 z = _mm_setr_ps(p0.z, p1.z, p2.z, p3.z);
+
+        __m128 cx = MulColumn(x, y, z, m, 0);
+        __m128 cy = MulColumn(x, y, z, m, 1);
+        __m128 cz = MulColumn(x, y, z, m, 2);
+        const __m128 w = MulColumn(x, y, z, m, 3);
+
+        // |w| が小さいレーンは 1 で割る（= 割らない）
+        const __m128 useW = _mm_cmpgt_ps(_mm_and_ps(w, absMask), minW);
+        const __m128 div = _mm_or_ps(_mm_and_ps(useW, w), _mm_andnot_ps(useW, _mm_set1_ps(1.0f)));
+        cx = _mm_div_ps(cx, div);
+        cy = _mm_div_ps(cy, div);
+        cz = _mm_div_ps(cz, div);
+
+        alignas(16) float ox[4], oy[4], oz[4];
+        _mm_store_ps(ox, cx);
+        _mm_store_ps(oy, cy);
+        _mm_store_ps(oz, cz);
+        for (int k = 0; k < 4; ++k) {
+            out[i + k] = { ox[k], oy[k], oz[k] };
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i] = TransformCoord(PointAt(in, i, inStride), m);
+    }
+}
+#pragma endregion
+
+#pragma region スクリーン投影
+size_t ProjectionMath::ProjectToScreen(const Vector3* worldPositions, ScreenPoint* out, size_t count,
+    const Matrix4x4& viewProjection, float screenW, float screenH, size_t inStride)
+{
+    static_assert(sizeof(ScreenPoint) == 16, "ScreenPoint は 4 float 分で書き出す");
+
+    const Matrix4x4& m = viewProjection;
+    size_t visible = 0;
+    size_t i = 0;
+
+#if defined(MATH_USE_SSE)
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 minusOne = _mm_set1_ps(-1.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 sw = _mm_set1_ps(screenW);
+    const __m128 sh = _mm_set1_ps(screenH);
+    const __m128 flagBehind = _mm_castsi128_ps(_mm_set1_epi32(kBehind));
+    const __m128 flagOutsideXY = _mm_castsi128_ps(_mm_set1_epi32(kOutsideXY));
+    const __m128 flagOutsideDepth = _mm_castsi128_ps(_mm_set1_epi32(kOutsideDepth));
+
+    for (; i + 4 <= count; i += 4) {
+        const Vector3& p0 = PointAt(worldPositions, i + 0, inStride);
+        const Vector3& p1 = PointAt(worldPositions, i + 1, inStride);
+        const Vector3& p2 = PointAt(worldPositions, i + 2, inStride);
+        const Vector3& p3 = PointAt(worldPositions, i + 3, inStride);
+        const __m128 x = _mm_setr_ps(p0.x, p1.x, p2.x, p3.x);
+        const __m128 y = _mm_setr_ps(p0.y, p1.y, p2.y, p3.y);
+        const __m128 z = _mm_setr_ps(p0.z, p1.z, p2.z, p3.z);
+
+        const __m128 w = MulColumn(x, y, z, m, 3);
+        const __m128 behind = _mm_cmple_ps(w, _mm_set1_ps(kMinW));
+
+        const __m128 ndcX = _mm_div_ps(MulColumn(x, y, z, m, 0), w);
+        const __m128 ndcY = _mm_div_ps(MulColumn(x, y, z, m, 1), w);
+        const __m128 ndcZ = _mm_div_ps(MulColumn(x, y, z, m, 2), w);
+
+        __m128 sx = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(ndcX, half), half), sw);
+        __m128 sy = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_xor_ps(ndcY, _mm_set1_ps(-0.0f)), half), half), sh);
+        __m128 depth = ndcZ;
+
+        const __m128 outXY = _mm_or_ps(
+            _mm_or_ps(_mm_cmplt_ps(ndcX, minusOne), _mm_cmpgt_ps(ndcX, one)),
+            _mm_or_ps(_mm_cmplt_ps(ndcY, minusOne), _mm_cmpgt_ps(ndcY, one)));
+        const __m128 outZ = _mm_or_ps(_mm_cmplt_ps(ndcZ, zero), _mm_cmpgt_ps(ndcZ, one));
+
+        // カメラ後ろのレーンは座標を 0、フラグを kBehind だけにする
+        sx = _mm_andnot_ps(behind, sx);
+        sy = _mm_andnot_ps(behind, sy);
+        depth = _mm_andnot_ps(behind, depth);
+        __m128 flags = _mm_and_ps(behind, flagBehind);
+        flags = _mm_or_ps(flags, _mm_andnot_ps(behind, _mm_and_ps(outXY, flagOutsideXY)));
+        flags = _mm_or_ps(flags, _mm_andnot_ps(behind, _mm_and_ps(outZ, flagOutsideDepth)));
+
+        // flags の値は float としては非正規化数なので、比較は整数で行う
+        const int visibleMask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_castps_si128(flags), _mm_setzero_si128())));
+        visible += kBitCount4[visibleMask];
+
+        // (x, y, depth, flags) を転置して ScreenPoint 4 個分として書き出す
+        _MM_TRANSPOSE4_PS(sx, sy, depth, flags);
+        _mm_storeu_ps(reinterpret_cast<float*>(&out[i + 0]), sx);
+        _mm_storeu_ps(reinterpret_cast<float*>(&out[i + 1]), sy);
+        _mm_storeu_ps(reinterpret_cast<float*>(&out[i + 2]), depth);
+        _mm_storeu_ps(reinterpret_cast<float*>(&out[i + 3]), flags);
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i] = ProjectOne(PointAt(worldPositions, i, inStride), m, screenW, screenH);
+        if (out[i].flags == 0) {
+            ++visible;
+        }
+    }
+    return visible;
+}
+#pragma endregion
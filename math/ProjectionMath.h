@@ -0,0 +1,38 @@
+#pragma once
+#include "MathStruct.h"
+#include <cstddef>
+#include <cstdint>
+
+// ===============================
+// 点の座標変換・ワールド→スクリーン投影（row-vector 運用）
+// ===============================
+
+// ProjectToScreen の 1 点分の結果（16byte）
+struct ScreenPoint {
+    Vector2 position; // 左上原点のピクセル座標
+    float depth; // NDC z（D3D なら 0..1 が描画範囲）
+    uint32_t flags; // ProjectionMath::kBehind など。0 なら画面内
+};
+
+class ProjectionMath {
+
+public:
+    enum : uint32_t {
+        kBehind = 1u << 0, // w <= 1e-6（カメラの後ろ）。position / depth は 0 になる
+        kOutsideXY = 1u << 1, // NDC x,y が [-1,1] の外
+        kOutsideDepth = 1u << 2, // NDC z が [0,1] の外
+    };
+
+    // v*m を w で割る（|w| が小さいときは割らない）
+    static Vector3 TransformCoord(const Vector3& v, const Matrix4x4& m);
+    static Vector3 TransformCoord(const Vector4& v, const Matrix4x4& m);
+
+    // in[i]*m を w 除算して out[i] へ（SIMD で 4 点ずつ）
+    // inStride は入力の間隔（バイト）。構造体の中の Vector3 をそのまま渡せる
+    static void TransformCoords(const Vector3* in, Vector3* out, size_t count, const Matrix4x4& m, size_t inStride = sizeof(Vector3));
+
+    // ワールド座標をスクリーン座標へまとめて投影する
+    // 戻り値は flags == 0（画面内）の点の数
+    static size_t ProjectToScreen(const Vector3* worldPositions, ScreenPoint* out, size_t count,
+        const Matrix4x4& viewProjection, float screenW, float screenH, size_t inStride = sizeof(Vector3));
+};
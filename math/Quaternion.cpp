@@ -0,0 +1,103 @@
+#include "Quaternion.h"
+#include "SinCos.h"
+#include <cmath>
+
+#pragma region クォータニオン関数
+Quaternion QuaternionMath::MakeIdentity()
+{
+    return { 0.0f, 0.0f, 0.0f, 1.0f };
+}
+
+Quaternion QuaternionMath::MakeRotateAxisAngle(const Vector3& axis, float angle)
+{
+    const Vector3 n = ::Normalize(axis);
+    const float s = std::sin(angle * 0.5f);
+    return { n.x * s, n.y * s, n.z * s, std::cos(angle * 0.5f) };
+}
+
+Quaternion QuaternionMath::Multiply(const Quaternion& a, const Quaternion& b)
+{
+    return {
+        a.w * b.x + b.w * a.x + (a.y * b.z - a.z * b.y),
+        a.w * b.y + b.w * a.y + (a.z * b.x - a.x * b.z),
+        a.w * b.z + b.w * a.z + (a.x * b.y - a.y * b.x),
+        a.w * b.w - (a.x * b.x + a.y * b.y + a.z * b.z)
+    };
+}
+
+Quaternion QuaternionMath::Normalize(const Quaternion& q)
+{
+    const float len = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+    if (len == 0.0f) {
+        return MakeIdentity();
+    }
+    const float inv = 1.0f / len;
+    return { q.x * inv, q.y * inv, q.z * inv, q.w * inv };
+}
+
+// q = qz * qy * qx を展開した式
+// 行列側の MakeRotateYMatrix / MakeRotateZMatrix は右手系の標準形と逆回りなので、
+// Y,Z の半角は符号を反転して使う
+Quaternion QuaternionMath::FromEulerXYZ(const Vector3& rotate, SinCosMode mode)
+{
+    float s[4], c[4];
+    SinCosMath::SinCos3(rotate.x * 0.5f, rotate.y * 0.5f, rotate.z * 0.5f, s, c, mode);
+    const float cx = c[0], sx = s[0];
+    const float cy = c[1], sy = -s[1];
+    const float cz = c[2], sz = -s[2];
+
+    return {
+        cz * cy * sx - sz * cx * sy,
+        cz * cx * sy + sz * cy * sx,
+        sz * cx * cy - cz * sx * sy,
+        cz * cx * cy + sz * sx * sy
+    };
+}
+
+void QuaternionMath::ToBasis(const Quaternion& q, Vector3& outX, Vector3& outY, Vector3& outZ)
+{
+    const float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+    const float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    const float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+    outX = { 1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy) };
+    outY = { 2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx) };
+    outZ = { 2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy) };
+}
+
+// row-vector 用の回転行列（各行がローカル軸）
+Matrix4x4 QuaternionMath::MakeRotateMatrix(const Quaternion& q)
+{
+    Vector3 x, y, z;
+    ToBasis(q, x, y, z);
+
+    Matrix4x4 result {};
+    result.m[0][0] = x.x; result.m[0][1] = x.y; result.m[0][2] = x.z;
+    result.m[1][0] = y.x; result.m[1][1] = y.y; result.m[1][2] = y.z;
+    result.m[2][0] = z.x; result.m[2][1] = z.y; result.m[2][2] = z.z;
+    result.m[3][3] = 1.0f;
+    return result;
+}
+
+// v' = q v q*（t = 2 q.xyz × v, v' = v + w t + q.xyz × t）
+Vector3 QuaternionMath::RotateVector(const Vector3& v, const Quaternion& q)
+{
+    const Vector3 t {
+        2.0f * (q.y * v.z - q.z * v.y),
+        2.0f * (q.z * v.x - q.x * v.z),
+        2.0f * (q.x * v.y - q.y * v.x)
+    };
+    return {
+        v.x + q.w * t.x + (q.y * t.z - q.z * t.y),
+        v.y + q.w * t.y + (q.z * t.x - q.x * t.z),
+        v.z + q.w * t.z + (q.x * t.y - q.y * t.x)
+    };
+}
+#pragma endregion
+
+void CachedOrientation::Rebuild(const Vector3& rotate)
+{
+    euler_ = rotate;
+    rotation = QuaternionMath::FromEulerXYZ(rotate);
+    QuaternionMath::ToBasis(rotation, axis[0], axis[1], axis[2]);
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "MathStruct.h"
+#include "SinCos.h"
+#include <limits>
+
+// ===============================
+// クォータニオン（x,y,z = 虚部, w = 実部）
+// ===============================
+struct Quaternion {
+    float x, y, z, w;
+};
+
+class QuaternionMath {
+
+public:
+    static Quaternion MakeIdentity();
+    static Quaternion MakeRotateAxisAngle(const Vector3& axis, float angle);
+    // a*b（b を先に適用してから a）
+    static Quaternion Multiply(const Quaternion& a, const Quaternion& b);
+    static Quaternion Normalize(const Quaternion& q);
+
+    // MatrixMath::MakeAffineMatrix の Rx*Ry*Rz と同じ向きになる Euler 変換
+    // （X→Y→Z の順に適用。Y,Z は行列側の符号に合わせて逆回り）
+    static Quaternion FromEulerXYZ(const Vector3& rotate, SinCosMode mode = SinCosMode::Exact);
+
+    // 回転後のローカル軸（行列で言う 0,1,2 行目）
+    static void ToBasis(const Quaternion& q, Vector3& outX, Vector3& outY, Vector3& outZ);
+    static Matrix4x4 MakeRotateMatrix(const Quaternion& q);
+    static Vector3 RotateVector(const Vector3& v, const Quaternion& q);
+};
+
+// ===============================
+// Euler 角が変わったときだけ再計算する向きキャッシュ
+// ===============================
+// 壁・ゲート・Object3d のように「編集は稀、参照は毎フレーム」の向きに使う
+struct CachedOrientation {
+    Quaternion rotation { 0.0f, 0.0f, 0.0f, 1.0f };
+    Vector3 axis[3] = { { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } };
+
+    // 値が同じなら何もしない（初回は NaN なので必ず計算される）
+    void Sync(const Vector3& rotate)
+    {
+        if (rotate.x == euler_.x && rotate.y == euler_.y && rotate.z == euler_.z) {
+            return;
+        }
+        Rebuild(rotate);
+    }
+
+private:
+    void Rebuild(const Vector3& rotate);
+
+    Vector3 euler_ {
+        std::numeric_limits<float>::quiet_NaN(),
+        std::numeric_limits<float>::quiet_NaN(),
+        std::numeric_limits<float>::quiet_NaN()
+    };
+};
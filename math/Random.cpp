@@ -0,0 +1,173 @@
+#include "Random.h"
+#include "SimdConfig.h"
+#include "SinCos.h"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+#pragma region 内部関数
+namespace {
+
+// 2^-24（上位 24bit を [0,1) の float にする）
+constexpr float kInv24 = 1.0f / 16777216.0f;
+
+// 32bit の全単射ミキサ（lowbias32）
+inline uint32_t Mix32(uint32_t x)
+{
+    x ^= x >> 16;
+    x *= 0x7feb352dU;
+    x ^= x >> 15;
+    x *= 0x846ca68bU;
+    x ^= x >> 16;
+    return x;
+}
+
+inline float ToUnitFloat(uint32_t x)
+{
+    return static_cast<float>(x >> 8) * kInv24;
+}
+
+// seed → 64bit 鍵（splitmix64）
+inline uint64_t SplitMix64(uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+#if defined(MATH_USE_SSE)
+// 32bit 整数の下位乗算（SSE2 には mullo_epi32 が無いので 2 回の 32x32→64 で組む）
+inline __m128i MulLo32(__m128i a, __m128i b)
+{
+#if defined(MATH_USE_AVX)
+    return _mm_mullo_epi32(a, b);
+#else
+    const __m128i even = _mm_mul_epu32(a, b);
+    const __m128i odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+    return _mm_unpacklo_epi32(
+        _mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+        _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+#endif
+}
+
+inline __m128i Mix32x4(__m128i x)
+{
+    x = _mm_xor_si128(x, _mm_srli_epi32(x, 16));
+    x = MulLo32(x, _mm_set1_epi32(0x7feb352d));
+    x = _mm_xor_si128(x, _mm_srli_epi32(x, 15));
+    x = MulLo32(x, _mm_set1_epi32(static_cast<int>(0x846ca68bU)));
+    x = _mm_xor_si128(x, _mm_srli_epi32(x, 16));
+    return x;
+}
+
+// counter, counter+1, counter+2, counter+3 の 4 本
+inline __m128i Hash4(uint32_t key0, uint32_t key1, uint32_t counter)
+{
+    __m128i c = _mm_add_epi32(_mm_set1_epi32(static_cast<int>(counter)), _mm_setr_epi32(0, 1, 2, 3));
+    c = Mix32x4(_mm_xor_si128(c, _mm_set1_epi32(static_cast<int>(key0))));
+    c = _mm_add_epi32(c, _mm_set1_epi32(static_cast<int>(key1)));
+    return Mix32x4(c);
+}
+#endif
+
+} // namespace
+#pragma endregion
+
+#pragma region 乱数
+uint32_t Random::Hash(uint32_t key0, uint32_t key1, uint32_t counter)
+{
+    return Mix32(Mix32(counter ^ key0) + key1);
+}
+
+void Random::Seed(uint64_t seed)
+{
+    seed_ = seed;
+    const uint64_t key = SplitMix64(seed);
+    key0_ = static_cast<uint32_t>(key);
+    key1_ = static_cast<uint32_t>(key >> 32);
+    counter_ = 0;
+}
+
+uint32_t Random::NextUInt()
+{
+    return Hash(key0_, key1_, counter_++);
+}
+
+float Random::NextFloat()
+{
+    return ToUnitFloat(NextUInt());
+}
+
+float Random::NextFloat(float min, float max)
+{
+    return min + NextFloat() * (max - min);
+}
+
+// z を [-1,1) で一様、方位角を [0,2π) で一様に取ると球面上で一様になる
+Vector3 Random::NextUnitVector()
+{
+    const float z = NextFloat(-1.0f, 1.0f);
+    const float phi = NextFloat(0.0f, 2.0f * std::numbers::pi_v<float>);
+
+    float s, c;
+    SinCosMath::SinCos(phi, s, c, SinCosMode::Fast);
+    const float r = std::sqrt((std::max)(0.0f, 1.0f - z * z));
+    return { r * c, r * s, z };
+}
+
+void Random::FillUniform(float* out, size_t count, float min, float max)
+{
+    const float range = max - min;
+    size_t i = 0;
+
+#if defined(MATH_USE_SSE)
+    const __m128 vMin = _mm_set1_ps(min);
+    const __m128 vRange = _mm_set1_ps(range);
+    const __m128 vInv24 = _mm_set1_ps(kInv24);
+    for (; i + 4 <= count; i += 4) {
+        const __m128i h = Hash4(key0_, key1_, counter_);
+        counter_ += 4;
+        // 上位 24bit は符号なしでも int32 の正の範囲に収まるので cvtepi32 で正確に変換できる
+        const __m128 u = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(h, 8)), vInv24);
+        _mm_storeu_ps(out + i, _mm_add_ps(vMin, _mm_mul_ps(u, vRange)));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        out[i] = min + ToUnitFloat(Hash(key0_, key1_, counter_++)) * range;
+    }
+}
+
+void Random::FillUnitVectors(Vector3* out, size_t count)
+{
+    // スタック上のブロックで処理してヒープを使わない
+    constexpr size_t kBlock = 64;
+    float uv[kBlock * 2];
+    float z[kBlock];
+    float phi[kBlock];
+    float s[kBlock];
+    float c[kBlock];
+
+    constexpr float kTwoPi = 2.0f * std::numbers::pi_v<float>;
+
+    for (size_t base = 0; base < count; base += kBlock) {
+        const size_t n = (std::min)(kBlock, count - base);
+
+        // NextUnitVector と同じ消費順（1本につき z, φ の順に 2 個）
+        FillUniform(uv, n * 2, 0.0f, 1.0f);
+        for (size_t k = 0; k < n; ++k) {
+            // NextFloat(min, max) と同じ式で区間を変換する
+            z[k] = -1.0f + uv[k * 2 + 0] * 2.0f;
+            phi[k] = 0.0f + uv[k * 2 + 1] * kTwoPi;
+        }
+
+        SinCosMath::SinCosArray(phi, s, c, n, SinCosMode::Fast);
+
+        for (size_t k = 0; k < n; ++k) {
+            const float r = std::sqrt((std::max)(0.0f, 1.0f - z[k] * z[k]));
+            out[base + k] = { r * c[k], r * s[k], z[k] };
+        }
+    }
+}
+#pragma endregion
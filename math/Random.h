@@ -0,0 +1,47 @@
+#pragma once
+#include "MathStruct.h"
+#include <cstddef>
+#include <cstdint>
+
+// ===============================
+// カウンタ方式の乱数
+// ===============================
+// n 番目の値 = Hash(seed から作った鍵, n)
+// 前の値に依存しないので、4 本まとめて（SSE）でもスカラーでも同じ列になる
+// 同じ seed・同じ呼び出し順なら環境によらず同じ結果（リプレイ・テスト用）
+// 周期は seed ごとに 2^32
+class Random {
+
+public:
+    explicit Random(uint64_t seed = 0) { Seed(seed); }
+
+    // 鍵を作り直してカウンタを 0 に戻す
+    void Seed(uint64_t seed);
+    uint64_t GetSeed() const { return seed_; }
+
+    // 何個消費したか（SetCounter と組み合わせて途中から再現できる）
+    uint32_t GetCounter() const { return counter_; }
+    void SetCounter(uint32_t counter) { counter_ = counter; }
+
+    uint32_t NextUInt();
+    // [0, 1)
+    float NextFloat();
+    // [min, max)
+    float NextFloat(float min, float max);
+    // 球面上に一様な単位ベクトル
+    Vector3 NextUnitVector();
+
+    // out[0..count) を [min, max) の一様乱数で埋める（NextFloat を count 回呼んだのと同じ値）
+    void FillUniform(float* out, size_t count, float min, float max);
+    // out[0..count) を単位ベクトルで埋める（NextUnitVector を count 回呼んだのと同じ値）
+    void FillUnitVectors(Vector3* out, size_t count);
+
+    // 鍵とカウンタから 32bit 値を作る（状態を持たない版）
+    static uint32_t Hash(uint32_t key0, uint32_t key1, uint32_t counter);
+
+private:
+    uint64_t seed_ = 0;
+    uint32_t key0_ = 0;
+    uint32_t key1_ = 0;
+    uint32_t counter_ = 0;
+};
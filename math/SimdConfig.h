@@ -0,0 +1,17 @@
+#pragma once
+// ===============================
+// SIMD 利用可否の判定
+// ===============================
+// MATH_NO_SIMD を定義するとスカラー実装に固定される（比較・デバッグ用）
+#if !defined(MATH_NO_SIMD)
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MATH_USE_SSE 1
+#endif
+#if defined(MATH_USE_SSE) && defined(__AVX__)
+#define MATH_USE_AVX 1
+#endif
+#endif
+
+#if defined(MATH_USE_SSE)
+#include <immintrin.h>
+#endif
@@ -0,0 +1,209 @@
+#include "SinCos.h"
+#include "SimdConfig.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#pragma region 多項式近似
+namespace {
+
+// π/2 を 3 分割した Cody-Waite 定数（上位ほど仮数の下位ビットが 0 なので j*DP1 が丸められない）
+constexpr float kTwoOverPi = 0.636619772367581343f;
+constexpr float kDP1 = 1.5703125f;
+constexpr float kDP2 = 4.837512969970703125e-4f;
+constexpr float kDP3 = 7.54978995489188216e-8f;
+
+// [-π/4, π/4] での minimax 係数
+constexpr float kS1 = -1.6666654611e-1f;
+constexpr float kS2 = 8.3321608736e-3f;
+constexpr float kS3 = -1.9515295891e-4f;
+constexpr float kC1 = 4.166664568298827e-2f;
+constexpr float kC2 = -1.388731625493765e-3f;
+constexpr float kC3 = 2.443315711809948e-5f;
+
+// SIMD 版と同じ手順のスカラー版（端数処理・SIMD 非対応環境用）
+inline void SinCosFast1(float x, float& outSin, float& outCos)
+{
+    const float j = std::nearbyint(x * kTwoOverPi);
+    const float r = ((x - j * kDP1) - j * kDP2) - j * kDP3;
+    const float r2 = r * r;
+
+    const float ps = r + r * r2 * (kS1 + r2 * (kS2 + r2 * kS3));
+    const float pc = (1.0f - 0.5f * r2) + r2 * r2 * (kC1 + r2 * (kC2 + r2 * kC3));
+
+    // 象限 q = j mod 4
+    const int q = static_cast<int>(static_cast<int64_t>(j) & 3);
+    const float s = (q & 1) ? pc : ps;
+    const float c = (q & 1) ? ps : pc;
+    outSin = (q & 2) ? -s : s;
+    outCos = ((q + 1) & 2) ? -c : c;
+}
+
+#if defined(MATH_USE_SSE)
+inline void SinCosFast4(__m128 x, __m128& outSin, __m128& outCos)
+{
+    const __m128i ji = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(kTwoOverPi)));
+    const __m128 j = _mm_cvtepi32_ps(ji);
+
+    __m128 r = _mm_sub_ps(x, _mm_mul_ps(j, _mm_set1_ps(kDP1)));
+    r = _mm_sub_ps(r, _mm_mul_ps(j, _mm_set1_ps(kDP2)));
+    r = _mm_sub_ps(r, _mm_mul_ps(j, _mm_set1_ps(kDP3)));
+    const __m128 r2 = _mm_mul_ps(r, r);
+
+    __m128 ps = _mm_add_ps(_mm_set1_ps(kS2), _mm_mul_ps(r2, _mm_set1_ps(kS3)));
+    ps = _mm_add_ps(_mm_set1_ps(kS1), _mm_mul_ps(r2, ps));
+    ps = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, r2), ps));
+
+    __m128 pc = _mm_add_ps(_mm_set1_ps(kC2), _mm_mul_ps(r2, _mm_set1_ps(kC3)));
+    pc = _mm_add_ps(_mm_set1_ps(kC1), _mm_mul_ps(r2, pc));
+    pc = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(_mm_set1_ps(0.5f), r2)), _mm_mul_ps(_mm_mul_ps(r2, r2), pc));
+
+    // 奇数象限は sin/cos を入れ替え、bit1 で符号反転
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i two = _mm_set1_epi32(2);
+    const __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(ji, one), one));
+    const __m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(ji, two), 30));
+    const __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(ji, one), two), 30));
+
+    const __m128 s = _mm_or_ps(_mm_and_ps(swap, pc), _mm_andnot_ps(swap, ps));
+    const __m128 c = _mm_or_ps(_mm_and_ps(swap, ps), _mm_andnot_ps(swap, pc));
+    outSin = _mm_xor_ps(s, sinSign);
+    outCos = _mm_xor_ps(c, cosSign);
+}
+#endif
+
+#if defined(MATH_USE_AVX)
+// AVX(1) には 256bit の整数演算が無いので、象限判定も float で行う
+inline void SinCosFast8(__m256 x, __m256& outSin, __m256& outCos)
+{
+    const __m256 j = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(kTwoOverPi)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+
+    __m256 r = _mm256_sub_ps(x, _mm256_mul_ps(j, _mm256_set1_ps(kDP1)));
+    r = _mm256_sub_ps(r, _mm256_mul_ps(j, _mm256_set1_ps(kDP2)));
+    r = _mm256_sub_ps(r, _mm256_mul_ps(j, _mm256_set1_ps(kDP3)));
+    const __m256 r2 = _mm256_mul_ps(r, r);
+
+    __m256 ps = _mm256_add_ps(_mm256_set1_ps(kS2), _mm256_mul_ps(r2, _mm256_set1_ps(kS3)));
+    ps = _mm256_add_ps(_mm256_set1_ps(kS1), _mm256_mul_ps(r2, ps));
+    ps = _mm256_add_ps(r, _mm256_mul_ps(_mm256_mul_ps(r, r2), ps));
+
+    __m256 pc = _mm256_add_ps(_mm256_set1_ps(kC2), _mm256_mul_ps(r2, _mm256_set1_ps(kC3)));
+    pc = _mm256_add_ps(_mm256_set1_ps(kC1), _mm256_mul_ps(r2, pc));
+    pc = _mm256_add_ps(_mm256_sub_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(_mm256_set1_ps(0.5f), r2)), _mm256_mul_ps(_mm256_mul_ps(r2, r2), pc));
+
+    // q = j mod 4（0,1,2,3 の float）
+    const __m256 q = _mm256_sub_ps(j, _mm256_mul_ps(_mm256_set1_ps(4.0f), _mm256_floor_ps(_mm256_mul_ps(j, _mm256_set1_ps(0.25f)))));
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 two = _mm256_set1_ps(2.0f);
+    const __m256 signBit = _mm256_set1_ps(-0.0f);
+
+    const __m256 isQ1 = _mm256_cmp_ps(q, one, _CMP_EQ_OQ);
+    const __m256 isQ2 = _mm256_cmp_ps(q, two, _CMP_EQ_OQ);
+    const __m256 isQ3 = _mm256_cmp_ps(q, _mm256_set1_ps(3.0f), _CMP_EQ_OQ);
+    const __m256 swap = _mm256_or_ps(isQ1, isQ3);
+    const __m256 sinSign = _mm256_and_ps(_mm256_cmp_ps(q, two, _CMP_GE_OQ), signBit);
+    const __m256 cosSign = _mm256_and_ps(_mm256_or_ps(isQ1, isQ2), signBit);
+
+    outSin = _mm256_xor_ps(_mm256_blendv_ps(ps, pc, swap), sinSign);
+    outCos = _mm256_xor_ps(_mm256_blendv_ps(pc, ps, swap), cosSign);
+}
+#endif
+
+} // namespace
+#pragma endregion
+
+#pragma region sin/cos関数
+void SinCosMath::SinCos(float angle, float& outSin, float& outCos, SinCosMode mode)
+{
+    if (mode == SinCosMode::Exact) {
+        outSin = std::sin(angle);
+        outCos = std::cos(angle);
+        return;
+    }
+    SinCosFast1(angle, outSin, outCos);
+}
+
+void SinCosMath::SinCos3(float x, float y, float z, float (&outSin)[4], float (&outCos)[4], SinCosMode mode)
+{
+    if (mode == SinCosMode::Exact) {
+        outSin[0] = std::sin(x);
+        outCos[0] = std::cos(x);
+        outSin[1] = std::sin(y);
+        outCos[1] = std::cos(y);
+        outSin[2] = std::sin(z);
+        outCos[2] = std::cos(z);
+        outSin[3] = 0.0f;
+        outCos[3] = 1.0f;
+        return;
+    }
+#if defined(MATH_USE_SSE)
+    __m128 s, c;
+    SinCosFast4(_mm_set_ps(0.0f, z, y, x), s, c);
+    _mm_storeu_ps(outSin, s);
+    _mm_storeu_ps(outCos, c);
+#else
+    SinCosFast1(x, outSin[0], outCos[0]);
+    SinCosFast1(y, outSin[1], outCos[1]);
+    SinCosFast1(z, outSin[2], outCos[2]);
+    outSin[3] = 0.0f;
+    outCos[3] = 1.0f;
+#endif
+}
+
+void SinCosMath::SinCos4(const float* angles, float* outSin, float* outCos, SinCosMode mode)
+{
+    if (mode == SinCosMode::Exact) {
+        float a[4];
+        std::memcpy(a, angles, sizeof(a));
+        for (int i = 0; i < 4; ++i) {
+            outSin[i] = std::sin(a[i]);
+            outCos[i] = std::cos(a[i]);
+        }
+        return;
+    }
+#if defined(MATH_USE_SSE)
+    __m128 s, c;
+    SinCosFast4(_mm_loadu_ps(angles), s, c);
+    _mm_storeu_ps(outSin, s);
+    _mm_storeu_ps(outCos, c);
+#else
+    float a[4];
+    std::memcpy(a, angles, sizeof(a));
+    for (int i = 0; i < 4; ++i) {
+        SinCosFast1(a[i], outSin[i], outCos[i]);
+    }
+#endif
+}
+
+void SinCosMath::SinCos8(const float* angles, float* outSin, float* outCos, SinCosMode mode)
+{
+#if defined(MATH_USE_AVX)
+    if (mode == SinCosMode::Fast) {
+        __m256 s, c;
+        SinCosFast8(_mm256_loadu_ps(angles), s, c);
+        _mm256_storeu_ps(outSin, s);
+        _mm256_storeu_ps(outCos, c);
+        return;
+    }
+#endif
+    // 出力が angles と重なっていても良いように先に両方読んでおく
+    float a[8];
+    std::memcpy(a, angles, sizeof(a));
+    SinCos4(a, outSin, outCos, mode);
+    SinCos4(a + 4, outSin + 4, outCos + 4, mode);
+}
+
+void SinCosMath::SinCosArray(const float* angles, float* outSin, float* outCos, size_t count, SinCosMode mode)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        SinCos8(angles + i, outSin + i, outCos + i, mode);
+    }
+    for (; i + 4 <= count; i += 4) {
+        SinCos4(angles + i, outSin + i, outCos + i, mode);
+    }
+    for (; i < count; ++i) {
+        SinCos(angles[i], outSin[i], outCos[i], mode);
+    }
+}
+#pragma endregion
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+
+// ===============================
+// sin/cos をまとめて求める
+// ===============================
+// Exact : 各要素に std::sin / std::cos（従来と結果がビット一致）
+// Fast  : π/2 で範囲縮約 + 多項式（SSE 4本 / AVX 8本同時）
+//         |x| <= 8192 rad で最大誤差 2 ulp（実測 1.55 ulp、0 付近の値も絶対誤差 1e-7 以下）
+//         それより大きい角度は縮約誤差で精度が落ちる（65536 rad で絶対誤差 1e-6 程度）
+enum class SinCosMode {
+    Exact,
+    Fast,
+};
+
+// モードは呼び出し側が決める（回転生成の MatrixMath / AffineMath / QuaternionMath も引数で受け取る。省略時は Exact）
+class SinCosMath {
+
+public:
+    static void SinCos(float angle, float& outSin, float& outCos, SinCosMode mode = SinCosMode::Exact);
+    // Euler 角の 3 軸を 1 回で計算（[3] は角度 0 として sin=0, cos=1）
+    // 角度をレジスタのまま詰めるので、配列に書いて SinCos4 で読み直すよりストアフォワーディングの待ちが無い
+    static void SinCos3(float x, float y, float z, float (&outSin)[4], float (&outCos)[4], SinCosMode mode = SinCosMode::Exact);
+    // angles[0..3] / angles[0..7] をまとめて計算（出力は angles と重なってもよい）
+    static void SinCos4(const float* angles, float* outSin, float* outCos, SinCosMode mode = SinCosMode::Exact);
+    static void SinCos8(const float* angles, float* outSin, float* outCos, SinCosMode mode = SinCosMode::Exact);
+    // 任意個数（8本ずつ → 4本ずつ → 残りはスカラー）
+    static void SinCosArray(const float* angles, float* outSin, float* outCos, size_t count, SinCosMode mode = SinCosMode::Exact);
+};
@@ -0,0 +1,56 @@
+#include "object3d.hlsli"
+#include "MeshParticle.hlsli"
+ConstantBuffer<Material> gMaterial : register(b0);
+ConstantBuffer<DirectionalLight> gDirectionalLight : register(b1);
+ConstantBuffer<Camera> gCamera : register(b2);
+ConstantBuffer<PointLight> gPointLight : register(b3);
+Texture2D<float32_t4> gTexture : register(t0);
+SamplerState gSampler : register(s0);
+
+struct PixelShaderOutput
+{
+    float32_t4 color : SV_Target0;
+};
+
+// CeBO Object3d.PS Ɠi}eAFɃCX^XF|邾Ⴄj
+PixelShaderOutput main(MeshParticleVertexShaderOutput input)
+{
+    PixelShaderOutput output;
+
+    float32_t4 baseColor = gMaterial.color * input.color;
+    float4 transformedUV = mul(float32_t4(input.texcoord, 0.0f, 1.0f), gMaterial.uvTransform);
+    float32_t4 textureColor = gTexture.Sample(gSampler, transformedUV.xy);
+
+    if (gMaterial.enableLighting != 0)
+    {
+        float32_t distance = length(gPointLight.position - input.worldPosition);
+        float32_t factor = pow(saturate(-distance / gPointLight.radius + 1.0), gPointLight.decay);
+
+        float3 N = normalize(input.normal);
+        float3 L = normalize(-gDirectionalLight.direction);
+        float3 PL = normalize(input.worldPosition - gPointLight.position);
+        float3 V = normalize(gCamera.worldPosition - input.worldPosition);
+        float3 pointColor = gPointLight.color.rgb * gPointLight.intensity * factor;
+
+        // gU
+        float NdotL = saturate(dot(N, L));
+        float NdotPL = saturate(dot(N, PL));
+        float3 diffuse = baseColor.rgb * textureColor.rgb * gDirectionalLight.color.rgb * NdotL * gDirectionalLight.intensity;
+        float3 pointDiffuse = baseColor.rgb * textureColor.rgb * pointColor * NdotPL * factor;
+
+        // ʔˁiBlinn-Phongj
+        float3 H = normalize(L + V);
+        float3 PH = normalize(PL + V);
+        float3 specular = gDirectionalLight.color.rgb * gDirectionalLight.intensity * pow(saturate(dot(N, H)), gMaterial.shininess);
+        float3 pointSpecular = pointColor * pow(saturate(dot(N, PH)), gMaterial.shininess) * factor;
+
+        output.color.rgb = diffuse + specular + pointDiffuse + pointSpecular;
+        output.color.a = baseColor.a * textureColor.a;
+    }
+    else
+    {
+        output.color = baseColor * textureColor;
+    }
+
+    return output;
+}
@@ -0,0 +1,28 @@
+#include "MeshParticle.hlsli"
+
+StructuredBuffer<MeshParticleInstance> gInstances : register(t1);
+ConstantBuffer<MeshParticleTransform> gTransform : register(b0);
+
+struct VertexShaderInput
+{
+    float32_t4 position : POSITION0;
+    float32_t2 texcoord : TEXCOORD0;
+    float32_t3 normal : NORMAL0;
+};
+
+MeshParticleVertexShaderOutput main(VertexShaderInput input, uint32_t instanceId : SV_InstanceID)
+{
+    MeshParticleInstance instance = gInstances[instanceId];
+
+    // ]ȂE{XP[Ȃ̂ŁA[hs炸ڂ炷
+    float32_t3 local = mul(input.position, gTransform.local).xyz;
+    float32_t3 world = local * instance.scale + instance.position;
+
+    MeshParticleVertexShaderOutput output;
+    output.position = mul(float32_t4(world, 1.0f), gTransform.viewProjection);
+    output.texcoord = input.texcoord;
+    output.normal = normalize(mul(input.normal, (float32_t3x3) gTransform.local));
+    output.worldPosition = world;
+    output.color = instance.color;
+    return output;
+}
@@ -0,0 +1,22 @@
+// fgp[eBNiMeshParticleManagerj
+struct MeshParticleInstance
+{
+    float32_t3 position;
+    float32_t scale;
+    float32_t4 color;
+};
+
+struct MeshParticleTransform
+{
+    float32_t4x4 viewProjection;
+    float32_t4x4 local; // f̃[gm[hs
+};
+
+struct MeshParticleVertexShaderOutput
+{
+    float32_t4 position : SV_POSITION;
+    float32_t2 texcoord : TEXCOORD0;
+    float32_t3 normal : NORMAL0;
+    float32_t3 worldPosition : POSITION0;
+    float32_t4 color : COLOR0;
+};
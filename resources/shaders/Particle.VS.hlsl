@@ -1,14 +1,30 @@
 #include "Particle.hlsli"
 StructuredBuffer<ParticleForGPU> gParticle : register(t0);
+ConstantBuffer<ParticleCamera> gCamera : register(b1);
+// R}Ƃ UV ͈́ixy = , zw = 傫j
+StructuredBuffer<float32_t4> gFrames : register(t2);
 
+float32_t4 UnpackColor(uint32_t c)
+{
+    return float32_t4(c & 0xff, (c >> 8) & 0xff, (c >> 16) & 0xff, c >> 24) / 255.0f;
+}
 
 VertexShaderOutput main(VertexShaderInput input, uint32_t instanceId : SV_InstanceID)
 {
+    ParticleForGPU particle = gParticle[instanceId];
+
+    // ̒_gE]ĂAJ̉EEɕׂir{[hj
+    float32_t2 local = input.position.xy * particle.scale;
+    float s, c;
+    sincos(particle.rotation, s, c);
+    float32_t2 rotated = float32_t2(local.x * c - local.y * s, local.x * s + local.y * c);
+    float32_t3 world = particle.position + gCamera.right * rotated.x + gCamera.up * rotated.y;
+
     VertexShaderOutput output;
-    output.position = mul(input.position, gParticle[instanceId].WVP);
-    output.texcoord = input.texcoord;
-    output.normal = normalize(mul(input.normal, (float32_t3x3) gParticle[instanceId].World));
-    output.color = gParticle[instanceId].color;
+    output.position = mul(float32_t4(world, 1.0f), gCamera.viewProjection);
+    float32_t4 frame = gFrames[particle.frame];
+    output.texcoord = frame.xy + input.texcoord * frame.zw;
+    output.normal = normalize(cross(gCamera.up, gCamera.right));
+    output.color = UnpackColor(particle.color);
     return output;
 }
-
@@ -36,10 +36,21 @@ struct DirectionalLight
     float32_t3 direction;
     float intensity;
 };
+// 1 CX^X 32 oCgiC++  ParticleManager::ParticleForGPU Ɠсj
 struct ParticleForGPU
 {
-    float32_t4x4 WVP;
-    float32_t4x4 World;
-    float32_t4 color;
-    
+    float32_t3 position;
+    float rotation; // ̖ʓ̉]iWAj
+    float32_t2 scale;
+    uint32_t color; // RGBA8iR ʃoCgj
+    uint32_t frame; // t[\igFramesj̓Y
+};
+// SCX^Xʁir{[h̎ VPj
+struct ParticleCamera
+{
+    float32_t4x4 viewProjection;
+    float32_t3 right;
+    float padding0;
+    float32_t3 up;
+    float padding1;
 };
@@ -0,0 +1,20 @@
+#include "Ribbon.hlsli"
+
+struct PixelShaderOutput
+{
+    float32_t4 color : SV_Target0;
+};
+
+// т̒SقǔZAɌďieNX`͎gȂj
+PixelShaderOutput main(RibbonVertexShaderOutput input)
+{
+    PixelShaderOutput output;
+    float32_t across = input.texcoord.y * 2.0f - 1.0f;
+    output.color = input.color;
+    output.color.a *= saturate(1.0f - across * across);
+    if (output.color.a <= 0.0f)
+    {
+        discard;
+    }
+    return output;
+}
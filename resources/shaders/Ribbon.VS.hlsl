@@ -0,0 +1,20 @@
+#include "Ribbon.hlsli"
+
+ConstantBuffer<RibbonTransform> gTransform : register(b0);
+
+struct VertexShaderInput
+{
+    float32_t3 position : POSITION0;
+    float32_t2 texcoord : TEXCOORD0;
+    float32_t4 color : COLOR0;
+};
+
+// _ CPU Ń[hW܂ōĂ̂ VP |邾
+RibbonVertexShaderOutput main(VertexShaderInput input)
+{
+    RibbonVertexShaderOutput output;
+    output.position = mul(float32_t4(input.position, 1.0f), gTransform.viewProjection);
+    output.texcoord = input.texcoord;
+    output.color = input.color;
+    return output;
+}
@@ -0,0 +1,12 @@
+// я̋OՁiRibbonTrailManagerj
+struct RibbonTransform
+{
+    float32_t4x4 viewProjection;
+};
+
+struct RibbonVertexShaderOutput
+{
+    float32_t4 position : SV_POSITION;
+    float32_t2 texcoord : TEXCOORD0; // x: V̊ y: т̍Ei0 / 1j
+    float32_t4 color : COLOR0;
+};